@@ -0,0 +1,107 @@
+// Coop.cpp – timer wheel + idle for the cooperative runtime
+#include "Coop.h"
+
+static CoopTimer* wheel[COOP_WHEEL_SLOTS];
+static uint32_t   wheelMs = 0;        // start of the next tick to process
+static bool       wheelStarted = false;
+static CoopTimer  pollTimer;
+static uint32_t   idleTotalMs = 0;
+
+static uint8_t slotOf(uint32_t ms) { return (ms / COOP_TICK_MS) % COOP_WHEEL_SLOTS; }
+
+static void unlink(CoopTimer& t) {
+  if(!t.armed) return;
+  CoopTimer** pp = &wheel[slotOf(t.dueMs)];
+  while(*pp && *pp != &t) pp = &(*pp)->next;
+  if(*pp) *pp = t.next;
+  t.armed = false;
+}
+
+static void insert(CoopTimer& t) {
+  // overdue timers go into the slot processed next
+  uint32_t at = ((int32_t)(t.dueMs - wheelMs) < 0) ? wheelMs : t.dueMs;
+  if(at != t.dueMs) t.dueMs = at;
+  uint8_t s = slotOf(t.dueMs);
+  t.next = wheel[s];
+  wheel[s] = &t;
+  t.armed = true;
+}
+
+static void advance(uint32_t now) {
+  if(!wheelStarted) { wheelMs = now - now % COOP_TICK_MS; wheelStarted = true; }
+
+  // one revolution visits every slot; anything older is overdue anyway
+  int ticks = 0;
+  while((int32_t)(now - wheelMs) >= 0 && ticks++ < COOP_WHEEL_SLOTS) {
+    uint32_t tickEnd = wheelMs + COOP_TICK_MS;
+    CoopTimer** pp = &wheel[slotOf(wheelMs)];
+    while(*pp) {
+      CoopTimer* t = *pp;
+      if((int32_t)(t->dueMs - tickEnd) >= 0) { pp = &t->next; continue; }
+      *pp = t->next;
+      t->armed = false;
+      if(t->periodMs) {
+        t->dueMs += t->periodMs;
+        if((int32_t)(t->dueMs - now) <= 0) t->dueMs = now + t->periodMs;
+        insert(*t);
+      }
+      if(t->fn) t->fn(*t);
+    }
+    wheelMs = tickEnd;
+  }
+  if((int32_t)(now - wheelMs) >= 0) wheelMs = now - now % COOP_TICK_MS;
+}
+
+static uint32_t nextDue(uint32_t now) {
+  uint32_t limit = now + COOP_MAX_IDLE_MS;
+  for(int k=0;k<COOP_WHEEL_SLOTS;k++) {
+    uint32_t tickStart = wheelMs + k * COOP_TICK_MS;
+    if((int32_t)(tickStart - limit) >= 0) break;
+    bool found = false;
+    uint32_t best = 0;
+    for(CoopTimer* t = wheel[slotOf(tickStart)]; t; t = t->next) {
+      if((int32_t)(t->dueMs - (tickStart + COOP_TICK_MS)) >= 0) continue;   // a later lap
+      if(!found || (int32_t)(t->dueMs - best) < 0) { best = t->dueMs; found = true; }
+    }
+    if(!found) continue;
+    // overdue timers fire when their slot comes up, not before
+    if((int32_t)(best - tickStart) < 0) best = tickStart;
+    return (int32_t)(best - limit) < 0 ? best : limit;
+  }
+  return limit;
+}
+
+void Coop_arm(CoopTimer& t, uint32_t inMs, CoopFn fn, uint32_t periodMs) {
+  if(!wheelStarted) advance(millis());
+  unlink(t);
+  t.dueMs = millis() + inMs;
+  t.periodMs = periodMs;
+  t.fn = fn;
+  insert(t);
+}
+
+void Coop_cancel(CoopTimer& t) { unlink(t); }
+
+void Coop_pollIn(uint32_t ms) {
+  uint32_t due = millis() + ms;
+  if(pollTimer.armed && (int32_t)(pollTimer.dueMs - due) <= 0) return;
+  Coop_arm(pollTimer, ms);
+}
+
+void Coop_taskSleep(CoopTask& t, uint32_t ms) {
+  t.wakeMs = millis() + ms;
+  Coop_arm(t.timer, ms);
+}
+
+void Coop_idle() {
+  advance(millis());
+  uint32_t now = millis();
+  int32_t wait = (int32_t)(nextDue(now) - now);
+  if(wait > 0) {
+    idleTotalMs += wait;
+    delay(wait);            // FreeRTOS idle task -> light sleep when PM is on
+  }
+  advance(millis());
+}
+
+uint32_t Coop_idleMs() { return idleTotalMs; }
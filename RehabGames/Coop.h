@@ -0,0 +1,49 @@
+#pragma once
+#include <Arduino.h>
+
+// ---------------- Cooperative runtime ----------------
+// loop() runs one pass of the current screen, then Coop_idle() fires due
+// timers and sleeps until the next one (hashed timer wheel, COOP_TICK_MS
+// resolution). Long game phases are protothread-style coroutines: CO_SLEEP()
+// arms a wake-up and returns instead of blocking, so touch, RFID, LEDs and
+// the network keep getting turns in between.
+//
+// Coroutine locals do not survive a yield: keep them static. Never put two
+// CO_ macros on the same source line.
+
+static const uint32_t COOP_TICK_MS     = 5;
+static const uint8_t  COOP_WHEEL_SLOTS = 64;
+static const uint32_t COOP_MAX_IDLE_MS = 50;   // loop() runs at least this often
+
+struct CoopTimer;
+typedef void (*CoopFn)(CoopTimer& t);
+
+struct CoopTimer {
+  CoopTimer* next;
+  uint32_t   dueMs;
+  uint32_t   periodMs;   // 0 = one-shot
+  CoopFn     fn;         // null: only wakes loop() on time
+  bool       armed;
+};
+
+void Coop_arm(CoopTimer& t, uint32_t inMs, CoopFn fn = nullptr, uint32_t periodMs = 0);
+void Coop_cancel(CoopTimer& t);
+void Coop_pollIn(uint32_t ms);     // run loop() again within ms (instead of delay(ms))
+void Coop_idle();                  // end of loop()
+uint32_t Coop_idleMs();            // total time slept in Coop_idle()
+
+// ---------------- coroutines ----------------
+struct CoopTask {
+  uint16_t  lc;          // resume point (source line), 0 = start
+  uint32_t  wakeMs;
+  CoopTimer timer;
+};
+
+void Coop_taskSleep(CoopTask& t, uint32_t ms);
+
+// a coroutine is "static bool step()" returning true once it has finished
+#define CO_BEGIN(t)          switch((t).lc) { case 0:
+#define CO_END(t)            } (t).lc = 0; return true
+#define CO_WAIT_UNTIL(t, c)  do { (t).lc = __LINE__; case __LINE__: if(!(c)) return false; } while(0)
+#define CO_SLEEP(t, ms)      do { Coop_taskSleep((t), (ms)); CO_WAIT_UNTIL(t, (int32_t)(millis() - (t).wakeMs) >= 0); } while(0)
+#define CO_RESET(t)          do { (t).lc = 0; Coop_cancel((t).timer); } while(0)
@@ -0,0 +1,289 @@
+// DrawList.cpp – recorded widget primitives, emitted as merged pixel runs
+#include "DrawList.h"
+#include "Render.h"
+#include "LabelCache.h"
+
+static DrawListStats stats;
+
+// ---------------- recording ----------------
+void DrawList::clear() {
+  n_ = 0;
+  textLen_ = 0;
+  state_ = 0;
+  datum_ = TL_DATUM;
+  font_ = 1;
+  fg_ = bg_ = TFT_WHITE;
+}
+
+DrawOp* DrawList::add(DrawOpKind k) {
+  if(n_ == DRAWLIST_OPS) { stats.overflows++; return nullptr; }
+  DrawOp* op = &ops_[n_++];
+  memset(op, 0, sizeof(*op));
+  op->kind = k;
+  return op;
+}
+
+void DrawList::shape(DrawOpKind k, int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+  if(w <= 0 || h <= 0) return;
+  DrawOp* op = add(k);
+  if(!op) return;
+  op->x = (int16_t)x; op->y = (int16_t)y;
+  op->w = (int16_t)w; op->h = (int16_t)h;
+  op->r = (uint8_t)r;
+  op->fg = (uint16_t)color;
+}
+
+void DrawList::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+  shape(DRAW_FILL_RECT, x, y, w, h, 0, color);
+}
+
+void DrawList::fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+  shape(DRAW_FILL_ROUND_RECT, x, y, w, h, r, color);
+}
+
+void DrawList::drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+  shape(DRAW_ROUND_RECT, x, y, w, h, r, color);
+}
+
+void DrawList::drawString(const char* s, int32_t x, int32_t y) {
+  size_t len = strlen(s) + 1;
+  if(textLen_ + len > DRAWLIST_TEXT_BYTES) { stats.overflows++; return; }
+  DrawOp* op = add(DRAW_TEXT);
+  if(!op) return;
+  op->x = (int16_t)x; op->y = (int16_t)y;
+  op->fg = fg_; op->bg = bg_;
+  op->datum = datum_; op->font = font_; op->state = state_;
+  op->text = textLen_;
+  memcpy(text_ + textLen_, s, len);
+  textLen_ += (uint8_t)len;
+}
+
+// ---------------- band raster ----------------
+// One band of rows in RAM: colour per pixel plus a bit per pixel that some
+// shape of the batch covered. Only covered pixels are sent.
+static uint16_t bandPx[DRAWLIST_BAND_ROWS][SCREEN_W];
+static uint8_t  bandHit[DRAWLIST_BAND_ROWS][SCREEN_W / 8];
+static int16_t  bandY0, bandY1;
+
+static void hline(int32_t x, int32_t y, int32_t w, uint16_t c) {
+  if(y < bandY0 || y >= bandY1 || w <= 0) return;
+  if(x < 0) { w += x; x = 0; }
+  if(x + w > SCREEN_W) w = SCREEN_W - x;
+  uint16_t* px = bandPx[y - bandY0];
+  uint8_t* hit = bandHit[y - bandY0];
+  for(int32_t i=x;i<x+w;i++) { px[i] = c; hit[i >> 3] |= (uint8_t)(1u << (i & 7)); }
+}
+
+static void vline(int32_t x, int32_t y, int32_t h, uint16_t c) {
+  for(int32_t j=0;j<h;j++) hline(x, y + j, 1, c);
+}
+
+// TFT_eSPI's corner decomposition, so the pixels match the library's
+static void fillCircleHelper(int32_t x0, int32_t y0, int32_t r, uint8_t corners, int32_t delta, uint16_t c) {
+  if(r <= 0) return;
+  int32_t f = 1 - r, ddF_x = 1, ddF_y = -r - r, y = 0;
+  delta++;
+  while(y < r) {
+    if(f >= 0) {
+      if(corners & 0x1) hline(x0 - y, y0 + r, y + y + delta, c);
+      if(corners & 0x2) hline(x0 - y, y0 - r, y + y + delta, c);
+      r--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    y++;
+    ddF_x += 2;
+    f += ddF_x;
+    if(corners & 0x1) hline(x0 - r, y0 + y, r + r + delta, c);
+    if(corners & 0x2) hline(x0 - r, y0 - y, r + r + delta, c);
+  }
+}
+
+static void drawCircleHelper(int32_t x0, int32_t y0, int32_t r, uint8_t corners, uint16_t c) {
+  if(r <= 0) return;
+  int32_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0;
+  while(x < r) {
+    if(f >= 0) { r--; ddF_y += 2; f += ddF_y; }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    if(corners & 0x4) { hline(x0 + x, y0 + r, 1, c); hline(x0 + r, y0 + x, 1, c); }
+    if(corners & 0x2) { hline(x0 + x, y0 - r, 1, c); hline(x0 + r, y0 - x, 1, c); }
+    if(corners & 0x8) { hline(x0 - r, y0 + x, 1, c); hline(x0 - x, y0 + r, 1, c); }
+    if(corners & 0x1) { hline(x0 - r, y0 - x, 1, c); hline(x0 - x, y0 - r, 1, c); }
+  }
+}
+
+static void rasterize(const DrawOp& op) {
+  int32_t x = op.x, y = op.y, w = op.w, h = op.h, r = op.r;
+  uint16_t c = op.fg;
+  switch(op.kind) {
+    case DRAW_FILL_RECT:
+      for(int32_t j=0;j<h;j++) hline(x, y + j, w, c);
+      break;
+    case DRAW_FILL_ROUND_RECT:
+      for(int32_t j=r;j<h-r;j++) hline(x, y + j, w, c);
+      fillCircleHelper(x + r, y + h - r - 1, r, 1, w - r - r - 1, c);
+      fillCircleHelper(x + r, y + r, r, 2, w - r - r - 1, c);
+      break;
+    case DRAW_ROUND_RECT:
+      hline(x + r, y, w - r - r, c);
+      hline(x + r, y + h - 1, w - r - r, c);
+      vline(x, y + r, h - r - r, c);
+      vline(x + w - 1, y + r, h - r - r, c);
+      drawCircleHelper(x + r, y + r, r, 1, c);
+      drawCircleHelper(x + w - r - 1, y + r, r, 2, c);
+      drawCircleHelper(x + w - r - 1, y + h - r - 1, r, 4, c);
+      drawCircleHelper(x + r, y + h - r - 1, r, 8, c);
+      break;
+    default:
+      break;
+  }
+}
+
+static bool covered(int row, int x) { return bandHit[row][x >> 3] & (1u << (x & 7)); }
+
+// first covered run of a band row within [x0, x1); 0 = none, 1 = just the
+// one, 2 = more follow
+static uint8_t firstRun(int row, int x0, int x1, int& a, int& b) {
+  int x = x0;
+  while(x < x1 && !covered(row, x)) x++;
+  if(x == x1) return 0;
+  a = x;
+  while(x < x1 && covered(row, x)) x++;
+  b = x;
+  while(x < x1 && !covered(row, x)) x++;
+  return x < x1 ? 2 : 1;
+}
+
+static void pushRun(int row, int a, int b) {
+  const uint16_t* px = bandPx[row];
+  int x = a;
+  while(x < b) {
+    int e = x + 1;
+    while(e < b && px[e] == px[x]) e++;
+    tft.pushColor(px[x], (uint32_t)(e - x));
+    x = e;
+  }
+}
+
+static void window(int x, int y, int w, int h) {
+  tft.setAddrWindow(x, y, w, h);
+  stats.windows++;
+  stats.pixels += (uint32_t)(w * h);
+}
+
+// rows with the same single run share a window; anything else goes run by run
+static void emitBand(int x0, int x1) {
+  int rows = bandY1 - bandY0;
+  int r = 0;
+  while(r < rows) {
+    int a, b;
+    uint8_t runs = firstRun(r, x0, x1, a, b);
+    if(runs == 1) {
+      int k = 1, a2, b2;
+      while(r + k < rows && firstRun(r + k, x0, x1, a2, b2) == 1 && a2 == a && b2 == b) k++;
+      window(a, bandY0 + r, b - a, k);
+      for(int j=0;j<k;j++) pushRun(r + j, a, b);
+      r += k;
+      continue;
+    }
+    int x = x0;
+    while(runs && firstRun(r, x, x1, a, b)) {
+      window(a, bandY0 + r, b - a, 1);
+      pushRun(r, a, b);
+      x = b;
+    }
+    r++;
+  }
+}
+
+static void runBatch(const DrawOp* ops, uint8_t n) {
+  int x0 = SCREEN_W, y0 = SCREEN_H, x1 = 0, y1 = 0;
+  for(uint8_t i=0;i<n;i++){
+    const DrawOp& op = ops[i];
+    if(op.x < x0) x0 = op.x;
+    if(op.y < y0) y0 = op.y;
+    if(op.x + op.w > x1) x1 = op.x + op.w;
+    if(op.y + op.h > y1) y1 = op.y + op.h;
+  }
+  if(x0 < 0) x0 = 0;
+  if(y0 < 0) y0 = 0;
+  if(x1 > SCREEN_W) x1 = SCREEN_W;
+  if(y1 > SCREEN_H) y1 = SCREEN_H;
+  if(x0 >= x1 || y0 >= y1) return;
+  stats.batches++;
+
+  for(int y=y0;y<y1;y+=DRAWLIST_BAND_ROWS){
+    bandY0 = (int16_t)y;
+    bandY1 = (int16_t)(y1 - y < DRAWLIST_BAND_ROWS ? y1 : y + DRAWLIST_BAND_ROWS);
+    memset(bandHit, 0, sizeof(bandHit));
+    for(uint8_t i=0;i<n;i++){
+      const DrawOp& op = ops[i];
+      if(op.y < bandY1 && op.y + op.h > bandY0) rasterize(op);
+    }
+    emitBand(x0, x1);
+  }
+}
+
+// ---------------- text ----------------
+struct TextShown {
+  uint8_t  valid;         // DRAW_SET_* bits that tft is known to be at
+  uint8_t  datum, font;
+  uint16_t fg, bg;
+};
+
+static void applyText(uint8_t state, uint8_t datum, uint8_t font, uint16_t fg, uint16_t bg, TextShown& s) {
+  if((state & DRAW_SET_DATUM) && !((s.valid & DRAW_SET_DATUM) && s.datum == datum)) {
+    tft.setTextDatum(datum);
+    s.datum = datum;
+    s.valid |= DRAW_SET_DATUM;
+  }
+  if((state & DRAW_SET_FONT) && !((s.valid & DRAW_SET_FONT) && s.font == font)) {
+    tft.setTextFont(font);
+    s.font = font;
+    s.valid |= DRAW_SET_FONT;
+  }
+  if((state & DRAW_SET_COLOR) && !((s.valid & DRAW_SET_COLOR) && s.fg == fg && s.bg == bg)) {
+    tft.setTextColor(fg, bg);
+    s.fg = fg;
+    s.bg = bg;
+    s.valid |= DRAW_SET_COLOR;
+  }
+}
+
+// ---------------- API ----------------
+void DrawList_run(const DrawList& dl) {
+  if(!dl.n_ && !dl.state_) return;
+  RenderDirect rd;
+  stats.runs++;
+  stats.ops += dl.n_;
+
+  TextShown shown;
+  shown.valid = 0;
+  tft.startWrite();
+  uint8_t i = 0;
+  while(i < dl.n_) {
+    const DrawOp& op = dl.ops_[i];
+    if(op.kind == DRAW_TEXT && op.state == DRAW_SET_ALL) {
+      LabelCache_draw(dl.text_ + op.text, op.x, op.y, op.datum, op.font, op.fg, op.bg);
+      shown = { DRAW_SET_ALL, op.datum, op.font, op.fg, op.bg };
+      i++;
+      continue;
+    }
+    if(op.kind == DRAW_TEXT) {
+      applyText(op.state, op.datum, op.font, op.fg, op.bg, shown);
+      tft.drawString(dl.text_ + op.text, op.x, op.y);
+      i++;
+      continue;
+    }
+    uint8_t j = i + 1;
+    while(j < dl.n_ && dl.ops_[j].kind != DRAW_TEXT) j++;
+    runBatch(dl.ops_ + i, j - i);
+    i = j;
+  }
+  applyText(dl.state_, dl.datum_, dl.font_, dl.fg_, dl.bg_, shown);
+  tft.endWrite();
+}
+
+const DrawListStats& DrawList_stats() { return stats; }
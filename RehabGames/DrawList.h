@@ -0,0 +1,84 @@
+#pragma once
+#include "Shared.h"
+
+// ---------------- Draw lists ----------------
+// Compound widgets (buttons: shadow, fill, outline, two labels) are recorded
+// into a DrawList with the same calls they made on tft, then DrawList_run()
+// emits the whole list in one held SPI transaction (startWrite..endWrite):
+//   - consecutive shapes form a batch that is rasterized in bands of 8 rows
+//     into RAM; each covered run goes out once, rows with the same single
+//     run share one address window. Overdrawn pixels (the shadow under the
+//     fill, the fill under the outline) never reach the bus, and the ~200
+//     one-line windows of the rounded corners become ~40
+//   - text goes to tft in recording order on top of the batch before it;
+//     datum / font / colour are set only when they change, and the state
+//     the recording ended in is what tft is left with. Text recorded after
+//     all three were set goes through the label cache (LabelCache.h)
+// Pixels are the ones TFT_eSPI draws (same corner decomposition).
+//
+// A list is plain data and can be run any number of times: widgets that
+// never change (the DONE-screen buttons) are recorded once. Recording
+// does not touch the bus; running takes a RenderDirect. Lists hold up to
+// DRAWLIST_OPS primitives and DRAWLIST_TEXT_BYTES of label text; anything
+// past that is dropped and counted (DrawListStats::overflows).
+
+static const uint8_t DRAWLIST_OPS        = 16;
+static const uint8_t DRAWLIST_TEXT_BYTES = 64;
+static const uint8_t DRAWLIST_BAND_ROWS  = 8;
+
+enum DrawOpKind : uint8_t { DRAW_FILL_RECT, DRAW_FILL_ROUND_RECT, DRAW_ROUND_RECT, DRAW_TEXT };
+
+// text state a DRAW_TEXT op sets before drawing (DrawOp::state)
+enum : uint8_t { DRAW_SET_DATUM = 1, DRAW_SET_FONT = 2, DRAW_SET_COLOR = 4, DRAW_SET_ALL = 7 };
+
+struct DrawOp {
+  DrawOpKind kind;
+  uint8_t    r;           // corner radius
+  int16_t    x, y, w, h;  // text: anchor in x, y
+  uint16_t   fg, bg;      // shapes use fg
+  uint8_t    datum, font, state;
+  uint8_t    text;        // offset into DrawList::text_
+};
+
+struct DrawListStats {
+  uint32_t runs;
+  uint32_t ops;
+  uint32_t batches;       // shape batches rasterized
+  uint32_t windows;       // address windows they took
+  uint32_t pixels;        // pixels they pushed
+  uint32_t overflows;     // primitives dropped at record time
+};
+
+class DrawList {
+public:
+  DrawList() { clear(); }
+
+  void    clear();
+  bool    empty() const { return n_ == 0; }
+  uint8_t size() const  { return n_; }
+
+  // recording: the tft calls widgets already use
+  void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+  void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+  void drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+  void setTextDatum(uint8_t d)               { datum_ = d; state_ |= DRAW_SET_DATUM; }
+  void setTextFont(uint8_t f)                { font_ = f; state_ |= DRAW_SET_FONT; }
+  void setTextColor(uint16_t fg)             { setTextColor(fg, fg); }
+  void setTextColor(uint16_t fg, uint16_t bg) { fg_ = fg; bg_ = bg; state_ |= DRAW_SET_COLOR; }
+  void drawString(const char* s, int32_t x, int32_t y);
+
+private:
+  friend void DrawList_run(const DrawList& dl);
+
+  DrawOp* add(DrawOpKind k);
+  void    shape(DrawOpKind k, int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+
+  DrawOp   ops_[DRAWLIST_OPS];
+  char     text_[DRAWLIST_TEXT_BYTES];
+  uint8_t  n_, textLen_;
+  uint8_t  datum_, font_, state_;   // text state as recorded so far
+  uint16_t fg_, bg_;
+};
+
+void DrawList_run(const DrawList& dl);      // takes a RenderDirect
+const DrawListStats& DrawList_stats();
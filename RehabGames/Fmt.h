@@ -0,0 +1,91 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <limits>
+#include <type_traits>
+
+// ---------------- heap-free text ----------------
+// Fixed-size text for the screen, built in place instead of with String:
+//
+//   TextBuf<32> t;
+//   tft.drawString(t.set("Pairs: ", pairs, "/", total), 250, 224);
+//
+// set() takes string literals / char arrays, chars and integers. The longest
+// text those argument types can produce (every integer at its widest, every
+// array full) must fit N including the NUL, or the build fails, so a later
+// edit that adds a field can't overflow the buffer at runtime. Nothing here
+// allocates; integers wider than 32 bits are the only ones formatted in
+// 64-bit arithmetic.
+
+// widest text one argument can produce; unsupported types have no value
+template<typename T, bool = std::is_integral<T>::value> struct FmtWidth {};
+template<typename T> struct FmtWidth<T, true> {
+  static const size_t value = std::numeric_limits<T>::digits10 + 1 + (std::is_signed<T>::value ? 1 : 0);
+};
+template<> struct FmtWidth<char, true> { static const size_t value = 1; };
+template<> struct FmtWidth<bool, true> { static const size_t value = 1; };
+template<size_t K> struct FmtWidth<char[K], false> { static const size_t value = K - 1; };
+
+template<typename... A> struct FmtMaxLen { static const size_t value = 0; };
+template<typename H, typename... T> struct FmtMaxLen<H, T...> {
+  static const size_t value = FmtWidth<H>::value + FmtMaxLen<T...>::value;
+};
+
+template<size_t N>
+class TextBuf {
+public:
+  static_assert(N >= 2, "TextBuf needs room for at least one char");
+
+  TextBuf() : len_(0) { s_[0] = 0; }
+
+  template<typename... A>
+  const char* set(const A&... a) {
+    static_assert(FmtMaxLen<A...>::value < N, "TextBuf too small for the longest text of these arguments");
+    len_ = 0;
+    add(a...);
+    s_[len_] = 0;
+    return s_;
+  }
+
+  const char* c_str() const { return s_; }
+  size_t      length() const { return len_; }
+
+private:
+  void add() {}
+  template<typename H, typename... T>
+  void add(const H& h, const T&... t) { put(h); add(t...); }
+
+  void put(const char* p) { while(*p && len_ < N - 1) s_[len_++] = *p++; }
+  void put(char c) { if(len_ < N - 1) s_[len_++] = c; }
+  void put(bool b) { put(b ? '1' : '0'); }
+
+  template<typename T>
+  typename std::enable_if<std::is_integral<T>::value>::type put(T v) {
+    if(v < 0) {
+      put('-');
+      // two's complement magnitude; also right for the most negative value
+      if(sizeof(T) <= 4) putU32(0u - (uint32_t)v);
+      else putU64(0ull - (uint64_t)v);
+    } else {
+      if(sizeof(T) <= 4) putU32((uint32_t)v);
+      else putU64((uint64_t)v);
+    }
+  }
+
+  void putU32(uint32_t v) {
+    char tmp[10];
+    int n = 0;
+    do { tmp[n++] = (char)('0' + v % 10); v /= 10; } while(v);
+    while(n && len_ < N - 1) s_[len_++] = tmp[--n];
+  }
+  void putU64(uint64_t v) {
+    if(v <= 0xFFFFFFFFull) { putU32((uint32_t)v); return; }
+    char tmp[20];
+    int n = 0;
+    do { tmp[n++] = (char)('0' + v % 10); v /= 10; } while(v);
+    while(n && len_ < N - 1) s_[len_++] = tmp[--n];
+  }
+
+  char   s_[N];
+  size_t len_;
+};
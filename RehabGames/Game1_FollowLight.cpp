@@ -4,7 +4,7 @@
 // ✅ DONE screen buttons no longer “swapped” (works even if touch X is mirrored)
 // ✅ PLAY AGAIN -> Game1 level screen
 // ✅ GAMES MENU -> Main games menu
-// ✅ Touch “ghost press” prevented using waitTouchRelease()
+// ✅ Touch “ghost press” prevented using Touch_waitRelease()
 // ✅ Uses drawMenu() (as you requested) to redraw menu
 //
 // IMPORTANT: This file assumes your touch may be mirrored in X.
@@ -13,6 +13,18 @@
 // =====================================================================================
 
 #include "Shared.h"
+#include "Stimulus.h"
+#include "RtStats.h"
+#include "Coop.h"
+#include "Render.h"
+#include "Rfid.h"
+#include "Fmt.h"
+#include "ScreenCache.h"
+#include "DrawList.h"
+#include "Progress.h"
+#include "LabelCache.h"
+#include "Leds.h"
+#include "Rng.h"
 #include <math.h>
 
 // Must exist in menu.cpp (non-static)
@@ -48,8 +60,8 @@ static const int MAP_LEN = sizeof(MAP) / sizeof(MAP[0]);
 
 // ---------------- GAME STATE ----------------
 enum Level { NONE, LEVEL_1, LEVEL_2 };
-enum State { PICK_LEVEL, PLAYING, DONE };
-enum RoundPhase { PHASE_IDLE, PHASE_REMEMBER, PHASE_SCAN };
+enum State { PICK_LEVEL, COUNTDOWN, PLAYING, DONE };
+enum RoundPhase { PHASE_IDLE, PHASE_REMEMBER, PHASE_SCAN, PHASE_RESULT };
 
 static Level level = NONE;
 static State state = PICK_LEVEL;
@@ -63,15 +75,19 @@ static int score = 0;
 static int coinsEarned = 0;
 
 static uint8_t currentLed = 0;
-static uint8_t prevLed = 255;
+static int16_t prevZone = -1;        // index into LED_ZONES
+static uint8_t nextLed = 255;        // picked during the previous feedback
+static bool nextReady = false;       // ... and its screen parts are up
 static uint32_t scanStartMs = 0;
 
-// RFID recovery
-static unsigned long lastRFIDSeenOkMs = 0;
-static const unsigned long RFID_RECOVER_MS = 6000;
-static uint32_t lastSAMRearmMs = 0;
+// onset of the current round's stimulus (micros, measured at the LED latch):
+// reaction times run from here, exposure included
+static uint32_t stimOnsetUs = 0;
 
-static uint32_t lastCountdownDrawMs = 0;
+// countdown / result pause run as a coroutine (one at a time)
+static CoopTask flowTask;
+static bool resultCorrect = false;
+static bool resultTimeout = false;
 
 // UI colors
 static const uint16_t C_BG     = 0x08A3;
@@ -189,36 +205,12 @@ static bool hitEitherXPad(int sx, int sy, int rx, int ry, int rw, int rh, int pa
 
 
 
-static void waitTouchRelease() {
-  int tx, ty;
-  while (Touch_pressed(tx, ty)) delay(5);
-}
-
 // ---------------- LED helpers ----------------
-static void ledsOff() { strip.clear(); strip.show(); }
-
-static void lightOnly(uint8_t idx) {
-  strip.clear();
-  strip.setPixelColor(idx, strip.Color(255,255,255));
-  strip.show();
-}
+static void ledsOff() { Leds_clear(); Leds_show(); }
 
-static void flashAll(uint32_t color, int times, int onMs=120, int offMs=80) {
-  for(int t=0;t<times;t++){
-    for(int i=0;i<LED_COUNT;i++) strip.setPixelColor(i,color);
-    strip.show(); delay(onMs);
-    strip.clear(); strip.show(); delay(offMs);
-  }
-}
-
-static void quickAck(bool ok) {
-  uint32_t c = ok ? strip.Color(0, 180, 0) : strip.Color(180, 0, 0);
-  strip.clear();
-  strip.setPixelColor(currentLed, c);
-  strip.show();
-  delay(40);
-  strip.clear();
-  strip.show();
+static void fillAll(uint32_t color) {
+  Leds_fill(color);
+  Leds_show();
 }
 
 static void celebrateCoinsOnce(int coins) {
@@ -227,33 +219,23 @@ static void celebrateCoinsOnce(int coins) {
   if (bursts > 8) bursts = 8;
 
   for (int b = 0; b < bursts; b++) {
-    strip.clear();
+    Leds_clear();
     for (int k = 0; k < 6; k++) {
-      int i = random(0, LED_COUNT);
-      strip.setPixelColor(i, strip.Color(220, 160, 0));
+      int i = Rng_below(LED_COUNT);
+      Leds_set(i, strip.Color(220, 160, 0));
     }
-    strip.show();
-    delay(70);
-    strip.clear();
-    strip.show();
-    delay(40);
+    Leds_hold(70);
+    Leds_clear();
+    Leds_hold(40);
   }
   for (int p = 0; p < 2; p++) {
-    for (int i=0;i<LED_COUNT;i++) strip.setPixelColor(i, strip.Color(0, 120, 180));
-    strip.show(); delay(70);
-    strip.clear(); strip.show(); delay(60);
+    Leds_fill(strip.Color(0, 120, 180));
+    Leds_hold(70);
+    Leds_clear(); Leds_hold(60);
   }
 }
 
 // ---------------- RFID helpers ----------------
-static bool readUID4(uint8_t out[4]) {
-  uint8_t uid[7], len;
-  if(!nfc.readPassiveTargetID(PN532_MIFARE_ISO14443A, uid, &len, 50)) return false;
-  if(len < 4) return false;
-  for(int i=0;i<4;i++) out[i]=uid[i];
-  return true;
-}
-
 static const uint8_t* expectedUID(uint8_t led){
   for(int i=0;i<MAP_LEN;i++) if(MAP[i].led == led) return MAP[i].uid;
   return nullptr;
@@ -264,23 +246,6 @@ static bool uidEq(const uint8_t*a,const uint8_t*b){
   return true;
 }
 
-static bool initPN532WithFallback() {
-  Wire.setClock(400000);
-  nfc.begin();
-  delay(30);
-  uint32_t v = nfc.getFirmwareVersion();
-  if(v) { nfc.SAMConfig(); return true; }
-
-  Wire.setClock(100000);
-  delay(30);
-  nfc.begin();
-  delay(30);
-  v = nfc.getFirmwareVersion();
-  if(!v) return false;
-  nfc.SAMConfig();
-  return true;
-}
-
 // ---------------- UI helpers ----------------
 static uint16_t blend565(uint16_t c1, uint16_t c2, uint8_t t) {
   uint8_t r1 = (c1 >> 11) & 0x1F, g1 = (c1 >> 5) & 0x3F, b1 = c1 & 0x1F;
@@ -291,11 +256,13 @@ static uint16_t blend565(uint16_t c1, uint16_t c2, uint8_t t) {
   return (r<<11) | (g<<5) | b;
 }
 
-static void fillGradV(int x, int y, int w, int h, uint16_t top, uint16_t bot, int step=2) {
-  for (int i = 0; i < h; i += step) {
+// rows [from, h) of a gradient spanning h rows; from = 0 paints all of it
+static void fillGradV(int x, int y, int w, int h, uint16_t top, uint16_t bot, int step=2, int from=0) {
+  for (int i = from; i < h; i += step) {
     uint8_t t = (uint32_t)i * 255 / (h - 1);
     uint16_t c = blend565(top, bot, t);
     tft.fillRect(x, y + i, w, step, c);
+    SpiBus_yield(SPI_DEV_TFT);   // touch may slot in between strips
   }
 }
 
@@ -314,22 +281,34 @@ static bool hitRectTouch(int sx, int sy, int rx, int ry, int rw, int rh) {
   return inRect(x, y, rx, ry, rw, rh);
 }
 
-static void drawBackground() {
+// ---------------- render commands ----------------
+// In-play widgets are posted to the render queue (Render.h); the screens
+// below them draw inline under a RenderDirect.
+struct TextCmd   { char text[32]; uint16_t color; };
+struct StatusCmd { int16_t r, total, s; };
+
+static void setText(TextCmd& c, const char* text, uint16_t color) {
+  strncpy(c.text, text, sizeof(c.text) - 1);
+  c.text[sizeof(c.text) - 1] = 0;
+  c.color = color;
+}
+
+static void paintBackground() {
   fillGradV(0, 0, SCREEN_W, SCREEN_H, C_BG, 0x0008, 2);
-  for (int i = 0; i < 28; i++) tft.drawPixel(random(0, SCREEN_W), random(0, SCREEN_H), TFT_WHITE);
+  for (int i = 0; i < 28; i++) tft.drawPixel(Rng_decor(0, SCREEN_W), Rng_decor(0, SCREEN_H), TFT_WHITE);
 }
+static void drawBackground() { Render_call<paintBackground>(); }
 
 static void drawBackButton() {
+  RenderDirect rd;
   tft.fillRoundRect(BTN_BACK_X, BTN_BACK_Y, BTN_BACK_W, BTN_BACK_H, 8, C_PANEL2);
   tft.drawRoundRect(BTN_BACK_X, BTN_BACK_Y, BTN_BACK_W, BTN_BACK_H, 8, TFT_WHITE);
-  tft.setTextDatum(MC_DATUM);
-  tft.setTextFont(2);
-  tft.setTextColor(TFT_WHITE, C_PANEL2);
-  tft.drawString("< Back", BTN_BACK_X + BTN_BACK_W/2, BTN_BACK_Y + BTN_BACK_H/2);
+  LabelCache_draw("< Back", BTN_BACK_X + BTN_BACK_W/2, BTN_BACK_Y + BTN_BACK_H/2, MC_DATUM, 2, TFT_WHITE, C_PANEL2);
   tft.setTextDatum(TL_DATUM);
 }
 
-static void uiTopBar(const char* subtitle) {
+static void paintTopBar(const TextCmd& c) {
+  const char* subtitle = c.text;
   // moved down so it won't overlap the back button
   int x = 10, y = 44, w = 300, h = 64;      // (h slightly taller)
   uint16_t top = 0x0211;
@@ -342,14 +321,9 @@ static void uiTopBar(const char* subtitle) {
 
   int cx = x + w/2;
 
-  tft.setTextDatum(MC_DATUM);
-
   // Title (centered in the box)
-  tft.setTextFont(4);
-  tft.setTextColor(TFT_BLACK, bot);
-  tft.drawString("Follow the Light", cx + 1, y + 22 + 1);
-  tft.setTextColor(C_ACCENT, bot);
-  tft.drawString("Follow the Light", cx,     y + 22);
+  LabelCache_draw("Follow the Light", cx + 1, y + 22 + 1, MC_DATUM, 4, TFT_BLACK, bot);
+  LabelCache_draw("Follow the Light", cx,     y + 22,     MC_DATUM, 4, C_ACCENT, bot);
 
   // Subtitle (centered in the box)
   tft.setTextFont(2);
@@ -358,61 +332,98 @@ static void uiTopBar(const char* subtitle) {
 
   tft.setTextDatum(TL_DATUM);
 }
+static void uiTopBar(const char* subtitle) {
+  TextCmd c; setText(c, subtitle, 0);
+  Render_post<TextCmd, paintTopBar>(RK_HEADER, c);
+}
 
 
-static void uiButton(int x, int y, int w, int h, uint16_t bg, const char* label) {
-  tft.fillRoundRect(x+3, y+3, w, h, 18, TFT_BLACK);
-  tft.fillRoundRect(x, y, w, h, 18, bg);
-  tft.drawRoundRect(x, y, w, h, 18, TFT_WHITE);
+static void uiButton(DrawList& dl, int x, int y, int w, int h, uint16_t bg, const char* label) {
+  dl.fillRoundRect(x+3, y+3, w, h, 18, TFT_BLACK);
+  dl.fillRoundRect(x, y, w, h, 18, bg);
+  dl.drawRoundRect(x, y, w, h, 18, TFT_WHITE);
 
-  tft.setTextDatum(MC_DATUM);
-  if (w <= 140) tft.setTextFont(2);
-  else         tft.setTextFont(4);
+  dl.setTextDatum(MC_DATUM);
+  if (w <= 140) dl.setTextFont(2);
+  else         dl.setTextFont(4);
 
-  tft.setTextColor(TFT_BLACK, bg);
-  tft.drawString(label, x + w/2 + 1, y + h/2 + 1);
-  tft.setTextColor(TFT_WHITE, bg);
-  tft.drawString(label, x + w/2, y + h/2);
-  tft.setTextDatum(TL_DATUM);
+  dl.setTextColor(TFT_BLACK, bg);
+  dl.drawString(label, x + w/2 + 1, y + h/2 + 1);
+  dl.setTextColor(TFT_WHITE, bg);
+  dl.drawString(label, x + w/2, y + h/2);
+  dl.setTextDatum(TL_DATUM);
 }
 
-static void drawLevelScreen() {
-  ledsOff();
+static void uiButton(int x, int y, int w, int h, uint16_t bg, const char* label) {
+  DrawList dl;
+  uiButton(dl, x, y, w, h, bg, label);
+  DrawList_run(dl);
+}
+
+static void paintLevelScreen() {
   drawBackground();
   drawBackButton();
   uiTopBar("Choose a mode");
   uiButton(BTN_X, BTN_WARM_Y, BTN_W, BTN_H, C_OK,   "WARM-UP");
   uiButton(BTN_X, BTN_HOT_Y,  BTN_W, BTN_H, C_WARN, "HOT MODE");
-  
 }
 
-static void clearCenterArea() {
+static void drawLevelScreen() {
+  ledsOff();
+  ScreenCache_draw(SCREEN_G1_LEVEL, paintLevelScreen);
+}
+
+static void paintClearCenter() {
   fillGradV(0, 118, SCREEN_W, 92, C_BG, 0x0008, 2);
   for(int i=0;i<6;i++){
-    tft.drawPixel(random(0, SCREEN_W), random(118, 210), TFT_WHITE);
+    tft.drawPixel(Rng_decor(0, SCREEN_W), Rng_decor(118, 210), TFT_WHITE);
+  }
+}
+static void clearCenterArea() { Render_call<paintClearCenter>(); }
+
+// the countdown digit card (x 60..260, y 102..180) reaches over the top
+// bar's bottom edge and the background rows above the centre area; put
+// back exactly what paintTopBar() / paintBackground() left in those rows
+static void paintCountdownEdge() {
+  int x = 60, w = 200;
+  fillGradV(x, 46, w, 60, 0x0211, C_PANEL, 2, 56);   // top bar gradient, y 102..105
+  tft.drawFastHLine(x, 106, w, C_ACCENT);
+  tft.drawFastHLine(x, 107, w, 0x7BEF);
+  for(int y = 108; y < 118; y += 2) {
+    tft.fillRect(x, y, w, 2, blend565(C_BG, 0x0008, (uint32_t)y * 255 / (SCREEN_H - 1)));
   }
 }
 
-static void uiCenterCard(const char* msg, uint16_t bgColor) {
+// the scan bar (y 200..211) sits below the card: the centre area's rows
+// under the card's shadow, then the background's (the hint goes on top)
+static void paintClearScanBar() {
+  fillGradV(0, 118, SCREEN_W, 92, C_BG, 0x0008, 2, 78);
+  fillGradV(0, 0, SCREEN_W, SCREEN_H, C_BG, 0x0008, 2, 210);
+}
+
+static void paintCenterCard(const TextCmd& c) {
+  const char* msg = c.text;
+  uint16_t bgColor = c.color;
   int x = 20, y = 122, w = 280, h = 70;
 
   tft.fillRoundRect(x+3, y+3, w, h, 16, TFT_BLACK);
   tft.fillRoundRect(x, y, w, h, 16, bgColor);
   tft.drawRoundRect(x, y, w, h, 16, TFT_WHITE);
 
-  tft.setTextDatum(MC_DATUM);
-  tft.setTextFont(4);
-
   uint16_t txt = TFT_WHITE;
   if (bgColor == C_WARN) txt = TFT_BLACK;
   if (bgColor == C_OK)   txt = TFT_BLACK;
 
-  tft.setTextColor(txt, bgColor);
-  tft.drawString(msg, 160, y + h/2 + 4);
+  LabelCache_draw(msg, 160, y + h/2 + 4, MC_DATUM, 4, txt, bgColor);
   tft.setTextDatum(TL_DATUM);
 }
+static void uiCenterCard(const char* msg, uint16_t bgColor) {
+  TextCmd c; setText(c, msg, bgColor);
+  Render_post<TextCmd, paintCenterCard>(RK_CARD, c);
+}
 
-static void uiHint(const char* msg) {
+static void paintHint(const TextCmd& c) {
+  const char* msg = c.text;
   fillGradV(0, 214, SCREEN_W, 26, C_BG, 0x0008, 2);
   tft.setTextFont(2);
   tft.setTextColor(C_MUTED, 0x0000);
@@ -420,8 +431,13 @@ static void uiHint(const char* msg) {
   tft.drawString(msg, 160, 230);
   tft.setTextDatum(TL_DATUM);
 }
+static void uiHint(const char* msg) {
+  TextCmd c; setText(c, msg, 0);
+  Render_post<TextCmd, paintHint>(RK_HINT, c);
+}
 
-static void uiStatusRight(int r, int total, int s) {
+static void paintStatusRight(const StatusCmd& c) {
+  int r = c.r, total = c.total, s = c.s;
   int w = 86, h = 46;
   int x = SCREEN_W - w - 8;
   int y = 70;
@@ -434,8 +450,13 @@ static void uiStatusRight(int r, int total, int s) {
   tft.setCursor(x + 8, y + 26);
   tft.printf("S %d", s);
 }
+static void uiStatusRight(int r, int total, int s) {
+  StatusCmd c = { (int16_t)r, (int16_t)total, (int16_t)s };
+  Render_post<StatusCmd, paintStatusRight>(RK_STATUS, c);
+}
 
-static void uiProgress(int currentRound, int totalRounds) {
+static void paintProgress(const StatusCmd& c) {
+  int currentRound = c.r, totalRounds = c.total;
   int x = 10, y = 74, w = 210, h = 10;
   tft.fillRoundRect(x, y, w, h, 6, C_PANEL2);
 
@@ -447,18 +468,16 @@ static void uiProgress(int currentRound, int totalRounds) {
   int fillW = (int)(w * frac);
   tft.fillRoundRect(x, y, fillW, h, 6, C_ACCENT);
 }
+static void uiProgress(int currentRound, int totalRounds) {
+  StatusCmd c = { (int16_t)currentRound, (int16_t)totalRounds, 0 };
+  Render_post<StatusCmd, paintProgress>(RK_PROGRESS, c);
+}
 
-static void uiScanCountdown(uint32_t elapsedMs, uint32_t totalMs) {
-  int x = 30, y = 200, w = 260, h = 12;
-  tft.fillRoundRect(x, y, w, h, 6, C_PANEL2);
-
-  float frac = (totalMs > 0) ? (float)elapsedMs / totalMs : 0;
-  if (frac < 0) frac = 0;
-  if (frac > 1) frac = 1;
+static ProgressBar scanBar;
 
-  int fillW = (int)(w * (1.0f - frac));
-  if (fillW < 0) fillW = 0;
-  tft.fillRoundRect(x, y, fillW, h, 6, C_WARN);
+static void uiScanCountdown(uint32_t elapsedMs, uint32_t totalMs) {
+  uint32_t left = elapsedMs < totalMs ? totalMs - elapsedMs : 0;
+  Progress_set(scanBar, left, totalMs, C_WARN);
 }
 
 // ---------------- coins + feedback ----------------
@@ -479,34 +498,32 @@ static const char* feedbackText(int scoreVal, int totalRounds, Level lvl) {
 }
 
 static void drawEndScreen() {
-  ledsOff();
-  drawBackground();
-
-  tft.setTextDatum(MC_DATUM);
-  tft.setTextFont(2);
-  tft.setTextColor(C_MUTED, TFT_BLACK);
-  tft.drawString("Session finished", 160, 18);
-
   coinsEarned = calcCoinsEarned(score, level);
   const char* fb = feedbackText(score, roundsTotal, level);
 
+  // LED show first: it blocks for ~1 s and must not sit on the SPI bus
   if(!endCelebrated){
     celebrateCoinsOnce(coinsEarned);
     endCelebrated = true;
   }
 
+  RenderDirect rd;
+  ledsOff();
+  drawBackground();
+
+  LabelCache_draw("Session finished", 160, 18, MC_DATUM, 2, C_MUTED, TFT_BLACK);
+
   int cardX = 24, cardY = 44, cardW = 272, cardH = 78;
   tft.fillRoundRect(cardX+3, cardY+3, cardW, cardH, 16, TFT_BLACK);
   tft.fillRoundRect(cardX,   cardY,   cardW, cardH, 16, C_PANEL2);
   tft.drawRoundRect(cardX,   cardY,   cardW, cardH, 16, TFT_WHITE);
 
-  tft.setTextFont(4);
-  tft.setTextColor(C_ACCENT, C_PANEL2);
-  tft.drawString("FINAL SCORE", 160, cardY + 18);
+  LabelCache_draw("FINAL SCORE", 160, cardY + 18, MC_DATUM, 4, C_ACCENT, C_PANEL2);
 
   tft.setTextFont(6);
   tft.setTextColor(TFT_WHITE, C_PANEL2);
-  tft.drawString(String(score), 160, cardY + 52);
+  TextBuf<12> t;
+  tft.drawString(t.set(score), 160, cardY + 52);
 
   int pillX = 74, pillY = cardY + cardH + 8, pillW = 172, pillH = 24;
   tft.fillRoundRect(pillX, pillY, pillW, pillH, 12, 0x0841);
@@ -517,13 +534,10 @@ static void drawEndScreen() {
   tft.fillCircle(coinCx, coinCy, 6, C_WARN);
   tft.drawCircle(coinCx, coinCy, 6, TFT_WHITE);
 
-  tft.setTextFont(2);
-  tft.setTextColor(C_ACCENT, 0x0841);
-  tft.drawString("+", pillX + 40, coinCy);
+  LabelCache_draw("+", pillX + 40, coinCy, MC_DATUM, 2, C_ACCENT, 0x0841);
   tft.setTextColor(TFT_WHITE, 0x0841);
-  tft.drawString(String(coinsEarned), pillX + 55, coinCy);
-  tft.setTextColor(C_ACCENT, 0x0841);
-  tft.drawString("COINS", pillX + 110, coinCy);
+  tft.drawString(t.set(coinsEarned), pillX + 55, coinCy);
+  LabelCache_draw("COINS", pillX + 110, coinCy, MC_DATUM, 2, C_ACCENT, 0x0841);
 
   int fbX = 18, fbY = pillY + pillH + 8, fbW = 284, fbH = 28;
   tft.fillRoundRect(fbX, fbY, fbW, fbH, 12, C_PANEL);
@@ -531,9 +545,13 @@ static void drawEndScreen() {
   tft.setTextColor(TFT_WHITE, C_PANEL);
   tft.drawString(fb, 160, fbY + fbH/2);
 
-  // Side-by-side buttons
-  uiButton(END_PLAY_X, END_PLAY_Y, END_PLAY_W, END_PLAY_H, C_ACCENT, "PLAY AGAIN");
-  uiButton(END_MENU_X, END_MENU_Y, END_MENU_W, END_MENU_H, C_WARN, "GAMES MENU");
+  // Side-by-side buttons, recorded once
+  static DrawList endButtons;
+  if(endButtons.empty()) {
+    uiButton(endButtons, END_PLAY_X, END_PLAY_Y, END_PLAY_W, END_PLAY_H, C_ACCENT, "PLAY AGAIN");
+    uiButton(endButtons, END_MENU_X, END_MENU_Y, END_MENU_W, END_MENU_H, C_WARN, "GAMES MENU");
+  }
+  DrawList_run(endButtons);
 
   tft.setTextDatum(TL_DATUM);
 }
@@ -545,57 +563,103 @@ static void applyLevel() {
 }
 
 static uint8_t pickNextLed() {
-  uint8_t led;
-  do { led = LED_ZONES[random(NUM_ZONES)]; }
-  while(led == prevLed && NUM_ZONES > 1);
-  prevLed = led;
-  return led;
-}
-
-static void showResult(bool correct, bool timeout=false) {
-  if(timeout) {
-    uiCenterCard("TIME UP", C_BAD);
-    flashAll(strip.Color(180,0,0), 1, 200, 120);
-    delay(260);
-    return;
-  }
-  if(correct) {
+  prevZone = Rng_indexOther(NUM_ZONES, prevZone);
+  return LED_ZONES[prevZone];
+}
+
+// Rounds are pipelined: everything the next round shows besides its card
+// (round counter, progress, hint, the scan bar gone) goes up during the
+// pause that ends the feedback (or the countdown), and the LED is picked
+// then. beginRound() only swaps the card and starts the stimulus.
+static void prepareRound() {
+  nextReady = false;
+  applyLevel();
+  int next = roundNum + 1;
+  if(next > roundsTotal) return;       // the end screen follows
+
+  nextLed = pickNextLed();
+  uiStatusRight(next, roundsTotal, score);
+  uiProgress(next, roundsTotal);
+  Render_call<paintClearScanBar>();
+  uiHint("Remember the peg position");
+  nextReady = true;
+}
+
+// LED ack on the peg, result card, short pause; then the next round
+static bool resultStep() {
+  static int f;
+  CO_BEGIN(flowTask);
+
+  Leds_clear();
+  Leds_set(currentLed, (resultCorrect && !resultTimeout) ? strip.Color(0, 180, 0) : strip.Color(180, 0, 0));
+  Leds_show();
+  CO_SLEEP(flowTask, 40);
+  ledsOff();
+
+  if(!resultTimeout) uiStatusRight(roundNum, roundsTotal, score);
+
+  if(resultCorrect && !resultTimeout) {
     uiCenterCard("NICE!", C_OK);
-    flashAll(strip.Color(0,180,0), 2);
+    for(f=0; f<2; f++){
+      fillAll(strip.Color(0,180,0));
+      CO_SLEEP(flowTask, 120);
+      ledsOff();
+      CO_SLEEP(flowTask, 80);
+    }
   } else {
-    uiCenterCard("ALMOST!", C_BAD);
-    flashAll(strip.Color(180,0,0), 1, 200, 120);
+    uiCenterCard(resultTimeout ? "TIME UP" : "ALMOST!", C_BAD);
+    fillAll(strip.Color(180,0,0));
+    CO_SLEEP(flowTask, 200);
+    ledsOff();
+    CO_SLEEP(flowTask, 120);
   }
-  delay(260);
+  prepareRound();
+  CO_SLEEP(flowTask, 260);
+
+  CO_END(flowTask);
+}
+
+static void showResult(bool correct, bool timeout) {
+  resultCorrect = correct;
+  resultTimeout = timeout;
+  CO_RESET(flowTask);
+  phase = PHASE_RESULT;
+}
+
+static void finishSession() {
+  RtSummary s;
+  RtStats_endSession(s);
+  s.score = score;
+  s.coins = coinsEarned;
+  reportScore(coinsEarned, score);
+  reportSession(s);
 }
 
 static void beginRound() {
-  applyLevel();
+  if(!nextReady) prepareRound();
 
   roundNum++;
   if(roundNum > roundsTotal) {
     state = DONE;
     drawEndScreen();
+    finishSession();
     return;
   }
 
-  currentLed = pickNextLed();
-
-  drawBackground();
-  uiTopBar((level==LEVEL_1) ? "WARM-UP MODE" : "HOT MODE");
-  uiStatusRight(roundNum, roundsTotal, score);
-  uiProgress(roundNum, roundsTotal);
-
-  clearCenterArea();
+  nextReady = false;
+  currentLed = nextLed;
 
   phase = PHASE_REMEMBER;
   uiCenterCard("WATCH", C_WARN);
-  uiHint("Remember the peg position");
 
-  lightOnly(currentLed);
-  uint32_t watchStart = millis();
-  while (millis() - watchStart < ledOnMs) delay(5);
-  ledsOff();
+  // exposure is timed by esp_timer; Game1_update() moves on once it is over
+  Stimulus_clear();
+  Stimulus_add(currentLed, strip.Color(255,255,255), ledOnMs, 0);
+  Stimulus_start();
+}
+
+static void beginScan() {
+  stimOnsetUs = Stimulus_step(0).onsetUs;
 
   clearCenterArea();
 
@@ -604,7 +668,7 @@ static void beginRound() {
   uiHint("Scan the matching RFID peg");
 
   scanStartMs = millis();
-  lastCountdownDrawMs = 0;
+  Progress_begin(scanBar, 30, 200, 260, 12, 6, C_PANEL2);
 }
 
 static void startGameWithCountdown() {
@@ -613,43 +677,66 @@ static void startGameWithCountdown() {
   score = 0;
   coinsEarned = 0;
   phase = PHASE_IDLE;
-  prevLed = 255;
+  prevZone = -1;
+  nextReady = false;
   endCelebrated = false;
+  Rng_beginSession();
+  RtStats_beginSession(RT_FOLLOW, (level == LEVEL_2) ? 1 : 0);
+
+  CO_RESET(flowTask);
+  state = COUNTDOWN;
+}
+
+static void paintCountdownDigit(const StatusCmd& c) {
+  tft.fillRoundRect(60, 102, 200, 78, 18, C_PANEL2);
+  tft.drawRoundRect(60, 102, 200, 78, 18, TFT_WHITE);
+
+  TextBuf<8> t;
+  LabelCache_draw(t.set(c.r), 160, 140, MC_DATUM, 8, TFT_WHITE, C_PANEL2);
+  tft.setTextDatum(TL_DATUM);
+}
+static void uiCountdownDigit(int n) {
+  StatusCmd c = { (int16_t)n, 0, 0 };
+  Render_post<StatusCmd, paintCountdownDigit>(RK_CARD, c);
+}
+
+static bool countdownStep() {
+  static int n, f;
+  CO_BEGIN(flowTask);
 
   drawBackground();
   uiTopBar((level==LEVEL_1) ? "WARM-UP MODE" : "HOT MODE");
   uiHint("Starting...");
 
-  for(int n=3; n>=1; n--){
+  for(n=3; n>=1; n--){
     clearCenterArea();
-    tft.fillRoundRect(60, 102, 200, 78, 18, C_PANEL2);
-    tft.drawRoundRect(60, 102, 200, 78, 18, TFT_WHITE);
-
-    tft.setTextDatum(MC_DATUM);
-    tft.setTextFont(8);
-    tft.setTextColor(TFT_WHITE, C_PANEL2);
-    tft.drawString(String(n), 160, 140);
-    tft.setTextDatum(TL_DATUM);
+    uiCountdownDigit(n);
 
-    flashAll(strip.Color(0,120,180), 1, 60, 60);
-    delay(650);
+    fillAll(strip.Color(0,120,180));
+    CO_SLEEP(flowTask, 60);
+    ledsOff();
+    CO_SLEEP(flowTask, 60 + 650);
   }
 
+  // GO! gets the screen the rounds are played on, so the first round
+  // needs no full repaint either
+  Render_call<paintCountdownEdge>();
   clearCenterArea();
   uiCenterCard("GO!", C_OK);
-  flashAll(strip.Color(0,180,0), 2, 70, 60);
-  delay(220);
+  for(f=0; f<2; f++){
+    fillAll(strip.Color(0,180,0));
+    CO_SLEEP(flowTask, 70);
+    ledsOff();
+    CO_SLEEP(flowTask, 60);
+  }
+  prepareRound();
+  CO_SLEEP(flowTask, 220);
 
-  state = PLAYING;
-  beginRound();
+  CO_END(flowTask);
 }
 
 // ---------------- public API ----------------
 void Game1_begin() {
-  initPN532WithFallback();
-  lastRFIDSeenOkMs = millis();
-  lastSAMRearmMs = millis();
-
   level = NONE;
   state = PICK_LEVEL;
   phase = PHASE_IDLE;
@@ -661,10 +748,14 @@ void Game1_begin() {
 void Game1_update() {
   int sx, sy;
 
+  // one read per pass: a press is reported once, so BACK and the level
+  // buttons have to look at the same one
+  bool touched = (state == PICK_LEVEL) && Touch_pressed(sx, sy);
+
   // BACK only on LEVEL PICK screen
-  if (state == PICK_LEVEL && Touch_pressed(sx, sy)) {
+  if (touched) {
     if (hitEitherXPad(sx, sy, BTN_BACK_X, BTN_BACK_Y, BTN_BACK_W, BTN_BACK_H, 10)) {
-      waitTouchRelease();
+      Touch_waitRelease();
       ledsOff();
       g_screen = SCR_MENU;
       drawMenu();
@@ -674,71 +765,62 @@ void Game1_update() {
 
   // PICK LEVEL
   if(state == PICK_LEVEL) {
-    if(Touch_pressed(sx, sy)) {
+    if(touched) {
       if(hitEitherXPad(sx,sy, BTN_X,BTN_WARM_Y,BTN_W,BTN_H, 14)) level = LEVEL_1;
       else if(hitEitherXPad(sx,sy, BTN_X,BTN_HOT_Y, BTN_W,BTN_H, 14)) level = LEVEL_2;
 
-      else { delay(10); return; }
+      else { Coop_pollIn(10); return; }
 
-      waitTouchRelease();
+      Touch_waitRelease();
       startGameWithCountdown();
     }
-    delay(10);
+    Coop_pollIn(10);
+    return;
+  }
+
+  // COUNTDOWN (wakes itself)
+  if(state == COUNTDOWN) {
+    if(countdownStep()) {
+      state = PLAYING;
+      beginRound();
+    }
     return;
   }
 
   // PLAYING
   if(state == PLAYING) {
+    if(phase == PHASE_REMEMBER && !Stimulus_running()) beginScan();
+
     if(phase == PHASE_SCAN) {
       uint8_t uid4[4];
-      if(readUID4(uid4)) {
-        lastRFIDSeenOkMs = millis();
+      if(Rfid_read(uid4, 50)) {
+        uint32_t tagUs = micros();
 
         const uint8_t* exp = expectedUID(currentLed);
         bool correct = (exp && uidEq(uid4, exp));
         if(correct) score += 10;
+        RtStats_response(currentLed, tagUs - stimOnsetUs, correct);
 
-        quickAck(correct);
-        uiStatusRight(roundNum, roundsTotal, score);
         showResult(correct, false);
+      } else {
+        uint32_t elapsed = millis() - scanStartMs;
+        uint32_t timeoutMs = (level == LEVEL_2) ? SCAN_TIMEOUT_L2_MS : SCAN_TIMEOUT_L1_MS;
 
-        nfc.SAMConfig();
-        lastSAMRearmMs = millis();
-
-        beginRound();
-        return;
-      }
-
-      uint32_t elapsed = millis() - scanStartMs;
-      uint32_t timeoutMs = (level == LEVEL_2) ? SCAN_TIMEOUT_L2_MS : SCAN_TIMEOUT_L1_MS;
-
-      if(lastCountdownDrawMs == 0 || millis() - lastCountdownDrawMs > 80) {
         uiScanCountdown(elapsed, timeoutMs);
-        lastCountdownDrawMs = millis();
-      }
 
-      if(elapsed > timeoutMs) {
-        quickAck(false);
-        showResult(false, true);
-        beginRound();
-        return;
+        if(elapsed > timeoutMs) {
+          RtStats_miss(currentLed);
+          showResult(false, true);
+        }
       }
     }
 
-    if(millis() - lastSAMRearmMs > 2500) {
-      nfc.SAMConfig();
-      lastSAMRearmMs = millis();
-    }
-
-    if(millis() - lastRFIDSeenOkMs > RFID_RECOVER_MS) {
-      uiHint("RFID reset...");
-      initPN532WithFallback();
-      lastRFIDSeenOkMs = millis();
-      lastSAMRearmMs = millis();
-      if(phase == PHASE_SCAN) uiHint("Scan the matching RFID peg");
+    if(phase == PHASE_RESULT && resultStep()) {
+      beginRound();
+      if(state != PLAYING) return;
     }
 
-    delay(2);
+    Coop_pollIn(2);
     return;
   }
 
@@ -748,7 +830,7 @@ if (state == DONE) {
 
     // PLAY AGAIN -> Game1 levels
     if (hitRectTouch(sx, sy, END_PLAY_X, END_PLAY_Y, END_PLAY_W, END_PLAY_H)) {
-      waitTouchRelease();
+      Touch_waitRelease();
       ledsOff();
       level = NONE;
       state = PICK_LEVEL;
@@ -760,19 +842,19 @@ if (state == DONE) {
 
     // GAMES MENU -> main games menu
     if (hitRectTouch(sx, sy, END_MENU_X, END_MENU_Y, END_MENU_W, END_MENU_H)) {
-      waitTouchRelease();
+      Touch_waitRelease();
       ledsOff();
       g_screen = SCR_MENU;
       drawMenu();
       return;
     }
   }
-  delay(10);
+  Coop_pollIn(10);
   return;
 }
 
 
 
 
-  delay(10);
+  Coop_pollIn(10);
 }
@@ -1,4 +1,16 @@
 #include "Shared.h"
+#include "Coop.h"
+#include "Render.h"
+#include "Stimulus.h"
+#include "RtStats.h"
+#include "Rfid.h"
+#include "Fmt.h"
+#include "ScreenCache.h"
+#include "DrawList.h"
+#include "Progress.h"
+#include "LabelCache.h"
+#include "Leds.h"
+#include "Rng.h"
 
 // must exist in your menu file
 void Menu_draw();
@@ -52,6 +64,9 @@ static int userIndex  = 0;
 
 static uint16_t showOnMs  = 520;
 static uint16_t showGapMs = 240;
+static uint32_t seqEndUs  = 0;   // micros() when the last LED latched off
+static uint32_t waitStartUs = 0; // reaction time runs from here
+static CoopTask flowTask;         // countdown / sequence playback
 
 static int noTagStreak = 0;
 static const int LIFT_STREAK_REQUIRED = 4;
@@ -65,8 +80,7 @@ static const int BAR_X = 40;
 static const int BAR_Y = 30;
 static const int BAR_W = 240;
 static const int BAR_H = 10;
-static uint32_t lastBarDrawMs = 0;
-static int lastBarFill = -1;
+static ProgressBar timeBar;
 
 static const int CARD_X = 30;
 static const int CARD_Y = 44;
@@ -102,47 +116,18 @@ static const int END_MENU_X = END_PLAY_X + END_BTN_W + END_GAP;
 
 // ===================== TOUCH HELPERS (robust if X mirrored) =====================
 
-static void waitTouchRelease() {
-  int tx, ty;
-  while (Touch_pressed(tx, ty)) delay(5);
-}
-
 // ===================== LED HELPERS =====================
-static void ledsOff(){ strip.clear(); strip.show(); }
-static void lightOne(uint8_t idx, uint32_t c){ strip.clear(); strip.setPixelColor(idx,c); strip.show(); }
-static void fillAll(uint32_t c){ for(int i=0;i<LED_COUNT;i++) strip.setPixelColor(i,c); strip.show(); }
-static void flashAll(uint32_t c, int times, int onMs=120, int offMs=80){
-  for(int t=0;t<times;t++){ fillAll(c); delay(onMs); ledsOff(); delay(offMs); }
-}
+static void ledsOff(){ Leds_clear(); Leds_show(); }
+static void lightOne(uint8_t idx, uint32_t c){ Leds_clear(); Leds_set(idx,c); Leds_show(); }
+static void fillAll(uint32_t c){ Leds_fill(c); Leds_show(); }
 
 // ===================== RFID HELPERS =====================
-static bool readUID4(uint8_t out[4]) {
-  uint8_t uid[7], len;
-  if(!nfc.readPassiveTargetID(PN532_MIFARE_ISO14443A, uid, &len, 40)) return false;
-  if(len < 4) return false;
-  for(int i=0;i<4;i++) out[i]=uid[i];
-  return true;
-}
 static const uint8_t* expectedUIDForLed(uint8_t led){
   for(int i=0;i<MAP_LEN;i++) if(MAP[i].led == led) return MAP[i].uid;
   return nullptr;
 }
 static bool uidEq(const uint8_t*a,const uint8_t*b){ for(int i=0;i<4;i++) if(a[i]!=b[i]) return false; return true; }
 
-static bool initPN532Once() {
-  nfc.begin();
-  delay(30);
-  uint32_t v = nfc.getFirmwareVersion();
-  if(!v) return false;
-  nfc.SAMConfig();
-  return true;
-}
-static bool initPN532WithFallback() {
-  Wire.setClock(100000);
-  Wire.setTimeOut(50);
-  return initPN532Once();
-}
-static void kickPN532(){ nfc.SAMConfig(); }
 
 // ===================== UI HELPERS =====================
 static uint16_t blend565(uint16_t c1, uint16_t c2, uint8_t t) {
@@ -152,17 +137,16 @@ static uint16_t blend565(uint16_t c1, uint16_t c2, uint8_t t) {
   return (r<<11)|(g<<5)|b;
 }
 static void fillGradV(int x,int y,int w,int h,uint16_t top,uint16_t bot,int step=2){
-  for(int i=0;i<h;i+=step){ uint8_t t=(uint32_t)i*255/(h-1); uint16_t c=blend565(top,bot,t); tft.fillRect(x,y+i,w,step,c); }
+  for(int i=0;i<h;i+=step){ uint8_t t=(uint32_t)i*255/(h-1); uint16_t c=blend565(top,bot,t); tft.fillRect(x,y+i,w,step,c); SpiBus_yield(SPI_DEV_TFT); }
 }
-static void drawBackground(){ fillGradV(0,0,SCREEN_W,SCREEN_H,C_BG,0x0008,2); for(int i=0;i<18;i++) tft.drawPixel(random(0,SCREEN_W), random(0,SCREEN_H), TFT_WHITE); }
+// screens draw inline under a RenderDirect; the timeout bar is posted
+static void drawBackground(){ RenderDirect rd; fillGradV(0,0,SCREEN_W,SCREEN_H,C_BG,0x0008,2); for(int i=0;i<18;i++) tft.drawPixel(Rng_decor(0,SCREEN_W), Rng_decor(0,SCREEN_H), TFT_WHITE); }
 
 static void drawBackButton(){
+  RenderDirect rd;
   tft.fillRoundRect(BTN_BACK_X, BTN_BACK_Y, BTN_BACK_W, BTN_BACK_H, 8, C_PANEL2);
   tft.drawRoundRect(BTN_BACK_X, BTN_BACK_Y, BTN_BACK_W, BTN_BACK_H, 8, TFT_WHITE);
-  tft.setTextDatum(MC_DATUM);
-  tft.setTextFont(2);
-  tft.setTextColor(TFT_WHITE, C_PANEL2);
-  tft.drawString("< Back", BTN_BACK_X + BTN_BACK_W/2, BTN_BACK_Y + BTN_BACK_H/2);
+  LabelCache_draw("< Back", BTN_BACK_X + BTN_BACK_W/2, BTN_BACK_Y + BTN_BACK_H/2, MC_DATUM, 2, TFT_WHITE, C_PANEL2);
   tft.setTextDatum(TL_DATUM);
 }
 #define TOUCH_MIRROR_X 1
@@ -195,39 +179,39 @@ static void goMenu(){
 
 
 static void drawTopTitle(const char* title){
-  tft.setTextDatum(MC_DATUM);
-  tft.setTextFont(2);
-  tft.setTextColor(C_MUTED, TFT_BLACK);
-  tft.drawString(title, 160, 18);
+  RenderDirect rd;
+  LabelCache_draw(title, 160, 18, MC_DATUM, 2, C_MUTED, TFT_BLACK);
   tft.setTextDatum(TL_DATUM);
 }
 
-static void uiButton(int x,int y,int w,int h,uint16_t bg,const char* label){
-  tft.fillRoundRect(x+3,y+3,w,h,16,TFT_BLACK);
-  tft.fillRoundRect(x,y,w,h,16,bg);
-  tft.drawRoundRect(x,y,w,h,16,TFT_WHITE);
-  tft.setTextDatum(MC_DATUM);
+static void uiButton(DrawList& dl,int x,int y,int w,int h,uint16_t bg,const char* label){
+  dl.fillRoundRect(x+3,y+3,w,h,16,TFT_BLACK);
+  dl.fillRoundRect(x,y,w,h,16,bg);
+  dl.drawRoundRect(x,y,w,h,16,TFT_WHITE);
+  dl.setTextDatum(MC_DATUM);
   // shrink font for narrow buttons (like Game1)
-  if(w <= 140) tft.setTextFont(2);
-  else         tft.setTextFont(4);
-  tft.setTextColor(TFT_BLACK, bg);
-  tft.drawString(label, x+w/2+1, y+h/2+1);
-  tft.setTextColor(TFT_WHITE, bg);
-  tft.drawString(label, x+w/2, y+h/2);
-  tft.setTextDatum(TL_DATUM);
+  if(w <= 140) dl.setTextFont(2);
+  else         dl.setTextFont(4);
+  dl.setTextColor(TFT_BLACK, bg);
+  dl.drawString(label, x+w/2+1, y+h/2+1);
+  dl.setTextColor(TFT_WHITE, bg);
+  dl.drawString(label, x+w/2, y+h/2);
+  dl.setTextDatum(TL_DATUM);
+}
+
+static void uiButton(int x,int y,int w,int h,uint16_t bg,const char* label){
+  DrawList dl;
+  uiButton(dl,x,y,w,h,bg,label);
+  DrawList_run(dl);
 }
 
 static void drawCenterCard(const char* top, const char* bottom){
+  RenderDirect rd;
   tft.fillRoundRect(CARD_X+3, CARD_Y+3, CARD_W, CARD_H, 14, TFT_BLACK);
   tft.fillRoundRect(CARD_X,   CARD_Y,   CARD_W, CARD_H, 14, C_PANEL2);
   tft.drawRoundRect(CARD_X,   CARD_Y,   CARD_W, CARD_H, 14, TFT_WHITE);
-  tft.setTextDatum(MC_DATUM);
-  tft.setTextFont(2);
-  tft.setTextColor(C_ACCENT, C_PANEL2);
-  tft.drawString(top, 160, CARD_Y + 14);
-  tft.setTextFont(1);
-  tft.setTextColor(TFT_WHITE, C_PANEL2);
-  tft.drawString(bottom, 160, CARD_Y + 28);
+  LabelCache_draw(top, 160, CARD_Y + 14, MC_DATUM, 2, C_ACCENT, C_PANEL2);
+  LabelCache_draw(bottom, 160, CARD_Y + 28, MC_DATUM, 1, TFT_WHITE, C_PANEL2);
   tft.setTextDatum(TL_DATUM);
 }
 
@@ -240,39 +224,34 @@ static uint32_t inputTimeoutMs(){
 static void resetInputTimer(){ lastUserActionMs = millis(); }
 
 static void drawTimeoutBarFrame(){
-  tft.drawRoundRect(BAR_X, BAR_Y, BAR_W, BAR_H, 4, TFT_WHITE);
-  tft.fillRoundRect(BAR_X+1, BAR_Y+1, BAR_W-2, BAR_H-2, 3, TFT_BLACK);
-  lastBarFill = -1;
-  lastBarDrawMs = 0;
+  {
+    RenderDirect rd;
+    tft.drawRoundRect(BAR_X, BAR_Y, BAR_W, BAR_H, 4, TFT_WHITE);
+    tft.fillRoundRect(BAR_X+1, BAR_Y+1, BAR_W-2, BAR_H-2, 3, TFT_BLACK);
+  }
+  Progress_begin(timeBar, BAR_X+1, BAR_Y+1, BAR_W-2, BAR_H-2, 3, TFT_BLACK);
 }
+
 static void updateTimeoutBar(){
   if(state != ST_INPUT_SEQ) return;
-  if(millis() - lastBarDrawMs < 120) return;
-  lastBarDrawMs = millis();
-
   uint32_t tmo = inputTimeoutMs();
   uint32_t elapsed = millis() - lastUserActionMs;
   if(elapsed > tmo) elapsed = tmo;
-
-  int fillPx = (int)((uint32_t)(BAR_W-2) * (tmo - elapsed) / tmo);
-  if(fillPx == lastBarFill) return;
-  lastBarFill = fillPx;
-
-  tft.fillRoundRect(BAR_X+1, BAR_Y+1, BAR_W-2, BAR_H-2, 3, TFT_BLACK);
-  if(fillPx > 0) tft.fillRoundRect(BAR_X+1, BAR_Y+1, fillPx, BAR_H-2, 3, C_ACCENT);
+  Progress_set(timeBar, tmo - elapsed, tmo, C_ACCENT);
 }
 
 // ===================== SCREENS =====================
-static void drawRfidRetryScreen(){
-  ledsOff(); drawBackground();
+static void paintRfidRetryScreen(){
+  drawBackground();
   drawTopTitle("Memory Sequence");
   drawCenterCard("RFID ERROR", "Tap RETRY to reconnect");
   uiButton(BTN_RETRY_X, BTN_RETRY_Y, BTN_RETRY_W, BTN_RETRY_H, C_WARN, "RETRY");
   drawBackButton();
 }
+static void drawRfidRetryScreen(){ ledsOff(); ScreenCache_draw(SCREEN_G2_RETRY, paintRfidRetryScreen); }
 
-static void drawLevelScreen(){
-  ledsOff(); drawBackground();
+static void paintLevelScreen(){
+  drawBackground();
   drawTopTitle("Memory Sequence");
   drawCenterCard("Choose Difficulty", "Tap to start");
   uiButton(BTN_X, BTN_EASY_Y, BTN_W, BTN_H, C_OK,   "EASY");
@@ -280,6 +259,7 @@ static void drawLevelScreen(){
   uiButton(BTN_X, BTN_HARD_Y, BTN_W, BTN_H, C_BAD,  "HARD");
   drawBackButton();
 }
+static void drawLevelScreen(){ ledsOff(); ScreenCache_draw(SCREEN_G2_LEVEL, paintLevelScreen); }
 
 static void drawRepeatScreen(){
   drawBackground();
@@ -289,27 +269,19 @@ static void drawRepeatScreen(){
 }
 
 static void drawDoneScreen(bool win, bool timedOut=false){
+  RenderDirect rd;
   ledsOff(); drawBackground();
 
-  tft.setTextDatum(MC_DATUM);
-  tft.setTextFont(2);
-  tft.setTextColor(C_MUTED, TFT_BLACK);
-  tft.drawString("Session finished", 160, 18);
+  LabelCache_draw("Session finished", 160, 18, MC_DATUM, 2, C_MUTED, TFT_BLACK);
 
   int cardX = 24, cardY = 44, cardW = 272, cardH = 78;
   tft.fillRoundRect(cardX+3, cardY+3, cardW, cardH, 16, TFT_BLACK);
   tft.fillRoundRect(cardX,   cardY,   cardW, cardH, 16, C_PANEL2);
   tft.drawRoundRect(cardX,   cardY,   cardW, cardH, 16, TFT_WHITE);
 
-  tft.setTextFont(4);
-  tft.setTextColor(C_ACCENT, C_PANEL2);
-  tft.drawString(win ? "NICE!" : (timedOut ? "TIME!" : "OOPS!"), 160, cardY + 18);
-
-  tft.setTextFont(2);
-  tft.setTextColor(TFT_WHITE, C_PANEL2);
-  if(win) tft.drawString("Sequence completed!", 160, cardY + 52);
-  else if(timedOut) tft.drawString("No scan in time", 160, cardY + 52);
-  else tft.drawString("Wrong tag scanned", 160, cardY + 52);
+  LabelCache_draw(win ? "NICE!" : (timedOut ? "TIME!" : "OOPS!"), 160, cardY + 18, MC_DATUM, 4, C_ACCENT, C_PANEL2);
+  LabelCache_draw(win ? "Sequence completed!" : (timedOut ? "No scan in time" : "Wrong tag scanned"),
+                  160, cardY + 52, MC_DATUM, 2, TFT_WHITE, C_PANEL2);
 
   // score + coins pill (like Game1 style)
   int pillX = 52, pillY = cardY + cardH + 10, pillW = 216, pillH = 26;
@@ -318,25 +290,26 @@ static void drawDoneScreen(bool win, bool timedOut=false){
 
   tft.setTextFont(2);
   tft.setTextColor(TFT_WHITE, 0x0841);
-  tft.drawString(String("Score ") + score + "   + " + coins + " Coins", 160, pillY + pillH/2);
-
-  // Buttons
-  uiButton(END_PLAY_X, END_BTN_Y, END_BTN_W, END_BTN_H, C_ACCENT, "PLAY AGAIN");
-  uiButton(END_MENU_X, END_BTN_Y, END_BTN_W, END_BTN_H, C_WARN,   "GAMES MENU");
+  TextBuf<40> t;
+  tft.drawString(t.set("Score ", score, "   + ", coins, " Coins"), 160, pillY + pillH/2);
+
+  // Buttons, recorded once
+  static DrawList endButtons;
+  if(endButtons.empty()){
+    uiButton(endButtons, END_PLAY_X, END_BTN_Y, END_BTN_W, END_BTN_H, C_ACCENT, "PLAY AGAIN");
+    uiButton(endButtons, END_MENU_X, END_BTN_Y, END_BTN_W, END_BTN_H, C_WARN,   "GAMES MENU");
+  }
+  DrawList_run(endButtons);
 
   
   tft.setTextDatum(TL_DATUM);
 }
 
 // ===================== GAME LOGIC =====================
-static uint8_t pickZoneNotSame(uint8_t prev){
-  uint8_t led;
-  do { led = LED_ZONES[random(NUM_ZONES)]; } while(led == prev && NUM_ZONES > 1);
-  return led;
-}
+// no zone twice in a row: each step is one draw among the other zones
 static void generateSequence(int len){
-  uint8_t prev = 255;
-  for(int i=0;i<len;i++){ sequence[i] = pickZoneNotSame(prev); prev = sequence[i]; }
+  int16_t prev = -1;
+  for(int i=0;i<len;i++){ prev = Rng_indexOther(NUM_ZONES, prev); sequence[i] = LED_ZONES[prev]; }
 }
 static void applyLevelSettings(){
   if(level == LV_EASY){ seqBaseLen=3; showOnMs=540; showGapMs=250; }
@@ -352,50 +325,60 @@ static void startNewRound(){
   resetInputTimer();
 }
 
-static void doCountdown(){
+static void drawCountdownDigit(int n){
+  RenderDirect rd;
+  int x=70,y=96,w=180,h=84;
+  tft.fillRoundRect(x+3,y+3,w,h,16,TFT_BLACK);
+  tft.fillRoundRect(x,y,w,h,16,C_PANEL2);
+  tft.drawRoundRect(x,y,w,h,16,TFT_WHITE);
+  TextBuf<12> t;
+  LabelCache_draw(t.set(n), 160, 138, MC_DATUM, 8, TFT_WHITE, C_PANEL2);
+  tft.setTextDatum(TL_DATUM);
+}
+
+static bool countdownStep(){
+  static int n;
+  CO_BEGIN(flowTask);
+
   drawBackground(); drawTopTitle("Get ready");
   drawCenterCard("STARTING", "Watch closely...");
   drawBackButton();
 
-  for(int n=3;n>=1;n--){
-    int x=70,y=96,w=180,h=84;
-    tft.fillRoundRect(x+3,y+3,w,h,16,TFT_BLACK);
-    tft.fillRoundRect(x,y,w,h,16,C_PANEL2);
-    tft.drawRoundRect(x,y,w,h,16,TFT_WHITE);
-    tft.setTextDatum(MC_DATUM);
-    tft.setTextFont(8);
-    tft.setTextColor(TFT_WHITE, C_PANEL2);
-    tft.drawString(String(n), 160, 138);
-    tft.setTextDatum(TL_DATUM);
-    flashAll(strip.Color(0,120,180), 1, 70, 70);
-    delay(650);
-
-    drawBackground(); drawTopTitle("Get ready");
-    drawCenterCard("STARTING", "Watch closely...");
-    drawBackButton();
+  // each digit card covers the last one; after "1" the sequence screen
+  // replaces the countdown directly
+  for(n=3;n>=1;n--){
+    drawCountdownDigit(n);
+    fillAll(strip.Color(0,120,180));
+    CO_SLEEP(flowTask, 70);
+    ledsOff();
+    CO_SLEEP(flowTask, 70 + 650);
   }
-  state = ST_SHOW_SEQ;
+
+  CO_END(flowTask);
 }
 
-static void showSequence(){
+// true once the sequence has played and the input screen is up
+static bool showSequenceStep(){
+  CO_BEGIN(flowTask);
+
   drawBackground(); drawTopTitle("Watch the sequence");
   drawCenterCard("WATCH", "Then repeat with RFID");
   drawBackButton();
-  delay(300);
 
-  for(int i=0;i<seqLen;i++){
-    uint8_t led = sequence[i];
-    uint32_t c  = SEQ_COLORS[i % 3];
-    lightOne(led, c); delay(showOnMs);
-    ledsOff(); delay(showGapMs);
-  }
+  // first LED 300 ms after the card is up; the timer owns the strip until done
+  Stimulus_clear();
+  for(int i=0;i<seqLen;i++) Stimulus_add(sequence[i], SEQ_COLORS[i % 3], showOnMs, showGapMs);
+  Stimulus_start(300000UL);
+  CO_WAIT_UNTIL(flowTask, !Stimulus_running());
+  seqEndUs = Stimulus_step(seqLen-1).offsetUs;
+  waitStartUs = seqEndUs;
 
   userIndex=0; inputPhase=WAIT_FOR_TAG; noTagStreak=0;
   drawRepeatScreen();
   drawTimeoutBarFrame();
-  state = ST_INPUT_SEQ;
-  kickPN532();
   resetInputTimer();
+
+  CO_END(flowTask);
 }
 
 static int pointsPerStep(){ if(level==LV_EASY) return 1; if(level==LV_MEDIUM) return 2; return 3; }
@@ -403,42 +386,54 @@ static int winBonus(){ if(level==LV_EASY) return 5; if(level==LV_MEDIUM) return
 static int coinsReward(){ if(level==LV_EASY) return 1; if(level==LV_MEDIUM) return 2; return 3; }
 
 static void feedbackForStep(bool ok, uint8_t led){
-  if(ok){ lightOne(led, strip.Color(0,180,0)); delay(160); ledsOff(); }
-  else { fillAll(strip.Color(180,0,0)); delay(450); ledsOff(); }
+  if(ok){ lightOne(led, strip.Color(0,180,0)); Leds_hold(160); ledsOff(); }
+  else { fillAll(strip.Color(180,0,0)); Leds_hold(450); ledsOff(); }
+}
+
+static void finishSession(){
+  RtSummary s;
+  RtStats_endSession(s);
+  s.score = score;
+  s.coins = coins;
+  reportScore(coins, score);
+  reportSession(s);
 }
 
 static void handleInputSequence(){
   if(millis() - lastUserActionMs > inputTimeoutMs()){
-    fillAll(strip.Color(180,0,0)); delay(450); ledsOff();
-    state = ST_DONE; drawDoneScreen(false, true); return;
+    RtStats_miss(sequence[userIndex]);
+    fillAll(strip.Color(180,0,0)); Leds_hold(450); ledsOff();
+    state = ST_DONE; drawDoneScreen(false, true); finishSession(); return;
   }
 
   uint8_t uid4[4];
-  bool tagPresent = readUID4(uid4);
+  bool tagPresent = Rfid_read(uid4, 40);
 
   if(inputPhase == WAIT_FOR_TAG){
     if(!tagPresent) return;
+    uint32_t tagUs = micros();
     resetInputTimer();
 
     uint8_t expectedLed = sequence[userIndex];
     const uint8_t* expUid = expectedUIDForLed(expectedLed);
     bool correct = (expUid && uidEq(uid4, expUid));
+    RtStats_response(expectedLed, tagUs - waitStartUs, correct);
 
     feedbackForStep(correct, expectedLed);
 
     inputPhase = WAIT_FOR_LIFT;
     noTagStreak = 0;
 
-    if(!correct){ state = ST_DONE; drawDoneScreen(false,false); return; }
+    if(!correct){ state = ST_DONE; drawDoneScreen(false,false); finishSession(); return; }
 
     score += pointsPerStep();
     userIndex++;
 
     if(userIndex >= seqLen){
-      fillAll(strip.Color(0,180,0)); delay(450); ledsOff();
+      fillAll(strip.Color(0,180,0)); Leds_hold(450); ledsOff();
       score += winBonus();
       coins += coinsReward();
-      state = ST_DONE; drawDoneScreen(true,false); return;
+      state = ST_DONE; drawDoneScreen(true,false); finishSession(); return;
     }
     return;
   }
@@ -448,7 +443,7 @@ static void handleInputSequence(){
   if(noTagStreak >= LIFT_STREAK_REQUIRED){
     inputPhase = WAIT_FOR_TAG;
     noTagStreak = 0;
-    kickPN532();
+    waitStartUs = micros();
   }
 }
 
@@ -458,7 +453,7 @@ void Game2_begin(){
   SEQ_COLORS[1] = strip.Color(0, 120, 255);
   SEQ_COLORS[2] = strip.Color(220, 170, 0);
 
-  if(initPN532WithFallback()){
+  if(Rfid_ready()){
     state = ST_PICK_LEVEL;
     drawLevelScreen();
   } else {
@@ -472,9 +467,15 @@ void Game2_update(){
 
   // BACK for all screens
  // BACK button — disabled on DONE screen
-if(state != ST_DONE && Touch_pressed(sx, sy)){
+// one read per pass: a press is reported once, so BACK and the screen's
+// own buttons have to look at the same one
+bool touched = (state != ST_DONE) && Touch_pressed(sx, sy);
+if(touched){
   if(backTapped(sx, sy)){
-    waitTouchRelease();
+    Touch_waitRelease();
+    Stimulus_stop();
+    CO_RESET(flowTask);
+    ledsOff();
     goMenu();
     return;
   }
@@ -482,41 +483,53 @@ if(state != ST_DONE && Touch_pressed(sx, sy)){
 
 
   if(state == ST_RFID_RETRY){
-    if(Touch_pressed(sx, sy)){
+    if(touched){
       if(hitRectMapped(sx,sy, BTN_RETRY_X,BTN_RETRY_Y,BTN_RETRY_W,BTN_RETRY_H)){
-        waitTouchRelease();
+        Touch_waitRelease();
         drawCenterCard("RETRYING...", "Please wait");
-        if(initPN532WithFallback()){ state = ST_PICK_LEVEL; drawLevelScreen(); }
+        if(Rfid_recoverNow()){ state = ST_PICK_LEVEL; drawLevelScreen(); }
         else drawRfidRetryScreen();
       }
     }
-    delay(20); return;
+    Coop_pollIn(20); return;
   }
 
   if(state == ST_PICK_LEVEL){
-    if(Touch_pressed(sx, sy)){
+    if(touched){
       if(hitRectMapped(sx,sy, BTN_X,BTN_EASY_Y,BTN_W,BTN_H)) level = LV_EASY;
       else if(hitRectMapped(sx,sy, BTN_X,BTN_MED_Y,BTN_W,BTN_H)) level = LV_MEDIUM;
       else if(hitRectMapped(sx,sy, BTN_X,BTN_HARD_Y,BTN_W,BTN_H)) level = LV_HARD;
-      else { delay(10); return; }
+      else { Coop_pollIn(10); return; }
 
-      waitTouchRelease();
+      Touch_waitRelease();
       applyLevelSettings();
+      Rng_beginSession();
+      RtStats_beginSession(RT_SEQUENCE, level - LV_EASY);
       score = 0;
       coins = 0; // if you want TOTAL across sessions, remove this line
       startNewRound();
+      CO_RESET(flowTask);
       state = ST_COUNTDOWN;
-      doCountdown();
     }
-    delay(10); return;
+    Coop_pollIn(10); return;
   }
 
-  if(state == ST_SHOW_SEQ){ showSequence(); delay(10); return; }
+  // countdown and playback wake themselves
+  if(state == ST_COUNTDOWN){
+    if(!countdownStep()) return;
+    state = ST_SHOW_SEQ;
+    Coop_pollIn(10); return;
+  }
+
+  if(state == ST_SHOW_SEQ){
+    if(showSequenceStep()) state = ST_INPUT_SEQ;
+    else { Coop_pollIn(10); return; }
+  }
 
   if(state == ST_INPUT_SEQ){
     updateTimeoutBar();
     handleInputSequence();
-    delay(5); return;
+    Coop_pollIn(5); return;
   }
 
  if(state == ST_DONE){
@@ -524,7 +537,7 @@ if(state != ST_DONE && Touch_pressed(sx, sy)){
 
     // PLAY AGAIN (left)
     if(hitRectMapped(sx, sy, END_PLAY_X, END_BTN_Y, END_BTN_W, END_BTN_H)){
-      waitTouchRelease();
+      Touch_waitRelease();
       level = LV_NONE;
       state = ST_PICK_LEVEL;
       drawLevelScreen();
@@ -533,20 +546,20 @@ if(state != ST_DONE && Touch_pressed(sx, sy)){
 
     // GAMES MENU (right)
     if(hitRectMapped(sx, sy, END_MENU_X, END_BTN_Y, END_BTN_W, END_BTN_H)){
-      waitTouchRelease();
+      Touch_waitRelease();
       goMenu();
       return;
     }
 
     // touched somewhere else
-    waitTouchRelease();
+    Touch_waitRelease();
   }
-  delay(20);
+  Coop_pollIn(20);
   return;
 }
 
 
 
 
-  delay(10);
+  Coop_pollIn(10);
 }
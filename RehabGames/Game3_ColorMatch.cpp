@@ -1,4 +1,15 @@
 #include "Game3_ColorMatch.h"
+#include "Coop.h"
+#include "Render.h"
+#include "RtStats.h"
+#include "Rfid.h"
+#include "Fmt.h"
+#include "ScreenCache.h"
+#include "DrawList.h"
+#include "Progress.h"
+#include "LabelCache.h"
+#include "Leds.h"
+#include "Rng.h"
 #include <string.h>
 
 // ============================================================
@@ -52,11 +63,11 @@ static const int PALETTE_LEN = sizeof(PALETTE) / sizeof(PALETTE[0]);
 // ---------------- GAME STATE ----------------
 enum Level { LV_NONE, LV_EASY, LV_MEDIUM, LV_HARD };
 enum State { ST_RFID_RETRY, ST_PICK_LEVEL, ST_COUNTDOWN, ST_SHOW_BOARD, ST_PLAY, ST_DONE };
-enum InputPhase { WAIT_FOR_TAG, WAIT_FOR_LIFT };
 
 static Level level = LV_NONE;
 static State state = ST_RFID_RETRY;
-static InputPhase inputPhase = WAIT_FOR_TAG;
+static uint32_t waitStartUs = 0;   // reaction time runs from here
+static CoopTask flowTask;          // countdown
 
 static int score = 0;
 static int coinsTotal = 0;     // total over device run
@@ -112,14 +123,7 @@ static const int BAR_X = 40;
 static const int BAR_Y = 30;
 static const int BAR_W = 240;
 static const int BAR_H = 10;
-static uint32_t lastBarDrawMs = 0;
-static int lastBarFill = -1;
-
-// --------- RFID watchdog ----------
-static uint32_t lastRFIDOkMs = 0;
-static uint32_t lastRecoverMs = 0;
-static const uint32_t RFID_STUCK_MS = 2500;
-static const uint32_t RECOVER_COOLDOWN_MS = 1200;
+static ProgressBar timeBar;
 
 // --------- Coins breakdown (per round) ----------
 static int coinsRound = 0;
@@ -137,19 +141,34 @@ static uint8_t colorId[MAX_ACTIVE];
 static bool hasFirst = false;
 static int firstIdx = -1;
 
-// ---------- UID STABILITY FILTER ----------
-static uint8_t stableUid[4];
-static uint8_t stableCount = 0;
-static uint32_t lastUidMs = 0;
+// ---------- PEG TRACKING ----------
+// The reader lists up to two pegs per poll, so both pegs of a pair can go
+// down together. A peg counts once per placement: two polls in a row to
+// count, then ignored until it leaves the antenna. With two pegs down one
+// poll can come back with only one of them (their answers collided), so a
+// miss next to another peg needs confirming; an empty field is a lift.
+struct PegSlot {
+  bool     used;
+  bool     taken;       // already answered
+  uint8_t  uid[4];
+  uint8_t  hits;
+  uint8_t  misses;
+  int8_t   reader;      // the antenna that saw it (Rfid_readerForLed)
+  uint32_t firstUs;     // first sighting, for the reaction time
+};
+static const int PEG_SLOTS = NFC_MAX_TARGETS * 2;   // on the antenna + leaving
+static PegSlot pegSlot[PEG_SLOTS];
+static uint32_t lastScanMs = 0;
 static const uint32_t UID_STABLE_WINDOW = 120;
 static const uint8_t UID_REQUIRED_HITS = 2;
+static const uint8_t LIFT_MISSES = 2;
 
 // ---------------- helpers ----------------
-static void ledsOff() { strip.clear(); strip.show(); }
+static void ledsOff() { Leds_clear(); Leds_show(); }
 
 static void fillAll(uint32_t c) {
-  for(int i=0;i<LED_COUNT;i++) strip.setPixelColor(i, c);
-  strip.show();
+  Leds_fill(c);
+  Leds_show();
 }
 
 // ---- TOUCH ORIENTATION (Game3) ----
@@ -165,35 +184,23 @@ static bool hitRectMapped(int sx,int sy,int rx,int ry,int rw,int rh){
   return inRect(x, sy, rx, ry, rw, rh);
 }
 
-static void waitTouchRelease() {
-  int tx, ty;
-  while (Touch_pressed(tx, ty)) delay(5);
-}
-
 
 static void flashAll(uint32_t c, int times, int onMs=120, int offMs=80) {
   for(int t=0;t<times;t++){
-    fillAll(c); delay(onMs);
-    ledsOff();  delay(offMs);
+    Leds_fill(c);  Leds_hold(onMs);
+    Leds_clear();  Leds_hold(offMs);
   }
 }
 
 static void blinkLed(uint8_t led, uint32_t c, int times=1, int onMs=110, int offMs=70) {
   for(int t=0;t<times;t++){
-    strip.setPixelColor(led, c);
-    strip.show();
-    delay(onMs);
-    strip.setPixelColor(led, 0);
-    strip.show();
-    delay(offMs);
+    Leds_set(led, c);
+    Leds_hold(onMs);
+    Leds_set(led, 0);
+    Leds_hold(offMs);
   }
 }
 
-static bool ledInUse(uint8_t led, int n) {
-  for(int i=0;i<n;i++) if(activeLed[i]==led) return true;
-  return false;
-}
-
 // ---------------- RFID helpers ----------------
 static const uint8_t* expectedUIDForLed(uint8_t led){
   for(int i=0;i<MAP_LEN;i++) if(MAP[i].led == led) return MAP[i].uid;
@@ -205,65 +212,74 @@ static bool uidEq(const uint8_t*a,const uint8_t*b){
   return true;
 }
 
-static void kickPN532() { nfc.SAMConfig(); }
-
-static void recoverRFID() {
-  if (millis() - lastRecoverMs < RECOVER_COOLDOWN_MS) return;
-  lastRecoverMs = millis();
-
-  nfc.SAMConfig();
-  delay(10);
-
-  Wire.end();
-  delay(20);
-  Wire.begin(PN532_SDA, PN532_SCL);
-  Wire.setClock(100000);
-  Wire.setTimeOut(50);
-  delay(20);
-
-  nfc.begin();
-  delay(30);
-  nfc.getFirmwareVersion();
-  nfc.SAMConfig();
+static int findPegSlot(const uint8_t uid[4]) {
+  for(int i=0;i<PEG_SLOTS;i++) if(pegSlot[i].used && uidEq(pegSlot[i].uid, uid)) return i;
+  return -1;
+}
 
-  lastRFIDOkMs = millis();
+static bool anyPegTaken() {
+  for(int i=0;i<PEG_SLOTS;i++) if(pegSlot[i].used && pegSlot[i].taken) return true;
+  return false;
 }
 
-static bool readUID4(uint8_t out[4]) {
-  uint8_t uid[7], len;
-  bool ok = nfc.readPassiveTargetID(PN532_MIFARE_ISO14443A, uid, &len, 40);
-  if(!ok || len < 4) {
-    stableCount = 0;
-    return false;
+// one poll; ready[] gets the slots of pegs that just became stable
+static int scanPegs(int ready[NFC_MAX_TARGETS]) {
+  uint8_t uids[NFC_MAX_TARGETS][4];
+  uint8_t from[NFC_MAX_TARGETS];
+  int8_t n = Rfid_readPegs(uids, NFC_MAX_TARGETS, 40, from);
+  if(n < 0) {
+    // failed poll: pending pegs start over, answered ones stay answered
+    for(int i=0;i<PEG_SLOTS;i++) if(!pegSlot[i].taken) pegSlot[i].used = false;
+    return 0;
   }
 
   uint32_t now = millis();
-  if(stableCount == 0 || (now - lastUidMs) > UID_STABLE_WINDOW) {
-    memcpy(stableUid, uid, 4);
-    stableCount = 1;
-    lastUidMs = now;
-    return false;
+  bool stale = (now - lastScanMs) > UID_STABLE_WINDOW;
+  lastScanMs = now;
+  bool hadTaken = anyPegTaken();
+
+  bool seen[PEG_SLOTS] = {false};
+  for(int i=0;i<n;i++){
+    int s = findPegSlot(uids[i]);
+    if(s < 0) {
+      for(s=0; s<PEG_SLOTS && pegSlot[s].used; s++) {}
+      if(s == PEG_SLOTS) continue;
+      memset(&pegSlot[s], 0, sizeof(pegSlot[s]));
+      pegSlot[s].used = true;
+      memcpy(pegSlot[s].uid, uids[i], 4);
+    }
+    PegSlot& p = pegSlot[s];
+    if(stale && !p.taken) p.hits = 0;
+    if(p.hits == 0) p.firstUs = micros();
+    if(p.hits < 255) p.hits++;
+    p.misses = 0;
+    p.reader = (int8_t)from[i];
+    seen[s] = true;
   }
 
-  if(memcmp(stableUid, uid, 4) == 0) {
-    stableCount++;
-    lastUidMs = now;
-    if(stableCount >= UID_REQUIRED_HITS) {
-      memcpy(out, stableUid, 4);
-      stableCount = 0;
-      lastRFIDOkMs = millis();
-      return true;
+  int r = 0;
+  for(int s=0;s<PEG_SLOTS;s++){
+    PegSlot& p = pegSlot[s];
+    if(!p.used) continue;
+    if(!seen[s] && (n == 0 || !p.taken || ++p.misses >= LIFT_MISSES)) {
+      p.used = false;
+      continue;
+    }
+    if(!p.taken && p.hits >= UID_REQUIRED_HITS && r < NFC_MAX_TARGETS) {
+      p.taken = true;
+      ready[r++] = s;
     }
-  } else {
-    memcpy(stableUid, uid, 4);
-    stableCount = 1;
-    lastUidMs = now;
   }
-  return false;
+
+  // everything answered has been lifted: the next reaction time starts now
+  if(hadTaken && !anyPegTaken()) waitStartUs = micros();
+  return r;
 }
 
-static int findActiveIndexByUID(const uint8_t uid4[4]) {
+// the right peg on another antenna's zone is still the wrong place
+static int findActiveIndexByUID(const uint8_t uid4[4], int8_t reader) {
   for(int i=0;i<activeCount;i++){
+    if(Rfid_readerForLed(activeLed[i]) != reader) continue;
     const uint8_t* exp = expectedUIDForLed(activeLed[i]);
     if(exp && uidEq(uid4, exp)) return i;
   }
@@ -285,91 +301,88 @@ static void fillGradV(int x, int y, int w, int h, uint16_t top, uint16_t bot, in
     uint8_t t = (uint32_t)i * 255 / (h - 1);
     uint16_t c = blend565(top, bot, t);
     tft.fillRect(x, y+i, w, step, c);
+    SpiBus_yield(SPI_DEV_TFT);   // touch may slot in between strips
   }
 }
 
+// screens draw inline under a RenderDirect; the time bar and the in-play
+// header repaint are posted
 static void drawBackground() {
+  RenderDirect rd;
   fillGradV(0,0,SCREEN_W,SCREEN_H, C_BG, 0x0008, 2);
-  for(int i=0;i<18;i++) tft.drawPixel(random(0,SCREEN_W), random(0,SCREEN_H), TFT_WHITE);
+  for(int i=0;i<18;i++) tft.drawPixel(Rng_decor(0,SCREEN_W), Rng_decor(0,SCREEN_H), TFT_WHITE);
 }
 
 static void drawTopTitle(const char* title) {
-  tft.setTextDatum(MC_DATUM);
-  tft.setTextFont(2);
-  tft.setTextColor(C_MUTED, TFT_BLACK);
-  tft.drawString(title, 160, 18);
+  RenderDirect rd;
+  LabelCache_draw(title, 160, 18, MC_DATUM, 2, C_MUTED, TFT_BLACK);
   tft.setTextDatum(TL_DATUM);
 }
 
-static void uiButton(int x,int y,int w,int h,uint16_t bg,const char* label) {
-  tft.fillRoundRect(x+3,y+3,w,h,16,TFT_BLACK);
-  tft.fillRoundRect(x,y,w,h,16,bg);
-  tft.drawRoundRect(x,y,w,h,16,TFT_WHITE);
+static void uiButton(DrawList& dl,int x,int y,int w,int h,uint16_t bg,const char* label) {
+  dl.fillRoundRect(x+3,y+3,w,h,16,TFT_BLACK);
+  dl.fillRoundRect(x,y,w,h,16,bg);
+  dl.drawRoundRect(x,y,w,h,16,TFT_WHITE);
 
-  tft.setTextDatum(MC_DATUM);
+  dl.setTextDatum(MC_DATUM);
 
   // ✅ shrink font for narrow buttons (like PLAY AGAIN / GAMES MENU)
-  if (w <= 140) tft.setTextFont(2);
-  else          tft.setTextFont(4);
+  if (w <= 140) dl.setTextFont(2);
+  else          dl.setTextFont(4);
 
-  tft.setTextColor(TFT_BLACK, bg);
-  tft.drawString(label, x+w/2+1, y+h/2+1);
-  tft.setTextColor(TFT_WHITE, bg);
-  tft.drawString(label, x+w/2, y+h/2);
+  dl.setTextColor(TFT_BLACK, bg);
+  dl.drawString(label, x+w/2+1, y+h/2+1);
+  dl.setTextColor(TFT_WHITE, bg);
+  dl.drawString(label, x+w/2, y+h/2);
 
-  tft.setTextDatum(TL_DATUM);
+  dl.setTextDatum(TL_DATUM);
+}
+
+static void uiButton(int x,int y,int w,int h,uint16_t bg,const char* label) {
+  DrawList dl;
+  uiButton(dl,x,y,w,h,bg,label);
+  DrawList_run(dl);
 }
 
 
 static void drawCenterCard(const char* top, const char* bottom) {
+  RenderDirect rd;
   tft.fillRoundRect(CARD_X+3, CARD_Y+3, CARD_W, CARD_H, 14, TFT_BLACK);
   tft.fillRoundRect(CARD_X,   CARD_Y,   CARD_W, CARD_H, 14, C_PANEL2);
   tft.drawRoundRect(CARD_X,   CARD_Y,   CARD_W, CARD_H, 14, TFT_WHITE);
 
-  tft.setTextDatum(MC_DATUM);
-  tft.setTextFont(2);
-  tft.setTextColor(C_ACCENT, C_PANEL2);
-  tft.drawString(top, 160, CARD_Y + 14);
+  LabelCache_draw(top, 160, CARD_Y + 14, MC_DATUM, 2, C_ACCENT, C_PANEL2);
 
-  tft.setTextFont(1);
-  tft.setTextColor(TFT_WHITE, C_PANEL2);
-  tft.drawString(bottom, 160, CARD_Y + 28);
+  LabelCache_draw(bottom, 160, CARD_Y + 28, MC_DATUM, 1, TFT_WHITE, C_PANEL2);
   tft.setTextDatum(TL_DATUM);
 }
 
 static void drawBackButton() {
+  RenderDirect rd;
   tft.fillRoundRect(BTN_BACK_X, BTN_BACK_Y, BTN_BACK_W, BTN_BACK_H, 8, C_PANEL2);
   tft.drawRoundRect(BTN_BACK_X, BTN_BACK_Y, BTN_BACK_W, BTN_BACK_H, 8, TFT_WHITE);
-  tft.setTextDatum(MC_DATUM);
-  tft.setTextFont(2);
-  tft.setTextColor(TFT_WHITE, C_PANEL2);
-  tft.drawString("< Back", BTN_BACK_X + BTN_BACK_W/2, BTN_BACK_Y + BTN_BACK_H/2);
+  LabelCache_draw("< Back", BTN_BACK_X + BTN_BACK_W/2, BTN_BACK_Y + BTN_BACK_H/2, MC_DATUM, 2, TFT_WHITE, C_PANEL2);
   tft.setTextDatum(TL_DATUM);
 }
 
 // --------- Time bar ----------
-static void drawTimeBarFrame() {
+static void paintTimeBarFrame() {
+  RenderDirect rd;
   tft.drawRoundRect(BAR_X, BAR_Y, BAR_W, BAR_H, 4, TFT_WHITE);
   tft.fillRoundRect(BAR_X+1, BAR_Y+1, BAR_W-2, BAR_H-2, 3, TFT_BLACK);
-  lastBarFill = -1;
-  lastBarDrawMs = 0;
+}
+
+// after the frame was painted (or is queued to be): the next bar frame is a full one
+static void resetTimeBar() {
+  Progress_begin(timeBar, BAR_X+1, BAR_Y+1, BAR_W-2, BAR_H-2, 3, TFT_BLACK);
 }
 
 static void updateTimeBar() {
   if(state != ST_PLAY) return;
-  if(millis() - lastBarDrawMs < 80) return;
-  lastBarDrawMs = millis();
 
   uint32_t elapsed = millis() - roundStartMs;
   if(elapsed > roundMs) elapsed = roundMs;
   uint32_t remaining = roundMs - elapsed;
-
-  int fillPx = (int)((uint32_t)(BAR_W-2) * remaining / roundMs);
-  if(fillPx == lastBarFill) {
-    if(remaining > (roundMs / 10)) return;
-  }
-  lastBarFill = fillPx;
-
   uint32_t pct = (uint32_t)remaining * 100 / roundMs;
 
   uint16_t barColor = C_ACCENT;
@@ -382,15 +395,11 @@ static void updateTimeBar() {
     if(!on) barColor = TFT_BLACK;
   }
 
-  tft.fillRoundRect(BAR_X+1, BAR_Y+1, BAR_W-2, BAR_H-2, 3, TFT_BLACK);
-  if(fillPx > 0 && barColor != TFT_BLACK) {
-    tft.fillRoundRect(BAR_X+1, BAR_Y+1, fillPx, BAR_H-2, 3, barColor);
-  }
+  Progress_set(timeBar, remaining, roundMs, barColor);
 }
 
 // ---------------- SCREENS ----------------
-static void drawRfidRetryScreen() {
-  ledsOff();
+static void paintRfidRetryScreen() {
   drawBackground();
   drawTopTitle("Color Match Pairs");
   drawCenterCard("RFID ERROR", "Tap RETRY to reconnect");
@@ -398,8 +407,12 @@ static void drawRfidRetryScreen() {
   drawBackButton();
 }
 
-static void drawLevelScreen() {
+static void drawRfidRetryScreen() {
   ledsOff();
+  ScreenCache_draw(SCREEN_G3_RETRY, paintRfidRetryScreen);
+}
+
+static void paintLevelScreen() {
   drawBackground();
   drawTopTitle("Color Match Pairs");
   drawCenterCard("Choose Difficulty", "Match all pairs before time ends");
@@ -409,73 +422,80 @@ static void drawLevelScreen() {
   drawBackButton();
 }
 
-static void drawPlayScreenHeader() {
+static void drawLevelScreen() {
+  ledsOff();
+  ScreenCache_draw(SCREEN_G3_LEVEL, paintLevelScreen);
+}
+
+struct HeaderCmd { int16_t coins, pairs, pairsTotal; };
+static void paintPlayScreenHeader(const HeaderCmd& c) {
   drawBackground();
   drawTopTitle("Match the Colors");
   drawCenterCard("SCAN 2 TAGS", "Same color = match (same tag ignored)");
-  drawTimeBarFrame();
+  paintTimeBarFrame();
 
   tft.setTextDatum(MC_DATUM);
   tft.setTextFont(2);
   tft.setTextColor(C_MUTED, TFT_BLACK);
 
   tft.fillRect(0, 210, 320, 30, TFT_BLACK);
-  tft.drawString(String("Coins: ") + coinsTotal, 60, 224);
-  tft.drawString(String("Pairs: ") + pairsMatched + "/" + boardPairs, 250, 224);
+  TextBuf<24> t;
+  tft.drawString(t.set("Coins: ", c.coins), 60, 224);
+  tft.drawString(t.set("Pairs: ", c.pairs, "/", c.pairsTotal), 250, 224);
 
   tft.setTextDatum(TL_DATUM);
 }
 
+// repainted after every match, so it goes through the queue
+static void drawPlayScreenHeader() {
+  HeaderCmd c = { (int16_t)coinsTotal, (int16_t)pairsMatched, (int16_t)boardPairs };
+  Render_post<HeaderCmd, paintPlayScreenHeader>(RK_HEADER, c);
+  resetTimeBar();
+}
+
 static void drawDoneScreen(bool win, bool timeout=false) {
+  RenderDirect rd;
   ledsOff();
   drawBackground();
 
-  tft.setTextDatum(MC_DATUM);
-  tft.setTextFont(4);
-  if(win) {
-    tft.setTextColor(C_OK, TFT_BLACK);
-    tft.drawString("GREAT!", 160, 40);
-  } else {
-    tft.setTextColor(C_BAD, TFT_BLACK);
-    tft.drawString(timeout ? "TIME!" : "OOPS!", 160, 40);
-  }
+  if(win) LabelCache_draw("GREAT!", 160, 40, MC_DATUM, 4, C_OK, TFT_BLACK);
+  else LabelCache_draw(timeout ? "TIME!" : "OOPS!", 160, 40, MC_DATUM, 4, C_BAD, TFT_BLACK);
 
   int msgY = 70;
   tft.fillRoundRect(30, msgY, 260, 44, 14, C_PANEL2);
   tft.drawRoundRect(30, msgY, 260, 44, 14, TFT_WHITE);
 
-  tft.setTextFont(2);
-  tft.setTextColor(TFT_WHITE, C_PANEL2);
-  if(win) tft.drawString("All pairs matched!", 160, msgY + 22);
-  else if(timeout) tft.drawString("Try faster next time", 160, msgY + 22);
-  else tft.drawString("Wrong pair", 160, msgY + 22);
+  LabelCache_draw(win ? "All pairs matched!" : (timeout ? "Try faster next time" : "Wrong pair"),
+                  160, msgY + 22, MC_DATUM, 2, TFT_WHITE, C_PANEL2);
 
   int bx = 30, by = 122, bw = 260, bh = 44;
   tft.fillRoundRect(bx, by, bw, bh, 14, TFT_BLACK);
   tft.drawRoundRect(bx, by, bw, bh, 14, TFT_WHITE);
 
-  tft.setTextDatum(TL_DATUM);
-  tft.setTextFont(2);
-  tft.setTextColor(C_MUTED, TFT_BLACK);
-  tft.drawString("Earned this round", bx + 12, by + 6);
+  LabelCache_draw("Earned this round", bx + 12, by + 6, TL_DATUM, 2, C_MUTED, TFT_BLACK);
 
   tft.setTextColor(TFT_WHITE, TFT_BLACK);
-  tft.drawString(String("Pairs +") + coinsFromMatches, bx + 12, by + 24);
-  tft.drawString(String("Win +")   + coinsFromBonus,   bx + 120, by + 24);
+  TextBuf<48> t;
+  tft.drawString(t.set("Pairs +", coinsFromMatches), bx + 12, by + 24);
+  tft.drawString(t.set("Win +", coinsFromBonus),     bx + 120, by + 24);
 
   tft.setTextDatum(TR_DATUM);
   tft.setTextFont(4);
   tft.setTextColor(C_ACCENT, TFT_BLACK);
-  tft.drawString(String("+") + coinsRound, bx + bw - 12, by + 30);
+  tft.drawString(t.set("+", coinsRound), bx + bw - 12, by + 30);
 
   tft.setTextDatum(MC_DATUM);
   tft.setTextFont(2);
   tft.setTextColor(C_MUTED, TFT_BLACK);
-  tft.drawString(String("Score: ") + score + "   Total Coins: " + coinsTotal, 160, 178);
+  tft.drawString(t.set("Score: ", score, "   Total Coins: ", coinsTotal), 160, 178);
 
-  // ✅ DONE buttons (NO BACK here)
-  uiButton(END_PLAY_X, END_BTN_Y, END_BTN_W, END_BTN_H, C_ACCENT, "PLAY AGAIN");
-  uiButton(END_MENU_X, END_BTN_Y, END_BTN_W, END_BTN_H, C_WARN,   "GAMES MENU");
+  // ✅ DONE buttons (NO BACK here), recorded once
+  static DrawList endButtons;
+  if(endButtons.empty()) {
+    uiButton(endButtons, END_PLAY_X, END_BTN_Y, END_BTN_W, END_BTN_H, C_ACCENT, "PLAY AGAIN");
+    uiButton(endButtons, END_MENU_X, END_BTN_Y, END_BTN_W, END_BTN_H, C_WARN,   "GAMES MENU");
+  }
+  DrawList_run(endButtons);
 
   tft.setTextDatum(TL_DATUM);
 }
@@ -496,15 +516,14 @@ static void generateBoard() {
   activeCount = boardPairs * 2;
   if(activeCount > MAX_ACTIVE) activeCount = MAX_ACTIVE;
 
-  int n=0;
-  while(n < activeCount) {
-    uint8_t led = LED_ZONES[random(NUM_ZONES)];
-    if(!ledInUse(led, n)) {
-      activeLed[n] = led;
-      matched[n] = false;
-      n++;
-    }
-  }
+  if(activeCount > NUM_ZONES) activeCount = NUM_ZONES;
+
+  // distinct zones: the first activeCount steps of a shuffle of all of them
+  uint8_t zones[NUM_ZONES];
+  memcpy(zones, LED_ZONES, sizeof(zones));
+  Rng_sample(zones, NUM_ZONES, (uint8_t)activeCount);
+  memcpy(activeLed, zones, activeCount);
+  memset(matched, 0, sizeof(matched));
 
   int idx = 0;
   for(int pairId=0; pairId < boardPairs && (idx+1)<activeCount; pairId++){
@@ -514,12 +533,7 @@ static void generateBoard() {
     colorId[idx++] = pid;
   }
 
-  for(int i=activeCount-1;i>0;i--){
-    int j = random(0, i+1);
-    uint8_t tmp = colorId[i];
-    colorId[i] = colorId[j];
-    colorId[j] = tmp;
-  }
+  Rng_shuffle(colorId, (uint8_t)activeCount);
 
   hasFirst = false;
   firstIdx = -1;
@@ -527,26 +541,24 @@ static void generateBoard() {
 }
 
 static void renderBoardLeds() {
-  strip.clear();
+  Leds_clear();
   for(int i=0;i<activeCount;i++){
     if(matched[i]) continue;
     uint8_t pid = colorId[i];
     if(pid >= PALETTE_LEN) pid = (uint8_t)(PALETTE_LEN - 1);
-    strip.setPixelColor(activeLed[i], PALETTE[pid]);
+    Leds_set(activeLed[i], PALETTE[pid]);
   }
-  strip.show();
+  Leds_show();
 }
 
 static void flashMatchedPair(int a, int b) {
-  strip.setPixelColor(activeLed[a], strip.Color(0, 220, 0));
-  strip.setPixelColor(activeLed[b], strip.Color(0, 220, 0));
-  strip.show();
-  delay(180);
+  Leds_set(activeLed[a], strip.Color(0, 220, 0));
+  Leds_set(activeLed[b], strip.Color(0, 220, 0));
+  Leds_hold(180);
 
-  strip.setPixelColor(activeLed[a], PALETTE[colorId[a]]);
-  strip.setPixelColor(activeLed[b], PALETTE[colorId[b]]);
-  strip.show();
-  delay(90);
+  Leds_set(activeLed[a], PALETTE[colorId[a]]);
+  Leds_set(activeLed[b], PALETTE[colorId[b]]);
+  Leds_hold(90);
 }
 
 static int pointsPerMatch() {
@@ -567,31 +579,39 @@ static int coinsWinBonus() {
 }
 
 // ---------------- FLOW ----------------
-static void doCountdown() {
+static void drawCountdownDigit(int n) {
+  RenderDirect rd;
+  int x=70, y=96, w=180, h=84;
+  tft.fillRoundRect(x+3,y+3,w,h,16,TFT_BLACK);
+  tft.fillRoundRect(x,y,w,h,16,C_PANEL2);
+  tft.drawRoundRect(x,y,w,h,16,TFT_WHITE);
+
+  TextBuf<12> t;
+  LabelCache_draw(t.set(n), 160, 138, MC_DATUM, 8, TFT_WHITE, C_PANEL2);
+  tft.setTextDatum(TL_DATUM);
+}
+
+static bool countdownStep() {
+  static int n;
+  CO_BEGIN(flowTask);
+
   drawBackground();
   drawTopTitle("Get ready");
   drawCenterCard("STARTING", "Match the color pairs");
 
-  for(int n=3; n>=1; n--){
-    int x=70, y=96, w=180, h=84;
-    tft.fillRoundRect(x+3,y+3,w,h,16,TFT_BLACK);
-    tft.fillRoundRect(x,y,w,h,16,C_PANEL2);
-    tft.drawRoundRect(x,y,w,h,16,TFT_WHITE);
+  // each digit card covers the last one; the board is dealt while the
+  // last digit shows, so the play screen replaces it directly
+  for(n=3; n>=1; n--){
+    drawCountdownDigit(n);
 
-    tft.setTextDatum(MC_DATUM);
-    tft.setTextFont(8);
-    tft.setTextColor(TFT_WHITE, C_PANEL2);
-    tft.drawString(String(n), 160, 138);
-    tft.setTextDatum(TL_DATUM);
-
-    flashAll(strip.Color(0,120,180), 1, 70, 70);
-    delay(650);
-
-    drawBackground();
-    drawTopTitle("Get ready");
-    drawCenterCard("STARTING", "Match the color pairs");
+    fillAll(strip.Color(0,120,180));
+    CO_SLEEP(flowTask, 70);
+    ledsOff();
+    if(n == 1) generateBoard();
+    CO_SLEEP(flowTask, 70 + 650);
   }
-  state = ST_SHOW_BOARD;
+
+  CO_END(flowTask);
 }
 
 static void showBoard() {
@@ -600,126 +620,125 @@ static void showBoard() {
   coinsFromBonus = 0;
 
   score = 0;
-  pairsMatched = 0;
 
-  generateBoard();
   drawPlayScreenHeader();
   renderBoardLeds();
 
   roundStartMs = millis();
-  inputPhase = WAIT_FOR_TAG;
-  kickPN532();
-  lastRFIDOkMs = millis();
+  memset(pegSlot, 0, sizeof(pegSlot));
+  RtStats_beginSession(RT_MATCH, level - LV_EASY);
+  waitStartUs = micros();
 
   state = ST_PLAY;
 }
 
-// ---------------- INPUT ----------------
-static void handlePlay() {
-  if(millis() - lastRFIDOkMs > RFID_STUCK_MS) recoverRFID();
+static void finishSession() {
+  RtSummary s;
+  RtStats_endSession(s);
+  s.score = score;
+  s.coins = coinsRound;
+  reportScore(coinsRound, score);
+  reportSession(s);
+}
 
-  if(millis() - roundStartMs > roundMs) {
-    fillAll(strip.Color(180,0,0));
-    delay(450);
-    ledsOff();
-    state = ST_DONE;
-    drawDoneScreen(false, true);
+// ---------------- INPUT ----------------
+// one answered peg; pairMate = the other peg of the pair landed in the same
+// poll, so the "first peg" blink is skipped and the verdict comes right away
+static void takePeg(int idx, int32_t rtUs, bool pairMate) {
+  // a response counts as correct when it moves the game forward
+  bool valid = idx >= 0 && !matched[idx] &&
+               (!hasFirst || (idx != firstIdx && colorId[idx] == colorId[firstIdx]));
+  RtStats_response(idx >= 0 ? activeLed[idx] : 255, rtUs, valid);
+
+  if(idx < 0) {
+    flashAll(strip.Color(180,0,0), 1, 60, 60);
+    return;
+  }
+  if(matched[idx]) {
+    blinkLed(activeLed[idx], strip.Color(255, 200, 40), 1, 90, 60);
     return;
   }
 
-  uint8_t uid4[4];
-  bool tagPresent = readUID4(uid4);
-
-  if(inputPhase == WAIT_FOR_TAG) {
-    if(!tagPresent) return;
-
-    int idx = findActiveIndexByUID(uid4);
-    if(idx < 0) {
-      flashAll(strip.Color(180,0,0), 1, 60, 60);
-      inputPhase = WAIT_FOR_LIFT;
-      return;
-    }
-    if(matched[idx]) {
-      blinkLed(activeLed[idx], strip.Color(255, 200, 40), 1, 90, 60);
-      inputPhase = WAIT_FOR_LIFT;
-      return;
-    }
-
-    if(!hasFirst) {
-      hasFirst = true;
-      firstIdx = idx;
-      blinkLed(activeLed[idx], strip.Color(255,255,255), 1, 90, 60);
-      renderBoardLeds();
-      inputPhase = WAIT_FOR_LIFT;
-      return;
-    }
-
-    if(idx == firstIdx) {
-      blinkLed(activeLed[idx], strip.Color(255, 200, 40), 1, 110, 70);
-      renderBoardLeds();
-      inputPhase = WAIT_FOR_LIFT;
-      return;
-    }
+  if(!hasFirst) {
+    hasFirst = true;
+    firstIdx = idx;
+    if(pairMate) return;
+    blinkLed(activeLed[idx], strip.Color(255,255,255), 1, 90, 60);
+    renderBoardLeds();
+    return;
+  }
 
-    bool ok = (colorId[idx] == colorId[firstIdx]);
+  if(idx == firstIdx) {
+    blinkLed(activeLed[idx], strip.Color(255, 200, 40), 1, 110, 70);
+    renderBoardLeds();
+    return;
+  }
 
-    if(ok) {
-      flashMatchedPair(firstIdx, idx);
-      matched[firstIdx] = true;
-      matched[idx] = true;
-      pairsMatched++;
-      score += pointsPerMatch();
+  bool ok = (colorId[idx] == colorId[firstIdx]);
 
-      int c = coinsPerMatch();
-      coinsTotal += c;
-      coinsRound += c;
-      coinsFromMatches += c;
+  if(ok) {
+    flashMatchedPair(firstIdx, idx);
+    matched[firstIdx] = true;
+    matched[idx] = true;
+    pairsMatched++;
+    score += pointsPerMatch();
 
-      drawPlayScreenHeader();
-      renderBoardLeds();
+    int c = coinsPerMatch();
+    coinsTotal += c;
+    coinsRound += c;
+    coinsFromMatches += c;
 
-      hasFirst = false;
-      firstIdx = -1;
+    // the last pair goes straight to the end screen
+    if(pairsMatched < boardPairs) drawPlayScreenHeader();
+    renderBoardLeds();
 
-      if(pairsMatched >= boardPairs) {
-        flashAll(strip.Color(0,180,0), 2, 130, 90);
+    hasFirst = false;
+    firstIdx = -1;
 
-        int b = coinsWinBonus();
-        coinsTotal += b;
-        coinsRound += b;
-        coinsFromBonus += b;
+    if(pairsMatched >= boardPairs) {
+      flashAll(strip.Color(0,180,0), 2, 130, 90);
 
-        state = ST_DONE;
-        drawDoneScreen(true, false);
-        return;
-      }
+      int b = coinsWinBonus();
+      coinsTotal += b;
+      coinsRound += b;
+      coinsFromBonus += b;
 
-    } else {
-      fillAll(strip.Color(180,0,0));
-      delay(450);
-      ledsOff();
       state = ST_DONE;
-      drawDoneScreen(false, false);
-      return;
+      drawDoneScreen(true, false);
+      finishSession();
     }
 
-    inputPhase = WAIT_FOR_LIFT;
+  } else {
+    fillAll(strip.Color(180,0,0)); Leds_hold(450); ledsOff();
+    state = ST_DONE;
+    drawDoneScreen(false, false);
+    finishSession();
+  }
+}
+
+static void handlePlay() {
+  if(millis() - roundStartMs > roundMs) {
+    fillAll(strip.Color(180,0,0)); Leds_hold(450); ledsOff();
+    state = ST_DONE;
+    drawDoneScreen(false, true);
+    finishSession();
     return;
   }
 
-  if(tagPresent) return;
-  inputPhase = WAIT_FOR_TAG;
-  kickPN532();
+  int ready[NFC_MAX_TARGETS];
+  int n = scanPegs(ready);
+  for(int i=0;i<n && state == ST_PLAY;i++){
+    const PegSlot& p = pegSlot[ready[i]];
+    int32_t rtUs = (int32_t)(p.firstUs - waitStartUs);
+    takePeg(findActiveIndexByUID(p.uid, p.reader), rtUs > 0 ? rtUs : 0, i + 1 < n);
+  }
 }
 
 // ============================================================
 //  PUBLIC API
 // ============================================================
 void Game3_begin() {
-  randomSeed(micros());
-
-  uint32_t v = nfc.getFirmwareVersion();
-  if(!v) {
+  if(!Rfid_ready()) {
     state = ST_RFID_RETRY;
     drawRfidRetryScreen();
     return;
@@ -728,16 +747,19 @@ void Game3_begin() {
   state = ST_PICK_LEVEL;
   level = LV_NONE;
   drawLevelScreen();
-  lastRFIDOkMs = millis();
 }
 
 void Game3_update() {
   int sx, sy;
 
   // Global BACK (enabled on retry/level/play screens, disabled on DONE)
-  if(state != ST_DONE && Touch_pressed(sx, sy)) {
+  // one read per pass: a press is reported once, so BACK and the screen's
+  // own buttons have to look at the same one
+  bool touched = (state != ST_DONE) && Touch_pressed(sx, sy);
+  if(touched) {
     if(hitRectMapped(sx, sy, BTN_BACK_X, BTN_BACK_Y, BTN_BACK_W, BTN_BACK_H)) {
-      waitTouchRelease();
+      Touch_waitRelease();
+      CO_RESET(flowTask);
       ledsOff();
       g_screen = SCR_MENU;
       Menu_draw();
@@ -747,57 +769,61 @@ void Game3_update() {
 
   // RFID RETRY
   if(state == ST_RFID_RETRY) {
-    if(Touch_pressed(sx, sy)) {
+    if(touched) {
       if(hitRectMapped(sx, sy, BTN_RETRY_X, BTN_RETRY_Y, BTN_RETRY_W, BTN_RETRY_H)) {
-        waitTouchRelease();
+        Touch_waitRelease();
 
         drawCenterCard("RETRYING...", "Please wait");
-        nfc.begin();
-        delay(30);
-        uint32_t v = nfc.getFirmwareVersion();
-        if(v) {
-          nfc.SAMConfig();
+        if(Rfid_recoverNow()) {
           state = ST_PICK_LEVEL;
           drawLevelScreen();
-          lastRFIDOkMs = millis();
         } else {
           drawRfidRetryScreen();
         }
       }
     }
-    delay(20);
+    Coop_pollIn(20);
     return;
   }
 
   // PICK LEVEL
   if(state == ST_PICK_LEVEL) {
-    if(Touch_pressed(sx, sy)) {
+    if(touched) {
       bool inEasy = hitRectMapped(sx, sy, BTN_X, BTN_EASY_Y, BTN_W, BTN_H);
       bool inMed  = hitRectMapped(sx, sy, BTN_X, BTN_MED_Y,  BTN_W, BTN_H);
       bool inHard = hitRectMapped(sx, sy, BTN_X, BTN_HARD_Y, BTN_W, BTN_H);
 
-      if(!inEasy && !inMed && !inHard) { delay(10); return; }
+      if(!inEasy && !inMed && !inHard) { Coop_pollIn(10); return; }
 
       if(inEasy)      level = LV_EASY;
       else if(inMed)  level = LV_MEDIUM;
       else            level = LV_HARD;
 
-      waitTouchRelease();
+      Touch_waitRelease();
 
       applyLevelSettings();
+      Rng_beginSession();              // the board is dealt during the countdown
+      CO_RESET(flowTask);
       state = ST_COUNTDOWN;
-      doCountdown();
     }
-    delay(10);
+    Coop_pollIn(10);
+    return;
+  }
+
+  // COUNTDOWN (wakes itself)
+  if(state == ST_COUNTDOWN) {
+    if(!countdownStep()) return;
+    state = ST_SHOW_BOARD;
+    Coop_pollIn(10);
     return;
   }
 
-  if(state == ST_SHOW_BOARD) { showBoard(); delay(10); return; }
+  if(state == ST_SHOW_BOARD) { showBoard(); Coop_pollIn(10); return; }
 
   if(state == ST_PLAY) {
     updateTimeBar();
     handlePlay();
-    delay(5);
+    Coop_pollIn(5);
     return;
   }
 
@@ -807,7 +833,7 @@ void Game3_update() {
       bool playHit = hitRectMapped(sx, sy, END_PLAY_X, END_BTN_Y, END_BTN_W, END_BTN_H);
       bool menuHit = hitRectMapped(sx, sy, END_MENU_X, END_BTN_Y, END_BTN_W, END_BTN_H);
 
-      waitTouchRelease();
+      Touch_waitRelease();
 
       if(playHit) {
         level = LV_NONE;
@@ -823,7 +849,7 @@ void Game3_update() {
         return;
       }
     }
-    delay(20);
+    Coop_pollIn(20);
     return;
   }
 }
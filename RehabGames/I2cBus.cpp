@@ -0,0 +1,153 @@
+// I2cBus.cpp – Wire owner, clock ladder and transaction stats
+#include "I2cBus.h"
+
+static const uint8_t  WINDOW_ERRS_DOWN = 3;      // errors in the last 32 -> step down
+static const uint32_t UP_HOLD_MS       = 20000;  // between upgrade attempts
+static const uint8_t  UP_BACKOFF_MAX   = 3;      // hold doubles up to 8x
+
+static int8_t   sdaPin = -1, sclPin = -1;
+static I2cProbe probeFn = nullptr;
+static uint8_t  rung = I2C_RUNGS - 1;            // start slow until negotiated
+
+static uint32_t window = 0;                      // 1 bit per transaction, 1 = error
+static uint8_t  seen = 0;                        // transactions in the window, up to 32
+static uint32_t nextUpMs = 0;
+static uint8_t  upFails[I2C_RUNGS];
+static bool     adapting = true;                 // off while probing
+static uint8_t  muxChannel = I2C_NO_MUX;         // switched in; NO_MUX = unknown
+
+static I2cStats stats;
+
+static const char* OP_NAME[I2C_OP_COUNT] = { "probe", "init", "arm", "poll" };
+
+static uint8_t popcount32(uint32_t v) {
+  uint8_t n = 0;
+  while(v) { v &= v - 1; n++; }
+  return n;
+}
+
+static void applyRung(uint8_t r) {
+  rung = r;
+  Wire.setClock(I2C_LADDER_HZ[r]);
+  window = 0;
+  seen = 0;
+}
+
+static uint32_t upHoldMs(uint8_t r) {
+  uint8_t f = upFails[r] > UP_BACKOFF_MAX ? UP_BACKOFF_MAX : upFails[r];
+  return UP_HOLD_MS << f;
+}
+
+// probe I2C_PROBE_ROUNDS times at the current clock; every one must pass
+static bool probeHere() {
+  if(!probeFn) return true;
+  bool prev = adapting;
+  adapting = false;
+  bool ok = true;
+  for(uint8_t i=0;i<I2C_PROBE_ROUNDS && ok;i++) {
+    I2cTxn t(I2C_OP_PROBE);
+    ok = t.done(probeFn());
+  }
+  adapting = prev;
+  return ok;
+}
+
+static void tryUpgrade() {
+  uint8_t from = rung, to = rung - 1;
+  applyRung(to);
+  if(probeHere()) {
+    stats.upgrades++;
+    if(rung > 0) nextUpMs = millis() + upHoldMs(rung - 1);
+    return;
+  }
+  applyRung(from);
+  stats.failedUpgrades++;
+  if(upFails[to] < 255) upFails[to]++;
+  nextUpMs = millis() + upHoldMs(to);
+}
+
+void I2cBus_begin(int8_t sda, int8_t scl, I2cProbe probe) {
+  sdaPin = sda;
+  sclPin = scl;
+  probeFn = probe;
+  rung = I2C_RUNGS - 1;
+  memset(upFails, 0, sizeof(upFails));
+  nextUpMs = 0;
+  muxChannel = I2C_NO_MUX;
+  Wire.begin(sda, scl);
+  Wire.setTimeOut(50);
+  applyRung(rung);
+}
+
+bool I2cBus_negotiate() {
+  adapting = true;
+  for(uint8_t r=0;r<I2C_RUNGS;r++) {
+    applyRung(r);
+    delay(2);
+    if(probeHere()) {
+      nextUpMs = millis() + upHoldMs(r);
+      return true;
+    }
+  }
+  applyRung(I2C_RUNGS - 1);
+  return false;
+}
+
+void I2cBus_pin(uint8_t r) {
+  applyRung(r < I2C_RUNGS ? r : I2C_RUNGS - 1);
+  adapting = false;
+}
+
+void I2cBus_clear() {
+  Wire.end();
+  delay(20);
+  Wire.begin(sdaPin, sclPin);
+  Wire.setTimeOut(50);
+  applyRung(rung);
+  stats.busClears++;
+  muxChannel = I2C_NO_MUX;   // the mux may have been the one holding the bus
+  delay(20);
+}
+
+bool I2cBus_select(uint8_t channel) {
+  if(channel == I2C_NO_MUX || channel == muxChannel) return true;
+  Wire.beginTransmission(I2C_MUX_ADDR);
+  Wire.write((uint8_t)(1u << channel));
+  bool ok = Wire.endTransmission() == 0;
+  muxChannel = ok ? channel : I2C_NO_MUX;
+  stats.muxSwitches++;
+  return ok;
+}
+
+void I2cBus_note(I2cOp op, bool ok, uint32_t us) {
+  I2cOpStats& s = stats.op[op];
+  s.count++;
+  s.usSum += us;
+  if(us > s.usMax) s.usMax = us;
+  if(!ok) s.errors++;
+
+  if(!adapting) return;
+  window = (window << 1) | (ok ? 0u : 1u);
+  if(seen < 32) seen++;
+
+  if(!ok && rung < I2C_RUNGS - 1 && popcount32(window) >= WINDOW_ERRS_DOWN) {
+    if(upFails[rung] < 255) upFails[rung]++;
+    applyRung(rung + 1);
+    stats.downgrades++;
+    nextUpMs = millis() + upHoldMs(rung - 1);
+    return;
+  }
+
+  if(ok && rung > 0 && seen == 32 && window == 0 && (int32_t)(millis() - nextUpMs) >= 0) {
+    tryUpgrade();
+  }
+}
+
+uint32_t I2cBus_clockHz() { return I2C_LADDER_HZ[rung]; }
+uint8_t  I2cBus_rung() { return rung; }
+
+const I2cStats& I2cBus_stats() { return stats; }
+
+void I2cBus_resetStats() { memset(&stats, 0, sizeof(stats)); }
+
+const char* I2cBus_opName(I2cOp op) { return op < I2C_OP_COUNT ? OP_NAME[op] : "?"; }
@@ -0,0 +1,76 @@
+#pragma once
+#include <Arduino.h>
+#include <Wire.h>
+
+// ---------------- I2C bus service ----------------
+// Owns Wire (PN532 on SDA 32 / SCL 33). The clock is one rung of a ladder:
+// I2cBus_negotiate() walks it top-down and keeps the fastest rung where the
+// probe (firmware version + SAMConfiguration for the PN532) passes
+// I2C_PROBE_ROUNDS times in a row: wiring that mangles 30 % of its
+// transactions gets through 8 rounds well under 1 % of the time. After that
+// every PN532 transaction is noted here (I2cTxn) and feeds a
+// 32-transaction error window. Only transport failures count (NAK, timeout,
+// a frame that fails its checksum); a chip that answers with an error frame
+// got its bytes across, and re-arming it is the reader manager's job.
+//   - 3+ errors in the window              -> one rung down
+//   - below the top rung, the last 32 clean -> every UP_HOLD_MS, probe one
+//     rung up (the probe holds loop() for ~0.2 s); a failed probe doubles
+//     the wait before the next try (up to 8x)
+// so polling runs at the highest clock the wiring holds up at, and every
+// game sees the same bus state. Nothing else calls Wire.begin/end/setClock.
+// Boards with several readers put them behind a TCA9548A-style mux at 0x70;
+// I2cBus_select() switches the channel in (cached, so repeats are free).
+
+static const uint8_t  I2C_MUX_ADDR = 0x70;
+static const uint8_t  I2C_NO_MUX   = 0xFF;       // device sits on the bus itself
+
+static const uint8_t  I2C_RUNGS = 3;
+static const uint32_t I2C_LADDER_HZ[I2C_RUNGS] = { 400000, 200000, 100000 };
+static const uint8_t  I2C_PROBE_ROUNDS = 8;
+
+enum I2cOp : uint8_t {
+  I2C_OP_PROBE,     // negotiation / upgrade probes
+  I2C_OP_INIT,      // begin + firmware version
+  I2C_OP_ARM,       // SAMConfiguration
+  I2C_OP_POLL,      // InListPassiveTarget
+  I2C_OP_COUNT
+};
+
+struct I2cOpStats {
+  uint32_t count;
+  uint32_t errors;
+  uint32_t usMax;
+  uint64_t usSum;
+};
+
+struct I2cStats {
+  uint32_t downgrades;
+  uint32_t upgrades;
+  uint32_t failedUpgrades;
+  uint32_t busClears;
+  uint32_t muxSwitches;
+  I2cOpStats op[I2C_OP_COUNT];
+};
+
+typedef bool (*I2cProbe)();    // a cheap, verifiable round-trip
+
+void     I2cBus_begin(int8_t sda, int8_t scl, I2cProbe probe);
+bool     I2cBus_negotiate();                 // false: nothing answers (left on the slowest rung)
+void     I2cBus_pin(uint8_t rung);           // fixed clock, no ladder moves, until the next negotiate
+void     I2cBus_clear();                     // Wire.end()/begin(): bus clear, same rung
+bool     I2cBus_select(uint8_t channel);     // mux channel; I2C_NO_MUX = nothing to do
+void     I2cBus_note(I2cOp op, bool ok, uint32_t us);   // ok: made it across the bus
+uint32_t I2cBus_clockHz();
+uint8_t  I2cBus_rung();                      // 0 = fastest
+const I2cStats& I2cBus_stats();
+void     I2cBus_resetStats();
+const char* I2cBus_opName(I2cOp op);
+
+// times one transaction:  I2cTxn t(I2C_OP_ARM); return t.done(nfc.SAMConfig());
+struct I2cTxn {
+  explicit I2cTxn(I2cOp o) : op(o), t0(micros()) {}
+  bool     done(bool ok) { I2cBus_note(op, ok, micros() - t0); return ok; }
+  uint32_t elapsedUs() const { return micros() - t0; }
+  I2cOp    op;
+  uint32_t t0;
+};
@@ -0,0 +1,122 @@
+// LabelCache.cpp – ink masks of fixed strings, blitted in one window
+#include "LabelCache.h"
+
+struct Label {
+  uint16_t off, len;      // in pool: text + NUL, then the mask
+  int16_t  w, h;
+  uint8_t  font;
+  uint32_t used;
+};
+
+// entries are kept in pool order, so dropping one is one memmove
+static uint8_t  pool[LABEL_CACHE_BYTES];
+static Label    labels[LABEL_CACHE_ENTRIES];
+static uint8_t  count = 0;
+static uint32_t clock_ = 0;
+static LabelCacheStats stats;
+
+static uint32_t maskBytes(int32_t w, int32_t h) { return ((uint32_t)w * h + 7) / 8; }
+
+// ---------------- pool ----------------
+static void drop(uint8_t i) {
+  uint16_t off = labels[i].off, len = labels[i].len;
+  memmove(pool + off, pool + off + len, stats.bytes - off - len);
+  for(uint8_t j=i+1;j<count;j++){
+    labels[j - 1] = labels[j];
+    labels[j - 1].off -= len;
+  }
+  count--;
+  stats.bytes -= len;
+  stats.evictions++;
+}
+
+static void dropOldest() {
+  uint8_t k = 0;
+  for(uint8_t i=1;i<count;i++) if(labels[i].used < labels[k].used) k = i;
+  drop(k);
+}
+
+static Label* find(const char* s, uint8_t font) {
+  for(uint8_t i=0;i<count;i++){
+    if(labels[i].font == font && !strcmp((const char*)pool + labels[i].off, s)) return &labels[i];
+  }
+  return nullptr;
+}
+
+// ---------------- render ----------------
+// 1-bit sprite, text in white on black at the top left, read back into a
+// mask (bit set = ink, row order, MSB first)
+static Label* render(const char* s, uint8_t font, int16_t w, int16_t h, uint16_t len) {
+  TFT_eSprite spr(&tft);
+  spr.setColorDepth(1);
+  if(!spr.createSprite(w, h)) return nullptr;
+  spr.setTextDatum(TL_DATUM);
+  spr.setTextFont(font);
+  spr.setTextColor(TFT_WHITE, TFT_BLACK);
+  spr.drawString(s, 0, 0);
+
+  while(count && (count == LABEL_CACHE_ENTRIES || stats.bytes + len > LABEL_CACHE_BYTES)) dropOldest();
+  Label& e = labels[count++];
+  e.off = (uint16_t)stats.bytes;
+  e.len = len;
+  e.w = w; e.h = h;
+  e.font = font;
+  size_t tlen = strlen(s) + 1;
+  memcpy(pool + e.off, s, tlen);
+  uint8_t* m = pool + e.off + tlen;
+  memset(m, 0, len - tlen);
+  uint32_t bit = 0;
+  for(int16_t j=0;j<h;j++)
+    for(int16_t i=0;i<w;i++,bit++)
+      if(spr.readPixel(i, j) != TFT_BLACK) m[bit >> 3] |= (uint8_t)(0x80 >> (bit & 7));
+  spr.deleteSprite();
+  stats.bytes += len;
+  stats.misses++;
+  return &e;
+}
+
+static void blit(const Label& e, int32_t x, int32_t y, uint16_t fg, uint16_t bg) {
+  const uint8_t* m = pool + e.off + strlen((const char*)pool + e.off) + 1;
+  uint32_t n = (uint32_t)e.w * e.h;
+  tft.startWrite();
+  tft.setAddrWindow(x, y, e.w, e.h);
+  uint32_t i = 0;
+  while(i < n) {
+    bool ink = m[i >> 3] & (0x80 >> (i & 7));
+    uint32_t k = i + 1;
+    while(k < n && (bool)(m[k >> 3] & (0x80 >> (k & 7))) == ink) k++;
+    tft.pushColor(ink ? fg : bg, k - i);
+    i = k;
+  }
+  tft.endWrite();
+}
+
+// ---------------- API ----------------
+void LabelCache_draw(const char* s, int32_t x, int32_t y, uint8_t datum, uint8_t font, uint16_t fg, uint16_t bg) {
+  tft.setTextDatum(datum);
+  tft.setTextFont(font);
+  tft.setTextColor(fg, bg);
+
+  int32_t w = tft.textWidth(s, font), h = tft.fontHeight(font);
+  uint32_t len = strlen(s) + 1 + maskBytes(w, h);
+  int32_t bx = x - ((datum % 3 == 1) ? w / 2 : (datum % 3 == 2) ? w : 0);
+  int32_t by = y - ((datum / 3 == 1) ? h / 2 : (datum / 3 == 2) ? h : 0);
+  if(fg == bg || datum > BR_DATUM || w <= 0 || bx < 0 || by < 0 || bx + w > SCREEN_W || by + h > SCREEN_H ||
+     len > LABEL_CACHE_MAX_ENTRY) {
+    stats.fallbacks++;
+    tft.drawString(s, x, y);
+    return;
+  }
+
+  Label* e = find(s, font);
+  if(e) stats.hits++;
+  else if(!(e = render(s, font, (int16_t)w, (int16_t)h, (uint16_t)len))) {
+    stats.fallbacks++;
+    tft.drawString(s, x, y);
+    return;
+  }
+  e->used = ++clock_;
+  blit(*e, bx, by, fg, bg);
+}
+
+const LabelCacheStats& LabelCache_stats() { return stats; }
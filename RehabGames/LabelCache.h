@@ -0,0 +1,32 @@
+#pragma once
+#include "Shared.h"
+
+// ---------------- Label cache ----------------
+// Fixed UI strings ("PLAY AGAIN", "< Back", the countdown digits, ...) are
+// rendered once per (string, font) into a 1-bit sprite and kept as a
+// packed ink mask. Every later draw is one address window and a stream of
+// fg / bg runs, instead of TFT_eSPI decoding the font glyph by glyph (and
+// one window per glyph). The mask carries no colour, so a button's shadow
+// and face share one entry.
+//
+// LabelCache_draw() is a drop-in for setTextDatum + setTextFont +
+// setTextColor + drawString and leaves tft in that state. Labels without a
+// background (fg == bg), off the panel or bigger than LABEL_CACHE_MAX_ENTRY
+// go to tft.drawString unchanged. Entries live in one static pool of
+// LABEL_CACHE_BYTES; the least recently drawn ones are dropped to make
+// room. Call it where tft is drawn anyway (it does not take the queue).
+
+static const uint16_t LABEL_CACHE_BYTES     = 16 * 1024;   // all fixed strings of the three games: ~14 KB
+static const uint16_t LABEL_CACHE_MAX_ENTRY = 1024;        // text + mask
+static const uint8_t  LABEL_CACHE_ENTRIES   = 64;
+
+struct LabelCacheStats {
+  uint32_t hits;
+  uint32_t misses;        // rendered into the pool
+  uint32_t fallbacks;     // drawn by tft.drawString
+  uint32_t evictions;
+  uint32_t bytes;         // pool in use
+};
+
+void LabelCache_draw(const char* s, int32_t x, int32_t y, uint8_t datum, uint8_t font, uint16_t fg, uint16_t bg);
+const LabelCacheStats& LabelCache_stats();
@@ -0,0 +1,250 @@
+// Leds.cpp – shadow LED frame, pushed by difference once per tick, chains in parallel
+#include "Leds.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+static SemaphoreHandle_t ledMutex = nullptr;
+#endif
+
+static uint32_t frame[LED_COUNT];     // what the games want
+static uint32_t shown[LED_COUNT];     // the frame the strip latched, as written
+static uint32_t out[LED_COUNT];       // ... and as pushed (corrected, limited)
+static bool pending = false;          // a changed frame waits for the tick's end
+static bool pushedThisTick = false;
+static LedStats stats;
+
+// ---------------- output table ----------------
+// out = 255 * (in / 255)^gamma * brightness / 255, evaluated by the
+// compiler: integer part of the exponent by multiplication, the fraction
+// one binary digit at a time (x^(1/2), x^(1/4), ... by Newton square roots)
+static constexpr double csqrt(double x, double g = 1.0, int n = 24) {
+  return n == 0 ? g : csqrt(x, 0.5 * (g + x / g), n - 1);
+}
+static constexpr double powFrac(double r, double f, int bits) {
+  return bits == 0 ? 1.0
+       : f * 2 >= 1.0 ? csqrt(r) * powFrac(csqrt(r), f * 2 - 1.0, bits - 1)
+       : powFrac(csqrt(r), f * 2, bits - 1);
+}
+static constexpr double powInt(double x, int n) { return n == 0 ? 1.0 : x * powInt(x, n - 1); }
+static constexpr double cpow(double x, double g) {
+  return x <= 0 ? 0.0 : powInt(x, (int)g) * powFrac(x, g - (int)g, 12);
+}
+static constexpr uint8_t lutEntry(int i) {
+  return (uint8_t)(cpow(i / 255.0, LED_GAMMA_X10 / 10.0) * LED_BRIGHTNESS + 0.5);
+}
+
+template<int... I> struct Seq {};
+template<int N, int... I> struct MakeSeq : MakeSeq<N - 1, N - 1, I...> {};
+template<int... I> struct MakeSeq<0, I...> { typedef Seq<I...> type; };
+
+struct Lut { uint8_t v[256]; };
+template<int... I> static constexpr Lut makeLut(Seq<I...>) { return Lut{{ lutEntry(I)... }}; }
+static constexpr Lut LUT = makeLut(MakeSeq<256>::type());
+
+static_assert(LUT.v[0] == 0 && LUT.v[255] == LED_BRIGHTNESS, "LED table ends");
+static_assert(LED_GAMMA_X10 != 22 || LED_BRIGHTNESS != 255 || LUT.v[128] == 56, "LED gamma 2.2");
+
+static uint32_t correct(uint32_t c) {
+  return ((uint32_t)LUT.v[(c >> 16) & 0xFF] << 16) | ((uint32_t)LUT.v[(c >> 8) & 0xFF] << 8) | LUT.v[c & 0xFF];
+}
+
+static uint32_t channelSum(uint32_t c) { return ((c >> 16) & 0xFF) + ((c >> 8) & 0xFF) + (c & 0xFF); }
+
+static uint32_t scaleColor(uint32_t c, uint32_t k) {   // k / 256
+  return ((((c >> 16) & 0xFF) * k >> 8) << 16) | ((((c >> 8) & 0xFF) * k >> 8) << 8) | ((c & 0xFF) * k >> 8);
+}
+
+// ---------------- strip output ----------------
+// chain c holds pixels [c * LED_CHAIN_LEN, (c + 1) * LED_CHAIN_LEN); only
+// chains with a changed pixel are sent
+static bool chainDirty[LED_CHAINS];
+
+#if defined(ARDUINO_ARCH_ESP32) && LED_CHAINS > 1
+#include <driver/rmt.h>
+
+static_assert(LED_CHAINS <= RMT_CHANNEL_MAX, "one RMT channel per LED chain");
+
+static const uint8_t CHAIN_PINS[LED_CHAINS] = LED_CHAIN_PINS;
+static uint8_t chainBuf[LED_CHAINS][LED_CHAIN_LEN * 3];   // GRB, as sent
+
+// WS2812 bits at 40 MHz (clk_div 2): 0 = 0.4 us high + 0.85 us low,
+// 1 = 0.8 us + 0.45 us. Runs in the RMT ISR while the buffer drains.
+static void IRAM_ATTR ws2812ToRmt(const void* src, rmt_item32_t* dest, size_t srcSize, size_t wanted,
+                                  size_t* translated, size_t* items) {
+  if(!src || !dest) { *translated = 0; *items = 0; return; }
+  rmt_item32_t bit0, bit1;
+  bit0.duration0 = 16; bit0.level0 = 1; bit0.duration1 = 34; bit0.level1 = 0;
+  bit1.duration0 = 32; bit1.level0 = 1; bit1.duration1 = 18; bit1.level1 = 0;
+  const uint8_t* p = (const uint8_t*)src;
+  size_t n = 0, k = 0;
+  while(n < srcSize && k + 8 <= wanted) {
+    for(int b=7;b>=0;b--) dest[k++].val = (p[n] >> b) & 1 ? bit1.val : bit0.val;
+    n++;
+  }
+  *translated = n;
+  *items = k;
+}
+
+static void outBegin() {
+  for(uint8_t c=0;c<LED_CHAINS;c++){
+    rmt_config_t cfg = RMT_DEFAULT_CONFIG_TX((gpio_num_t)CHAIN_PINS[c], (rmt_channel_t)c);
+    cfg.clk_div = 2;
+    rmt_config(&cfg);
+    rmt_driver_install(cfg.channel, 0, 0);
+    rmt_translator_init(cfg.channel, ws2812ToRmt);
+    chainDirty[c] = true;                     // first push clears every chain
+  }
+}
+
+static void outSet(uint16_t i, uint32_t c) {
+  uint8_t* p = chainBuf[i / LED_CHAIN_LEN] + (i % LED_CHAIN_LEN) * 3;
+  p[0] = c >> 8; p[1] = c >> 16; p[2] = c;
+  chainDirty[i / LED_CHAIN_LEN] = true;
+}
+
+// start every changed chain, then wait for all: the chains overlap
+static uint8_t outShow() {
+  uint8_t sent = 0;
+  for(uint8_t c=0;c<LED_CHAINS;c++){
+    if(!chainDirty[c]) continue;
+    rmt_write_sample((rmt_channel_t)c, chainBuf[c], sizeof(chainBuf[c]), false);
+    sent++;
+  }
+  for(uint8_t c=0;c<LED_CHAINS;c++){
+    if(!chainDirty[c]) continue;
+    rmt_wait_tx_done((rmt_channel_t)c, portMAX_DELAY);
+    chainDirty[c] = false;
+  }
+  return sent;
+}
+#else
+// one strip over the whole index space (the host, or a single chain on
+// LED_PIN); the chain split is still counted, as the RMT path would send it
+static void outBegin() {
+  strip.begin();
+  strip.clear();
+  strip.show();
+  for(uint8_t c=0;c<LED_CHAINS;c++) chainDirty[c] = false;
+}
+
+static void outSet(uint16_t i, uint32_t c) {
+  strip.setPixelColor(i, c);
+  chainDirty[i / LED_CHAIN_LEN] = true;
+}
+
+static uint8_t outShow() {
+  strip.show();
+  uint8_t sent = 0;
+  for(uint8_t c=0;c<LED_CHAINS;c++){
+    if(chainDirty[c]) sent++;
+    chainDirty[c] = false;
+  }
+  return sent;
+}
+#endif
+
+static bool changed() {
+  for(uint16_t i=0;i<LED_COUNT;i++) if(frame[i] != shown[i]) return true;
+  return false;
+}
+
+// the whole frame is corrected (the limit depends on all of it); only
+// pixels whose output moved are rewritten
+static void push() {
+  static uint32_t next[LED_COUNT];
+  uint32_t sum = 0;
+  for(uint16_t i=0;i<LED_COUNT;i++){
+    next[i] = correct(frame[i]);
+    sum += channelSum(next[i]);
+  }
+  uint32_t ma = LED_COUNT * LED_MA_IDLE + sum * LED_MA_CHANNEL / 255;
+  if(ma > stats.peakMa) stats.peakMa = (uint16_t)(ma < 0xFFFF ? ma : 0xFFFF);
+  if(ma > LED_BUDGET_MA) {
+    uint32_t k = (uint32_t)(LED_BUDGET_MA - LED_COUNT * LED_MA_IDLE) * 255 * 256 / (sum * LED_MA_CHANNEL);
+    for(uint16_t i=0;i<LED_COUNT;i++) next[i] = scaleColor(next[i], k);
+    ma = LED_COUNT * LED_MA_IDLE + (sum * k >> 8) * LED_MA_CHANNEL / 255;
+    stats.limited++;
+  }
+  stats.lastMa = (uint16_t)ma;
+
+  for(uint16_t i=0;i<LED_COUNT;i++){
+    shown[i] = frame[i];
+    if(next[i] == out[i]) continue;
+    outSet(i, next[i]);
+    out[i] = next[i];
+    stats.pixels++;
+  }
+  stats.chains += outShow();
+  stats.pushes++;
+}
+
+// ---------------- API ----------------
+void Leds_lock() {
+#if defined(ARDUINO_ARCH_ESP32)
+  if(ledMutex) xSemaphoreTakeRecursive(ledMutex, portMAX_DELAY);
+#endif
+}
+
+void Leds_unlock() {
+#if defined(ARDUINO_ARCH_ESP32)
+  if(ledMutex) xSemaphoreGiveRecursive(ledMutex);
+#endif
+}
+
+void Leds_begin() {
+#if defined(ARDUINO_ARCH_ESP32)
+  if(!ledMutex) ledMutex = xSemaphoreCreateRecursiveMutex();
+#endif
+  LedsLock lock;
+  outBegin();
+  memset(frame, 0, sizeof(frame));
+  memset(shown, 0, sizeof(shown));
+  memset(out, 0, sizeof(out));
+  stats.lastMa = LED_COUNT * LED_MA_IDLE;
+}
+
+void Leds_set(uint16_t i, uint32_t c) { LedsLock lock; if(i < LED_COUNT) frame[i] = c; }
+
+void Leds_fill(uint32_t c) { LedsLock lock; for(uint16_t i=0;i<LED_COUNT;i++) frame[i] = c; }
+
+void Leds_clear() { LedsLock lock; memset(frame, 0, sizeof(frame)); }
+
+uint32_t Leds_get(uint16_t i) { LedsLock lock; return i < LED_COUNT ? frame[i] : 0; }
+
+void Leds_show() {
+  LedsLock lock;
+  stats.shows++;
+  if(pending) {
+    // the frame waiting for the tick's end will never be seen
+    stats.coalesced++;
+    pending = false;
+  }
+  if(!changed()) { stats.unchanged++; return; }
+  if(pushedThisTick) { pending = true; return; }
+  push();
+  pushedThisTick = true;
+}
+
+bool Leds_showNow() {
+  LedsLock lock;
+  stats.shows++;
+  pending = false;
+  if(!changed()) { stats.unchanged++; return false; }
+  push();
+  return true;
+}
+
+void Leds_flush() {
+  LedsLock lock;
+  if(pending && changed()) push();
+  pending = false;
+  pushedThisTick = false;
+}
+
+void Leds_hold(uint32_t ms) {
+  Leds_flush();
+  delay(ms);
+}
+
+const LedStats& Leds_stats() { return stats; }
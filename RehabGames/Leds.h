@@ -0,0 +1,87 @@
+#pragma once
+#include "Shared.h"
+
+// ---------------- LED frame ----------------
+// Games write a shadow frame (Leds_set / Leds_fill / Leds_clear) and mark it
+// complete with Leds_show(). The strip gets a frame only when some pixel
+// differs from what it latched last, and at most once per tick:
+//   - the first changed frame of a tick goes out at once (no added latency)
+//   - later ones in the same tick replace each other; the last one goes out
+//     at the tick's end (Leds_flush())
+// A tick ends at the end of each loop() pass and wherever the LEDs are
+// held on purpose: Leds_hold(ms) instead of Leds_show() + delay(ms) for
+// blocking blinks, so the frame is out before the wait starts. Coroutines
+// that CO_SLEEP after Leds_show() need nothing more.
+//
+// Each push costs ~30 us per LED with interrupts held off for the RMT
+// refill; identical frames ("ledsOff()" on dark LEDs, a board redrawn after
+// a blink restored it) and frames overwritten within the tick never reach
+// the strip (LedStats).
+//
+// Leds_showNow() pushes a changed frame regardless of the tick: the
+// stimulus timeline (Stimulus.h) latches at planned times, from its timer.
+// On ESP32 that timer runs in its own task, so every Leds_* call holds a
+// recursive mutex; LedsLock keeps it across several calls (a stimulus edge
+// clears, sets and pushes as one step).
+//
+// Output path: every channel goes through one 256-entry table built at
+// compile time, gamma (LED_GAMMA_X10 / 10) then global brightness
+// (LED_BRIGHTNESS), so a colour's mid tones look like its RGB says. The
+// pushed frame's supply current is then estimated (LED_MA_IDLE per LED plus
+// LED_MA_CHANNEL per channel at full duty, linear in duty) and, above
+// LED_BUDGET_MA, the whole frame is scaled down to fit: a green fillAll()
+// on 32 LEDs asks for ~330 mA, a full Color Match board ~460 mA, which
+// the board's USB supply shares with the ESP32 and its radio. Games keep
+// writing uncorrected colours; Leds_get() returns them as written.
+#ifndef LED_GAMMA_X10
+#define LED_GAMMA_X10   22
+#endif
+#ifndef LED_BRIGHTNESS
+#define LED_BRIGHTNESS  255
+#endif
+#ifndef LED_BUDGET_MA
+#define LED_BUDGET_MA   400
+#endif
+static const uint16_t LED_MA_CHANNEL = 20;    // WS2812B, one colour at 255
+static const uint16_t LED_MA_IDLE    = 1;     // per LED, all dark
+
+// Chains (LED_CHAINS in Shared.h): with more than one, each chain has its
+// own RMT channel; a push starts every chain with a changed pixel and then
+// waits for all of them, so a frame takes as long as one chain (~30 us per
+// LED): 8 chains of 16 refresh a 128-LED board in the time 16 LEDs take on
+// one pin. Chains without a change are not sent. One chain uses the
+// Adafruit driver on LED_PIN, as before; the host always does, and counts
+// the chain transfers a -DLED_CHAINS=N build would make (LedStats.chains).
+static const uint16_t LED_CHAIN_LEN = (LED_COUNT + LED_CHAINS - 1) / LED_CHAINS;
+
+struct LedStats {
+  uint32_t shows;         // Leds_show() / Leds_showNow() calls
+  uint32_t pushes;        // frames sent to the strip
+  uint32_t unchanged;     // shows that matched the strip
+  uint32_t coalesced;     // shows overwritten before their tick ended
+  uint32_t pixels;        // changed pixels pushed
+  uint32_t chains;        // chain transfers those pushes took
+  uint32_t limited;       // pushes scaled down to LED_BUDGET_MA
+  uint16_t peakMa;        // highest estimate asked for (before limiting)
+  uint16_t lastMa;        // estimate of the frame on the strip
+};
+
+void     Leds_begin();                     // once, from Shared_setupHardware()
+void     Leds_set(uint16_t i, uint32_t c);
+void     Leds_fill(uint32_t c);
+void     Leds_clear();
+uint32_t Leds_get(uint16_t i);
+
+void Leds_show();                          // frame complete
+bool Leds_showNow();                       // true if the strip was written
+void Leds_flush();                         // end of tick: push a pending frame
+void Leds_hold(uint32_t ms);               // flush, then delay(ms)
+const LedStats& Leds_stats();
+
+void Leds_lock();
+void Leds_unlock();
+
+struct LedsLock {
+  LedsLock() { Leds_lock(); }
+  ~LedsLock() { Leds_unlock(); }
+};
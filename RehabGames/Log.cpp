@@ -0,0 +1,101 @@
+// Log.cpp – binary log ring and its drain task
+#include "Log.h"
+#include <atomic>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+static TaskHandle_t logTask = nullptr;
+static const uint32_t LOG_IDLE_MS = 20;   // drain poll while the ring is empty
+#endif
+
+static const uint16_t RMASK = LOG_RING_BYTES - 1;
+
+static uint8_t ring[LOG_RING_BYTES];
+static std::atomic<uint32_t> head(0);    // free-running byte counters
+static std::atomic<uint32_t> tail(0);
+static std::atomic<uint32_t> dropped(0);
+static uint32_t droppedReported = 0;     // drain side
+static LogStats stats;
+
+void Log_push(LogRec& r) {
+  uint8_t n = r.finish();
+  uint32_t h = head.load(std::memory_order_relaxed);
+  uint32_t fill = h - tail.load(std::memory_order_acquire);
+  if(fill + n > LOG_RING_BYTES) {
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  uint16_t at = h & RMASK;
+  uint16_t first = LOG_RING_BYTES - at < n ? LOG_RING_BYTES - at : n;
+  memcpy(ring + at, r.b, first);
+  memcpy(ring, r.b + first, n - first);
+  head.store(h + n, std::memory_order_release);
+
+  stats.records++;
+  if(fill + n > stats.maxFill) stats.maxFill = (uint16_t)(fill + n);
+}
+
+// whole frames only, so text printed between two writes can't split one
+static bool drain() {
+  uint8_t out[128];
+  uint8_t len = 0;
+  uint32_t t = tail.load(std::memory_order_relaxed);
+  uint32_t h = head.load(std::memory_order_acquire);
+  while(t != h) {
+    uint8_t n = ring[(t + 1) & RMASK] + 3;
+    if(len + n > (int)sizeof(out)) break;
+    for(uint8_t i=0;i<n;i++) out[len++] = ring[(t + i) & RMASK];
+    t += n;
+  }
+  if(len) tail.store(t, std::memory_order_release);
+
+  uint32_t d = dropped.load(std::memory_order_relaxed);
+  if(d != droppedReported && len + LOG_MAX_PAYLOAD + 3u <= sizeof(out)) {
+    LogRec r;
+    r.begin(LOG_ID_SYS_LOG_DROPPED, millis());
+    r.put(d - droppedReported);
+    uint8_t n = r.finish();
+    memcpy(out + len, r.b, n);
+    len += n;
+    stats.dropped += d - droppedReported;
+    droppedReported = d;
+  }
+
+  if(!len) return false;
+  Serial.write((const char*)out, len);
+  stats.bytes += len;
+  return true;
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void logLoop(void*) {
+  for(;;) {
+    if(!drain()) vTaskDelay(pdMS_TO_TICKS(LOG_IDLE_MS));
+  }
+}
+#endif
+
+void Log_begin() {
+#if defined(ARDUINO_ARCH_ESP32)
+  if(logTask) return;
+  xTaskCreatePinnedToCore(logLoop, "log", 2048, nullptr, tskIDLE_PRIORITY, &logTask, 0);
+#endif
+}
+
+void Log_pump() {
+#if defined(ARDUINO_ARCH_ESP32)
+  if(logTask) return;
+#endif
+  while(drain()) {}
+}
+
+const LogStats& Log_stats() { return stats; }
+
+uint32_t Log_stackFree() {
+#if defined(ARDUINO_ARCH_ESP32)
+  return logTask ? uxTaskGetStackHighWaterMark(logTask) : 0;
+#else
+  return 0;
+#endif
+}
@@ -0,0 +1,185 @@
+#pragma once
+#include <Arduino.h>
+#include <string.h>
+#include <type_traits>
+#include "LogFormats.h"
+
+// ---------------- binary logger ----------------
+//   LOG(NET_ERROR, fbdo.errorReason());
+// appends one record (message id, millis(), raw arguments) to a lock-free
+// ring in RAM and returns; nothing is formatted on the device. On ESP32 a
+// priority-0 task on core 0 drains the ring to Serial, so a slow UART only
+// ever stalls that task, never loop(). Without the task (host build)
+// Log_pump() drains at the end of the loop pass. A full ring drops the new
+// record and counts it; the drain reports the count as SYS_LOG_DROPPED.
+//
+// Levels are per module and fixed at compile time (-DLOG_LEVEL_NET=LOG_LVL_DEBUG
+// or edit the defaults below). A message below its module's level compiles
+// to nothing: the arguments are not evaluated and no code is emitted.
+//
+// Single producer: log from the loop task only (render commands must not).
+//
+// On the wire each record is a frame
+//   0x1E  len  id:u16  ms:u32  args...  sum
+// with little-endian integers, floats as their 32-bit pattern, strings as
+// length + bytes, and sum = the low byte of the sum of the len payload bytes.
+// Anything outside frames (MemMon_report, the console) is plain text;
+// host/logdecode.cpp expands the frames and passes the text through.
+
+#define LOG_LVL_OFF   0
+#define LOG_LVL_ERROR 1
+#define LOG_LVL_WARN  2
+#define LOG_LVL_INFO  3
+#define LOG_LVL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LVL_INFO
+#endif
+#ifndef LOG_LEVEL_SYS
+#define LOG_LEVEL_SYS  LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_NET
+#define LOG_LEVEL_NET  LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_GAME
+#define LOG_LEVEL_GAME LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_MEM
+#define LOG_LEVEL_MEM  LOG_LEVEL
+#endif
+
+static const uint8_t  LOG_FRAME_START = 0x1E;        // ASCII record separator
+static const uint8_t  LOG_MAX_PAYLOAD = 64;
+static const uint8_t  LOG_MAX_STR     = 23;
+static const uint16_t LOG_RING_BYTES  = 2048;        // power of two
+
+enum LogId : uint16_t {
+#define LOG_X_ID(id, mod, lvl, fmt) LOG_ID_##id,
+  LOG_FORMATS(LOG_X_ID)
+#undef LOG_X_ID
+  LOG_ID_COUNT
+};
+
+struct LogStats {
+  uint32_t records;
+  uint32_t dropped;
+  uint32_t bytes;        // drained to Serial
+  uint16_t maxFill;      // ring high-water mark, bytes
+};
+
+void Log_begin();                      // from setup(), right after Serial.begin()
+void Log_pump();                       // drain now (no-op while the task runs)
+const LogStats& Log_stats();
+uint32_t Log_stackFree();              // drain task stack never touched, bytes; 0 = no task
+
+// ---------------- compile-time format check ----------------
+// 'i' integer, 'f' float, 's' string for the argument types ...
+template<typename T, typename D = typename std::decay<T>::type> struct LogKind {
+  static const char value = std::is_floating_point<D>::value ? 'f'
+                          : (std::is_integral<D>::value || std::is_enum<D>::value) ? 'i' : '?';
+};
+template<typename T> struct LogKind<T, const char*> { static const char value = 's'; };
+template<typename T> struct LogKind<T, char*>       { static const char value = 's'; };
+template<typename T> struct LogKind<T, String>      { static const char value = 's'; };
+
+// ... and for the conversions of the format
+constexpr const char* logNextConv(const char* f) {
+  return !*f ? f : *f != '%' ? logNextConv(f + 1) : f[1] == '%' ? logNextConv(f + 2) : f + 1;
+}
+constexpr bool logIsMod(char c) {
+  return c == '-' || c == '+' || c == ' ' || c == '#' || c == '.' || c == 'l' || c == 'h' ||
+         (c >= '0' && c <= '9');
+}
+constexpr const char* logConvChar(const char* p) { return logIsMod(*p) ? logConvChar(p + 1) : p; }
+constexpr char logConvKind(char c) {
+  return c == 's' ? 's'
+       : (c == 'f' || c == 'e' || c == 'g') ? 'f'
+       : (c == 'd' || c == 'i' || c == 'u' || c == 'x' || c == 'X' || c == 'c') ? 'i' : '?';
+}
+
+template<typename... A> struct LogSig {
+  static constexpr bool ok(const char* f) { return !*logNextConv(f); }
+};
+template<typename H, typename... T> struct LogSig<H, T...> {
+  static constexpr bool ok(const char* f) {
+    return *logNextConv(f) && logConvKind(*logConvChar(logNextConv(f))) == LogKind<H>::value &&
+           LogSig<T...>::ok(logConvChar(logNextConv(f)) + 1);
+  }
+};
+
+// largest payload the argument types can produce
+template<typename... A> struct LogSize { static const size_t value = 0; };
+template<typename H, typename... T> struct LogSize<H, T...> {
+  static const size_t value = (LogKind<H>::value == 's' ? 1 + LOG_MAX_STR : 4) + LogSize<T...>::value;
+};
+
+// ---------------- encoding ----------------
+struct LogRec {
+  uint8_t b[LOG_MAX_PAYLOAD + 3];
+  uint8_t n;
+
+  void begin(uint16_t id, uint32_t ms) {
+    b[0] = LOG_FRAME_START;
+    n = 2;
+    b[n++] = (uint8_t)id; b[n++] = (uint8_t)(id >> 8);
+    u32(ms);
+  }
+  void u32(uint32_t v) {
+    b[n++] = (uint8_t)v; b[n++] = (uint8_t)(v >> 8);
+    b[n++] = (uint8_t)(v >> 16); b[n++] = (uint8_t)(v >> 24);
+  }
+  void str(const char* s) {
+    size_t len = s ? strlen(s) : 0;
+    if(len > LOG_MAX_STR) len = LOG_MAX_STR;
+    b[n++] = (uint8_t)len;
+    memcpy(b + n, s, len);
+    n += (uint8_t)len;
+  }
+  // closes the frame; returns its total size
+  uint8_t finish() {
+    uint8_t sum = 0;
+    for(uint8_t i=2;i<n;i++) sum += b[i];
+    b[1] = (uint8_t)(n - 2);
+    b[n++] = sum;
+    return n;
+  }
+
+  template<typename T>
+  typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type put(T v) { u32((uint32_t)v); }
+  template<typename T>
+  typename std::enable_if<std::is_floating_point<T>::value>::type put(T v) {
+    float f = (float)v;
+    uint32_t u;
+    memcpy(&u, &f, 4);
+    u32(u);
+  }
+  void put(const char* s)   { str(s); }
+  void put(const String& s) { str(s.c_str()); }
+
+  void args() {}
+  template<typename H, typename... T>
+  void args(const H& h, const T&... t) { put(h); args(t...); }
+};
+
+void Log_push(LogRec& r);              // LOG() only
+
+#define LOG_X_DEF(id, mod, lvl, fmt_) \
+  struct LogDef_##id { \
+    static const uint16_t id_ = LOG_ID_##id; \
+    static const bool enabled = LOG_LVL_##lvl <= LOG_LEVEL_##mod; \
+    static constexpr const char* fmt = fmt_; \
+  };
+LOG_FORMATS(LOG_X_DEF)
+#undef LOG_X_DEF
+
+template<typename D, typename... A>
+inline void Log_emit(const A&... a) {
+  static_assert(LogSig<A...>::ok(D::fmt), "LOG arguments don't match the format in LogFormats.h");
+  static_assert(6 + LogSize<A...>::value <= LOG_MAX_PAYLOAD, "LOG record too long");
+  LogRec r;
+  r.begin(D::id_, millis());
+  r.args(a...);
+  Log_push(r);
+}
+
+#define LOG(id, ...) do { if(LogDef_##id::enabled) Log_emit<LogDef_##id>(__VA_ARGS__); } while(0)
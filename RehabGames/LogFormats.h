@@ -0,0 +1,29 @@
+#pragma once
+
+// ---------------- log message table ----------------
+// X(id, module, level, format). The firmware only ever stores the id and the
+// arguments; the text lives here and is expanded by the host decoder
+// (host/logdecode.cpp), so formats cost no flash. Ids are the row index:
+// append new rows, and decode with a rehab_logdecode built from the same
+// revision as the firmware.
+//
+// Conversions: %d %i %u %x %X %c (32-bit), %f %e %g (float), %s (up to
+// LOG_MAX_STR chars). Flags, width and precision are fine; LOG() checks the
+// argument kinds against the format at compile time.
+
+#define LOG_FORMATS(X) \
+  X(SYS_LOG_DROPPED,     SYS,  WARN,  "log: %u records dropped (ring full)") \
+  X(NET_SIGNUP_OK,       NET,  INFO,  "Firebase anonymous signup OK") \
+  X(NET_SIGNUP_FAILED,   NET,  WARN,  "Firebase signup failed: %s") \
+  X(NET_CONFIGURED,      NET,  INFO,  "Firebase configured (offline-first)") \
+  X(NET_SCORE_SENT,      NET,  INFO,  "score sent to Firebase") \
+  X(NET_SESSION_SENT,    NET,  INFO,  "session sent to Firebase") \
+  X(NET_ERROR,           NET,  WARN,  "Firebase error: %s") \
+  X(NET_SCORE_BUFFERED,  NET,  INFO,  "stored score offline (%u buffered)") \
+  X(NET_SCORE_DROPPED,   NET,  WARN,  "score buffer full: score dropped") \
+  X(NET_SESSION_DROPPED, NET,  WARN,  "session buffer full: oldest dropped") \
+  X(NET_SYNC_START,      NET,  INFO,  "syncing offline buffer (%u scores)") \
+  X(NET_SYNC_DONE,       NET,  INFO,  "offline buffer cleared") \
+  X(GAME_SESSION,        GAME, INFO,  "session %s L%u: n=%u ok=%u miss=%u rt mean=%.1f sd=%.1f p50=%.1f p90=%.1f ms") \
+  X(MEM_LOW,             MEM,  WARN,  "mem: %s %u B (< %u B)") \
+  X(GAME_SEED,           GAME, INFO,  "session seed %08x (replay: seed %x)")
@@ -0,0 +1,173 @@
+// MemMon.cpp – heap / stack sampling, minute ring and threshold warnings
+#include "MemMon.h"
+#include "Coop.h"
+#include "Render.h"
+#include "Log.h"
+
+static MemSample last;
+static MemSlot   ring[MEM_SLOTS];
+static uint8_t   head = 0;           // slot being filled
+static uint8_t   used = 0;
+static uint32_t  slotStartMs = 0;
+static uint8_t   raised = 0;
+static uint32_t  warnCount = 0;
+static MemLow    low;
+static CoopTimer timer;
+
+static const char* const TASK_NAMES[MEM_TASKS] = {
+  "loop", "render", "log", "esp_timer", "wifi", "tiT", "arduino_events"
+};
+
+// ---------------- platform ----------------
+#if defined(ARDUINO_ARCH_ESP32)
+// tasks the sketch did not create, looked up by name until they exist
+static TaskHandle_t sysTask[MEM_TASKS];
+
+static uint32_t sysStackFree(uint8_t t) {
+  if(!sysTask[t]) sysTask[t] = xTaskGetHandle(TASK_NAMES[t]);
+  return sysTask[t] ? uxTaskGetStackHighWaterMark(sysTask[t]) : 0;
+}
+#endif
+
+static void readNow(MemSample& s) {
+  s.freeHeap     = ESP.getFreeHeap();
+  s.largestBlock = ESP.getMaxAllocHeap();
+  s.minFreeHeap  = ESP.getMinFreeHeap();
+  memset(s.stack, 0, sizeof(s.stack));
+#if defined(ARDUINO_ARCH_ESP32)
+  s.stack[MEM_TASK_LOOP] = uxTaskGetStackHighWaterMark(nullptr);   // bytes in ESP-IDF
+  for(uint8_t t=MEM_TASK_TIMER;t<MEM_TASKS;t++) s.stack[t] = sysStackFree(t);
+#endif
+  s.stack[MEM_TASK_RENDER] = Render_stackFree();
+  s.stack[MEM_TASK_LOG]    = Log_stackFree();
+}
+
+// ---------------- ring ----------------
+static uint16_t min16(uint16_t a, uint32_t b) { return b < a ? (uint16_t)b : a; }
+
+// 0 (no such task) leaves the minimum at 0xFFFF
+static void foldStacks(uint16_t mins[MEM_TASKS], const MemSample& s) {
+  for(uint8_t t=0;t<MEM_TASKS;t++) if(s.stack[t]) mins[t] = min16(mins[t], s.stack[t]);
+}
+
+static void openSlot(const MemSample& s) {
+  MemSlot& m = ring[head];
+  m.freeMin = m.freeMax = s.freeHeap;
+  m.blockMin = s.largestBlock;
+  for(uint8_t t=0;t<MEM_TASKS;t++) m.stackMin[t] = 0xFFFF;
+  m.samples = 0;
+  if(used < MEM_SLOTS) used++;
+  slotStartMs = millis();
+}
+
+static void fold(const MemSample& s) {
+  if(used == 0) openSlot(s);
+  else if(millis() - slotStartMs >= MEM_SLOT_MS) {
+    head = (uint8_t)((head + 1) % MEM_SLOTS);
+    openSlot(s);
+  }
+  MemSlot& m = ring[head];
+  if(s.freeHeap < m.freeMin) m.freeMin = s.freeHeap;
+  if(s.freeHeap > m.freeMax) m.freeMax = s.freeHeap;
+  if(s.largestBlock < m.blockMin) m.blockMin = s.largestBlock;
+  foldStacks(m.stackMin, s);
+  m.samples++;
+
+  if(s.freeHeap < low.freeMin) low.freeMin = s.freeHeap;
+  if(s.largestBlock < low.blockMin) low.blockMin = s.largestBlock;
+  foldStacks(low.stackMin, s);
+}
+
+static void clearLow() {
+  low.freeMin = low.blockMin = 0xFFFFFFFFu;
+  for(uint8_t t=0;t<MEM_TASKS;t++) low.stackMin[t] = 0xFFFF;
+}
+
+// ---------------- warnings ----------------
+static void check(uint8_t bit, uint32_t v, uint32_t limit, const char* what) {
+  if(!(raised & bit)) {
+    if(v >= limit) return;
+    raised |= bit;
+    warnCount++;
+    LOG(MEM_LOW, what, v, limit);
+  } else if(v >= limit + limit / 4) {
+    raised &= ~bit;
+  }
+}
+
+// one bit for all tasks: the tightest one raises and re-arms it
+static void checkStack(const MemSample& s) {
+  int8_t worst = -1;
+  for(uint8_t t=0;t<MEM_TASKS;t++) {
+    if(s.stack[t] && (worst < 0 || s.stack[t] < s.stack[worst])) worst = (int8_t)t;
+  }
+  if(worst < 0) return;
+  char what[32];
+  snprintf(what, sizeof(what), "stack %s", TASK_NAMES[worst]);
+  check(MEM_WARN_STACK, s.stack[worst], MEM_LOW_STACK, what);
+}
+
+// ---------------- API ----------------
+static void onTimer(CoopTimer&) { MemMon_sample(); }
+
+void MemMon_begin() {
+  used = 0;
+  head = 0;
+  raised = 0;
+  clearLow();
+  MemMon_sample();
+  Coop_arm(timer, MEM_SAMPLE_MS, onTimer, MEM_SAMPLE_MS);
+}
+
+void MemMon_sample() {
+  readNow(last);
+  fold(last);
+  check(MEM_WARN_HEAP, last.freeHeap, MEM_LOW_FREE, "free heap");
+  check(MEM_WARN_FRAG, last.largestBlock, MEM_LOW_BLOCK, "largest block");
+  checkStack(last);
+}
+
+const MemSample& MemMon_last() { return last; }
+uint8_t  MemMon_warnings() { return raised; }
+uint32_t MemMon_warnCount() { return warnCount; }
+uint8_t  MemMon_slotCount() { return used; }
+
+const MemSlot& MemMon_slot(uint8_t age) {
+  if(age >= used) age = used ? used - 1 : 0;
+  return ring[(head + MEM_SLOTS - age) % MEM_SLOTS];
+}
+
+MemLow MemMon_takeLow() {
+  MemLow r = low;
+  clearLow();
+  return r;
+}
+
+const char* MemMon_taskName(uint8_t t) { return t < MEM_TASKS ? TASK_NAMES[t] : "?"; }
+
+void MemMon_report(Print& out) {
+  MemMon_sample();
+  const MemSample& s = last;
+  out.printf("mem: free %u B, largest block %u B, min free %u B since boot\n",
+             (unsigned)s.freeHeap, (unsigned)s.largestBlock, (unsigned)s.minFreeHeap);
+  out.print("stack free (B, 0 = n/a):");
+  for(uint8_t t=0;t<MEM_TASKS;t++) out.printf(" %s %u", TASK_NAMES[t], (unsigned)s.stack[t]);
+  out.println();
+  out.printf("warnings: heap=%d frag=%d stack=%d, %u raised since boot\n",
+             (raised & MEM_WARN_HEAP) ? 1 : 0, (raised & MEM_WARN_FRAG) ? 1 : 0,
+             (raised & MEM_WARN_STACK) ? 1 : 0, (unsigned)warnCount);
+  // stack columns: the minimum per task over the slot, "-" = no such task
+  out.printf("%5s %9s %9s %9s", "age_m", "free_min", "free_max", "blk_min");
+  for(uint8_t t=0;t<MEM_TASKS;t++) out.printf(" %6.6s", TASK_NAMES[t]);
+  out.println();
+  for(uint8_t i=0;i<used;i++) {
+    const MemSlot& m = MemMon_slot(i);
+    out.printf("%5u %9u %9u %9u", (unsigned)(i * (MEM_SLOT_MS / 60000)),
+               (unsigned)m.freeMin, (unsigned)m.freeMax, (unsigned)m.blockMin);
+    for(uint8_t t=0;t<MEM_TASKS;t++) {
+      if(m.stackMin[t] == 0xFFFF) out.printf(" %6s", "-");
+      else out.printf(" %6u", (unsigned)m.stackMin[t]);
+    }
+    out.println();
+  }
+}
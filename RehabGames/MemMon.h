@@ -0,0 +1,68 @@
+#pragma once
+#include "Shared.h"
+
+// ---------------- Memory monitor ----------------
+// Every 10 s (Coop timer, loop task): free heap, largest free block, the
+// allocator's all-time minimum, and the stack high-water mark of every task
+// in MemTask: loop(), the render and log tasks, esp_timer (the stimulus
+// timeline's callbacks) and the WiFi driver, lwIP and Arduino event tasks
+// the Firebase client runs on. Samples fold into one ring slot per 2
+// minutes (min of everything, max of free heap, per task); 32 slots cover
+// the last hour. Crossing
+// a threshold prints one warning; it re-arms once the value is back above
+// threshold + 25 %:
+//   free heap < 24 KB     - the next large allocation (TLS, JSON) may fail
+//   largest block < 8 KB  - fragmentation: free heap is there, but in pieces
+//   stack headroom < 512 B  - any task; the warning names it
+// "mem" on the serial console prints the last sample, the ring and the
+// warnings. reportSession() attaches the low-water marks since the previous
+// session to the summary (RtSummary::memFreeMin, stackFreeMin[] per task).
+
+static const uint32_t MEM_SAMPLE_MS   = 10000;
+static const uint32_t MEM_SLOT_MS     = 120000;
+static const uint8_t  MEM_SLOTS       = 32;
+
+static const uint32_t MEM_LOW_FREE    = 24 * 1024;
+static const uint32_t MEM_LOW_BLOCK   = 8 * 1024;
+static const uint32_t MEM_LOW_STACK   = 512;
+
+// a task that does not exist (yet: WiFi before the first connect; the host
+// build has none) reads 0 in samples and 0xFFFF in minima
+enum MemTask : uint8_t {
+  MEM_TASK_LOOP, MEM_TASK_RENDER, MEM_TASK_LOG, MEM_TASK_TIMER,
+  MEM_TASK_WIFI, MEM_TASK_TCPIP, MEM_TASK_EVENTS, MEM_TASKS
+};
+
+struct MemSample {
+  uint32_t freeHeap;
+  uint32_t largestBlock;
+  uint32_t minFreeHeap;      // allocator low-water mark since boot
+  uint32_t stack[MEM_TASKS]; // bytes never touched; 0 = not available
+};
+
+struct MemSlot {
+  uint32_t freeMin, freeMax;
+  uint32_t blockMin;
+  uint16_t stackMin[MEM_TASKS];
+  uint16_t samples;
+};
+
+// low-water marks over a window (one session)
+struct MemLow {
+  uint32_t freeMin;
+  uint32_t blockMin;
+  uint16_t stackMin[MEM_TASKS];   // 0xFFFF = not available
+};
+
+enum MemWarn : uint8_t { MEM_WARN_HEAP = 1, MEM_WARN_FRAG = 2, MEM_WARN_STACK = 4 };
+
+void MemMon_begin();                   // once, from setup(); takes the first sample
+void MemMon_sample();                  // the timer's job; fine to call any time
+const MemSample& MemMon_last();
+uint8_t  MemMon_warnings();            // MEM_WARN_* currently raised
+uint32_t MemMon_warnCount();           // warnings printed since boot
+uint8_t  MemMon_slotCount();
+const MemSlot& MemMon_slot(uint8_t age);   // 0 = current slot
+MemLow   MemMon_takeLow();             // since the last call, then restarts
+void     MemMon_report(Print& out);    // the "mem" command
+const char* MemMon_taskName(uint8_t t);
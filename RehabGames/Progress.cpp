@@ -0,0 +1,117 @@
+// Progress.cpp – countdown bars painted by difference
+#include "Progress.h"
+#include "Render.h"
+
+static ProgressStats stats;
+
+// geometry and epoch as of the post; the bar itself only for the
+// renderer's shown* fields
+struct ProgressCmd {
+  ProgressBar* bar;
+  ProgressGeom g;
+  int16_t      px;
+  uint16_t     color;
+  uint8_t      epoch;
+};
+
+// ---------------- track outline ----------------
+// The rows TFT_eSPI's fillRoundRect leaves out at the top of its first r
+// columns (bottom and right side are mirror images), so columns painted
+// one by one line up with a track painted in one go.
+static void markRow(uint8_t* inset, uint8_t r, int32_t fromCol, int32_t row) {
+  for(int32_t c=fromCol<0?0:fromCol;c<r;c++) if(row < inset[c]) inset[c] = (uint8_t)row;
+}
+
+static void cornerInset(uint8_t r, uint8_t* inset) {
+  for(uint8_t c=0;c<r;c++) inset[c] = r;
+  // fillCircleHelper(r, r, r, corner 2): the same steps, keeping only the line starts
+  int32_t f = 1 - r, ddF_x = 1, ddF_y = -r - r, y = 0, rr = r;
+  while(y < rr) {
+    if(f >= 0) {
+      markRow(inset, r, r - y, r - rr);
+      rr--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    y++;
+    ddF_x += 2;
+    f += ddF_x;
+    markRow(inset, r, r - rr, r - y);
+  }
+}
+
+// columns [a, e) of the track outline in one colour
+static uint32_t paintCols(const ProgressGeom& b, int16_t a, int16_t e, uint16_t color) {
+  uint32_t px = 0;
+  while(a < e) {
+    if(a >= b.r && a < b.w - b.r) {
+      int16_t end = e < b.w - b.r ? e : b.w - b.r;
+      tft.fillRect(b.x + a, b.y, end - a, b.h, color);
+      px += (uint32_t)(end - a) * b.h;
+      a = end;
+      continue;
+    }
+    int16_t in = b.inset[a < b.r ? a : b.w - 1 - a];
+    if(b.h > 2 * in) {
+      tft.drawFastVLine(b.x + a, b.y + in, b.h - 2 * in, color);
+      px += b.h - 2 * in;
+    }
+    a++;
+  }
+  return px;
+}
+
+// ---------------- renderer ----------------
+static void paintProgress(const ProgressCmd& c) {
+  ProgressBar& b = *c.bar;
+  const ProgressGeom& g = c.g;
+  uint32_t px = 0;
+  tft.startWrite();
+  if(b.shownEpoch != c.epoch) {
+    paintCols(g, 0, c.px, c.color);
+    paintCols(g, c.px, g.w, g.track);
+    b.shownEpoch = c.epoch;
+    stats.fullPaints++;
+  } else {
+    if(c.color != b.shownColor) px += paintCols(g, 0, c.px < b.shownPx ? c.px : b.shownPx, c.color);
+    if(c.px > b.shownPx)      px += paintCols(g, b.shownPx, c.px, c.color);
+    else if(c.px < b.shownPx) px += paintCols(g, c.px, b.shownPx, g.track);
+  }
+  tft.endWrite();
+  b.shownPx = c.px;
+  b.shownColor = c.color;
+  stats.pixels += px;
+}
+
+// ---------------- API ----------------
+void Progress_begin(ProgressBar& b, int16_t x, int16_t y, int16_t w, int16_t h, uint8_t r, uint16_t track) {
+  if(r > PROGRESS_MAX_R) r = PROGRESS_MAX_R;
+  if(r > h / 2) r = (uint8_t)(h / 2);
+  if(r > w / 2) r = (uint8_t)(w / 2);
+  b.g.x = x; b.g.y = y; b.g.w = w; b.g.h = h;
+  b.g.r = r;
+  b.g.track = track;
+  cornerInset(r, b.g.inset);
+  b.epoch++;
+  b.postedPx = -1;
+  b.nextMs = millis();
+}
+
+bool Progress_set(ProgressBar& b, uint32_t num, uint32_t den, uint16_t color) {
+  uint32_t now = millis();
+  if((int32_t)(now - b.nextMs) < 0) return false;
+  b.nextMs = now + PROGRESS_FRAME_MS;
+
+  if(num > den) num = den;
+  int16_t px = den ? (int16_t)((uint64_t)b.g.w * num / den) : 0;
+  if(px == 0) color = b.g.track;
+  if(px == b.postedPx && color == b.postedColor) return false;
+  b.postedPx = px;
+  b.postedColor = color;
+
+  ProgressCmd c = { &b, b.g, px, color, b.epoch };
+  stats.frames++;
+  return Render_post<ProgressCmd, paintProgress>(RK_TIMEBAR, c);
+}
+
+const ProgressStats& Progress_stats() { return stats; }
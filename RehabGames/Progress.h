@@ -0,0 +1,56 @@
+#pragma once
+#include "Shared.h"
+
+// ---------------- Progress bars ----------------
+// The games' countdown bars. A bar is a rounded track; the fill grows from
+// the left, keeps the track's outline and has a square leading edge, so a
+// step only changes the columns it crosses. The renderer remembers what is
+// on the panel and paints just the difference:
+//   - fill shrank / grew: the columns in between, in track / fill colour
+//     (one fillRect, plus one line per corner column at the ends)
+//   - colour changed (green -> amber -> red, blink = fill in track colour):
+//     the filled columns only
+// Progress_set() runs at most once per PROGRESS_FRAME_MS (60 Hz) and posts
+// only when the pixels would change; a 3 s countdown over 260 px costs
+// ~5 columns per frame instead of two full round rects.
+//
+// Progress_begin() after the track area was (or is about to be) painted
+// over: the next frame draws the whole bar. It goes through the render
+// queue under RK_TIMEBAR, so coalesced frames are harmless: each command
+// carries the full target state.
+
+static const uint32_t PROGRESS_FRAME_MS = 16;
+static const uint8_t  PROGRESS_MAX_R    = 8;
+
+// where the bar is and what its track looks like; each frame carries a
+// copy, so Progress_begin() may move the bar while frames are queued
+struct ProgressGeom {
+  int16_t  x, y, w, h;
+  uint8_t  r;
+  uint16_t track;
+  uint8_t  inset[PROGRESS_MAX_R];   // corner column -> rows cut off at top and bottom
+};
+
+struct ProgressBar {
+  ProgressGeom g;
+  // loop side
+  uint8_t  epoch;
+  int16_t  postedPx;
+  uint16_t postedColor;
+  uint32_t nextMs;
+  // renderer side
+  uint8_t  shownEpoch;
+  int16_t  shownPx;
+  uint16_t shownColor;
+};
+
+struct ProgressStats {
+  uint32_t frames;        // posted
+  uint32_t fullPaints;
+  uint32_t pixels;        // painted by the other frames (the difference)
+};
+
+void Progress_begin(ProgressBar& b, int16_t x, int16_t y, int16_t w, int16_t h, uint8_t r, uint16_t track);
+// fill = num/den of the width; true if a frame was posted
+bool Progress_set(ProgressBar& b, uint32_t num, uint32_t den, uint16_t color);
+const ProgressStats& Progress_stats();
@@ -1,13 +1,23 @@
 #include "Shared.h"
+#include "Coop.h"
+#include "Render.h"
 #include "Game1_FollowLight.h"
 #include "Game2_MemorySequence.h"
 #include "Game3_ColorMatch.h"
+#include "RtStats.h"
+#include "Rfid.h"
+#include "MemMon.h"
+#include "Log.h"
+#include "ScreenCache.h"
+#include "DrawList.h"
+#include "Leds.h"
+#include "Rng.h"
 
 #include <WiFi.h>
 #include <Firebase_ESP_Client.h>
 
 // ===================== SETTINGS =====================
-#define DEBUG_SERIAL 1
+// Serial diagnostics: LOG_LEVEL / LOG_LEVEL_<module> in Log.h
 
 // ---------- WIFI ----------
 #define WIFI_SSID       "meanwhile nothing"
@@ -43,6 +53,11 @@ struct ScoreEvent {
 ScoreEvent scoreBuffer[MAX_BUFFERED_EVENTS];
 int bufferCount = 0;
 
+// session summaries are ~100 B each; keep the last few
+#define MAX_BUFFERED_SESSIONS 8
+RtSummary sessionBuffer[MAX_BUFFERED_SESSIONS];
+int sessionCount = 0;
+
 // ===================== MENU UI COLORS (565) =====================
 static const uint16_t C_BG     = 0x08A3;
 static const uint16_t C_PANEL2 = 0x18E7;
@@ -74,26 +89,33 @@ static void fillGradV(int x, int y, int w, int h, uint16_t top, uint16_t bot, in
     uint8_t t = (uint32_t)i * 255 / (h - 1);
     uint16_t c = blend565(top, bot, t);
     tft.fillRect(x, y + i, w, step, c);
+    SpiBus_yield(SPI_DEV_TFT);
   }
 }
 
 static void drawBackground() {
   fillGradV(0, 0, SCREEN_W, SCREEN_H, C_BG, 0x0008, 2);
-  for (int i = 0; i < 18; i++) tft.drawPixel(random(0, SCREEN_W), random(0, SCREEN_H), TFT_WHITE);
+  for (int i = 0; i < 18; i++) tft.drawPixel(Rng_decor(0, SCREEN_W), Rng_decor(0, SCREEN_H), TFT_WHITE);
 }
 
-static void uiButton(int x, int y, int w, int h, uint16_t bg, const char* label) {
-  tft.fillRoundRect(x + 3, y + 3, w, h, 16, TFT_BLACK);
-  tft.fillRoundRect(x, y, w, h, 16, bg);
-  tft.drawRoundRect(x, y, w, h, 16, TFT_WHITE);
+static void uiButton(DrawList& dl, int x, int y, int w, int h, uint16_t bg, const char* label) {
+  dl.fillRoundRect(x + 3, y + 3, w, h, 16, TFT_BLACK);
+  dl.fillRoundRect(x, y, w, h, 16, bg);
+  dl.drawRoundRect(x, y, w, h, 16, TFT_WHITE);
+
+  dl.setTextDatum(MC_DATUM);
+  dl.setTextFont(4);
+  dl.setTextColor(TFT_BLACK, bg);
+  dl.drawString(label, x + w / 2 + 1, y + h / 2 + 1);
+  dl.setTextColor(TFT_WHITE, bg);
+  dl.drawString(label, x + w / 2, y + h / 2);
+  dl.setTextDatum(TL_DATUM);
+}
 
-  tft.setTextDatum(MC_DATUM);
-  tft.setTextFont(4);
-  tft.setTextColor(TFT_BLACK, bg);
-  tft.drawString(label, x + w / 2 + 1, y + h / 2 + 1);
-  tft.setTextColor(TFT_WHITE, bg);
-  tft.drawString(label, x + w / 2, y + h / 2);
-  tft.setTextDatum(TL_DATUM);
+static void uiButton(int x, int y, int w, int h, uint16_t bg, const char* label) {
+  DrawList dl;
+  uiButton(dl, x, y, w, h, bg, label);
+  DrawList_run(dl);
 }
 
 // ===================== FIREBASE / OFFLINE MODE =====================
@@ -115,19 +137,16 @@ void Firebase_initOfflineFirst() {
   // Anonymous sign-up (recommended by library examples)
   // This does not block forever; if it fails, we can still run offline.
   if (Firebase.signUp(&config, &auth, "", "")) {
-    if (DEBUG_SERIAL) Serial.println("Firebase anonymous signup OK");
+    LOG(NET_SIGNUP_OK);
   } else {
-    if (DEBUG_SERIAL) {
-      Serial.print("Firebase signup failed: ");
-      Serial.println(config.signer.signupError.message.c_str());
-    }
+    LOG(NET_SIGNUP_FAILED, config.signer.signupError.message.c_str());
   }
 
   Firebase.begin(&config, &auth);
   Firebase.reconnectWiFi(true);
 
   firebaseConfigured = true;
-  if (DEBUG_SERIAL) Serial.println("Firebase configured (offline-first)");
+  LOG(NET_CONFIGURED);
 }
 
 void sendScoreToFirebase(int coins, int score, unsigned long ts) {
@@ -141,15 +160,10 @@ void sendScoreToFirebase(int coins, int score, unsigned long ts) {
 
   // This path is simple and good for submission:
   // /scores/<auto_id> = { coins, score, timestamp, device }
-  String path = "/scores";
-
-  if (Firebase.RTDB.pushJSON(&fbdo, path.c_str(), &json)) {
-    if (DEBUG_SERIAL) Serial.println("✅ Score sent to Firebase");
+  if (Firebase.RTDB.pushJSON(&fbdo, "/scores", &json)) {
+    LOG(NET_SCORE_SENT);
   } else {
-    if (DEBUG_SERIAL) {
-      Serial.print("❌ Firebase error: ");
-      Serial.println(fbdo.errorReason());
-    }
+    LOG(NET_ERROR, fbdo.errorReason());
   }
 }
 
@@ -165,16 +179,96 @@ void reportScore(int coins, int score) {
   // Offline → store in RAM buffer
   if (bufferCount < MAX_BUFFERED_EVENTS) {
     scoreBuffer[bufferCount++] = { coins, score, ts };
-    if (DEBUG_SERIAL) Serial.println("Stored score OFFLINE (buffered)");
+    LOG(NET_SCORE_BUFFERED, bufferCount);
   } else {
-    if (DEBUG_SERIAL) Serial.println("⚠ Buffer full: score dropped");
+    LOG(NET_SCORE_DROPPED);
+  }
+}
+
+bool sendSessionToFirebase(const RtSummary& s) {
+  if (!isOnline()) return false;
+
+  FirebaseJson json;
+  json.set("game", RtStats_gameName(s.game));
+  json.set("level", s.level + 1);
+  json.set("responses", s.responses);
+  json.set("correct", s.correct);
+  json.set("misses", s.misses);
+  json.set("rt/mean_ms", s.meanMs);
+  json.set("rt/sd_ms", s.sdMs);
+  json.set("rt/p50_ms", s.p50Ms);
+  json.set("rt/p90_ms", s.p90Ms);
+  json.set("rt/min_ms", s.minMs);
+  json.set("rt/max_ms", s.maxMs);
+  json.set("score", s.score);
+  json.set("coins", s.coins);
+  json.set("timestamp", (int)s.ts);
+  json.set("device", DEVICE_ID);
+  json.set("mem/free_min", (int)s.memFreeMin);
+  json.set("mem/block_min", (int)s.memBlockMin);
+
+  // mem/stack_min/<task> = stack headroom low-water mark (B) during the session
+  char key[32];
+  for (int t = 0; t < MEM_TASKS; t++) {
+    if (s.stackFreeMin[t] == 0xFFFF) continue;
+    snprintf(key, sizeof(key), "mem/stack_min/%s", MemMon_taskName(t));
+    json.set(key, (int)s.stackFreeMin[t]);
+  }
+
+  snprintf(key, sizeof(key), "%08lx", (unsigned long)s.seed);
+  json.set("seed", key);   // as typed on the console to replay it
+
+  // zones/<led> = mean reaction time (ms) on that LED
+  for (int i = 0; i < s.zoneCount; i++) {
+    snprintf(key, sizeof(key), "zones/%u", s.zones[i].led);
+    json.set(key, (int)s.zones[i].meanMs);
+  }
+
+  // /sessions/<auto_id> = one summary per played session
+  if (Firebase.RTDB.pushJSON(&fbdo, "/sessions", &json)) {
+    LOG(NET_SESSION_SENT);
+    return true;
   }
+  LOG(NET_ERROR, fbdo.errorReason());
+  return false;
+}
+
+// ✅ CALL THIS FROM GAMES when a session ends (RtStats_endSession)
+void reportSession(const RtSummary& summary) {
+  RtSummary s = summary;
+  MemLow low = MemMon_takeLow();
+  s.memFreeMin = low.freeMin;
+  s.memBlockMin = low.blockMin;
+  memcpy(s.stackFreeMin, low.stackMin, sizeof(s.stackFreeMin));
+  s.seed = Rng_sessionSeed();
+
+  LOG(GAME_SESSION, RtStats_gameName(s.game), s.level + 1, s.responses, s.correct, s.misses,
+      s.meanMs, s.sdMs, s.p50Ms, s.p90Ms);
+  LOG(GAME_SEED, s.seed, s.seed);
+  Rfid_save();   // reader health counters, at most once per session
+
+  if (sendSessionToFirebase(s)) return;
+
+  // Offline → keep the newest summaries
+  if (sessionCount == MAX_BUFFERED_SESSIONS) {
+    memmove(sessionBuffer, sessionBuffer + 1, sizeof(RtSummary) * (MAX_BUFFERED_SESSIONS - 1));
+    sessionCount--;
+    LOG(NET_SESSION_DROPPED);
+  }
+  sessionBuffer[sessionCount++] = s;
 }
 
 void syncOfflineBuffer() {
+  while (sessionCount > 0 && isOnline()) {
+    if (!sendSessionToFirebase(sessionBuffer[0])) break;
+    memmove(sessionBuffer, sessionBuffer + 1, sizeof(RtSummary) * (sessionCount - 1));
+    sessionCount--;
+    delay(120);
+  }
+
   if (!isOnline() || bufferCount == 0) return;
 
-  if (DEBUG_SERIAL) Serial.println("🔄 Syncing offline buffer...");
+  LOG(NET_SYNC_START, bufferCount);
 
   for (int i = 0; i < bufferCount; i++) {
     sendScoreToFirebase(scoreBuffer[i].coins, scoreBuffer[i].score, scoreBuffer[i].ts);
@@ -182,14 +276,13 @@ void syncOfflineBuffer() {
   }
 
   bufferCount = 0;
-  if (DEBUG_SERIAL) Serial.println("✅ Offline buffer cleared");
+  LOG(NET_SYNC_DONE);
 }
 
 // ===================== MENU NAVIGATION =====================
 
 // ✅ IMPORTANT: not static (so games can call goMenu if they want)
-void drawMenu() {
-  strip.clear(); strip.show();
+static void paintMenu() {
   drawBackground();
 
   tft.setTextDatum(MC_DATUM);
@@ -207,6 +300,11 @@ void drawMenu() {
   uiButton(BTN_X, BTN3_Y, BTN_W, BTN_H, C_BAD,  "COLOR MATCH");
 }
 
+void drawMenu() {
+  Leds_clear(); Leds_show();
+  ScreenCache_draw(SCREEN_MENU, paintMenu);
+}
+
 void goMenu() {
   g_screen = SCR_MENU;
   drawMenu();
@@ -221,42 +319,76 @@ void goGame(AppScreen s) {
 
 // ===================== ARDUINO =====================
 
+static CoopTimer syncTimer;
+static void onSyncTimer(CoopTimer&) { syncOfflineBuffer(); }
+
+// serial console: one command per line ("mem", "rt")
+static char cmdLine[16];
+static uint8_t cmdLen = 0;
+
+static void pollSerialCommands() {
+  while (Serial.available() > 0) {
+    int c = Serial.read();
+    if (c < 0) break;
+    if (c != '\n' && c != '\r') {
+      if (cmdLen < sizeof(cmdLine) - 1) cmdLine[cmdLen++] = (char)c;
+      continue;
+    }
+    cmdLine[cmdLen] = 0;
+    if (!strcmp(cmdLine, "mem")) MemMon_report(Serial);
+    else if (!strcmp(cmdLine, "rt")) RtStats_print(Serial);
+    else if (!strncmp(cmdLine, "seed ", 5)) {
+      // replay a session: its seed from the log / the sessions table
+      uint32_t seed = strtoul(cmdLine + 5, nullptr, 16);
+      Rng_replay(seed);
+      Serial.printf("next session seed %08lx\n", (unsigned long)seed);
+    }
+    else if (cmdLen) Serial.println("commands: mem, rt, seed <hex>");
+    cmdLen = 0;
+  }
+}
+
 void setup() {
   Serial.begin(115200);
+  Log_begin();
   delay(150);
-  randomSeed(micros());
+#if defined(ARDUINO_ARCH_ESP32)
+  Rng_begin(esp_random() ^ micros());
+#else
+  Rng_begin(micros());
+#endif
 
   Shared_setupHardware();
+  MemMon_begin();   // heap / stack watermarks, every 10 s
 
   // Offline-first Firebase (won’t break if WiFi is missing)
   Firebase_initOfflineFirst();
+  Coop_arm(syncTimer, 5000, onSyncTimer, 5000);   // offline buffer, every 5 s
 
   goMenu();
 }
 
 void loop() {
-  // Periodic sync check
-  static unsigned long lastSyncCheck = 0;
-  if (millis() - lastSyncCheck > 5000) {   // every 5 seconds
-    lastSyncCheck = millis();
-    syncOfflineBuffer();
-  }
-
   int sx, sy;
 
+  // one pass of the current screen; it asks for its next turn with
+  // Coop_pollIn(), Coop_idle() sleeps until then and runs due timers
   if (g_screen == SCR_MENU) {
     if (Touch_pressed(sx, sy)) {
       if      (inRect(sx, sy, BTN_X, BTN1_Y, BTN_W, BTN_H)) goGame(SCR_GAME1);
       else if (inRect(sx, sy, BTN_X, BTN2_Y, BTN_W, BTN_H)) goGame(SCR_GAME2);
       else if (inRect(sx, sy, BTN_X, BTN3_Y, BTN_W, BTN_H)) goGame(SCR_GAME3);
     }
-    delay(10);
-    return;
+    Coop_pollIn(10);
   }
-
-  if (g_screen == SCR_GAME1) { Game1_update(); return; }
-  if (g_screen == SCR_GAME2) { Game2_update(); return; }
-  if (g_screen == SCR_GAME3) { Game3_update(); return; }
-
-  delay(10);
+  else if (g_screen == SCR_GAME1) Game1_update();
+  else if (g_screen == SCR_GAME2) Game2_update();
+  else if (g_screen == SCR_GAME3) Game3_update();
+  else Coop_pollIn(10);
+
+  Render_pump();   // no-op while the render task runs
+  Leds_flush();    // end of tick: the last LED frame of the pass
+  Log_pump();      // same for the log drain task
+  pollSerialCommands();
+  Coop_idle();
 }
@@ -0,0 +1,195 @@
+// Render.cpp – draw-command queue and the render task
+#include "Render.h"
+#include "SpiBus.h"
+#include <atomic>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+static TaskHandle_t renderTask = nullptr;
+#endif
+
+struct RenderCmd {
+  RenderFn fn;
+  uint8_t  key;
+  uint8_t  len;
+  uint8_t  params[RENDER_PARAM_BYTES];
+};
+
+static RenderCmd q[RENDER_QUEUE_LEN];
+static std::atomic<uint8_t> head(0);    // next free slot (producer)
+static std::atomic<uint8_t> tail(0);    // next to draw (consumer)
+static std::atomic<bool>    busy(false);
+static bool onRenderer = false;         // loop() is running a command inline
+static int  directDepth = 0;            // loop() is inside RenderDirect
+static RenderStats stats;
+static std::atomic<uint32_t> generation(0);   // anything may have drawn since
+
+static const uint8_t QMASK = RENDER_QUEUE_LEN - 1;
+
+static bool taskRunning() {
+#if defined(ARDUINO_ARCH_ESP32)
+  return renderTask != nullptr;
+#else
+  return false;
+#endif
+}
+
+static bool isRenderTask() {
+#if defined(ARDUINO_ARCH_ESP32)
+  return renderTask && xTaskGetCurrentTaskHandle() == renderTask;
+#else
+  return false;
+#endif
+}
+
+// the render task, or loop() inside an inline command
+static bool inRenderer() { return isRenderTask() || onRenderer; }
+
+static void runCmd(const RenderCmd& c) {
+  // onRenderer belongs to loop(); the task is recognised by its handle
+  bool mark = !isRenderTask();
+  bool prev = onRenderer;
+  if(mark) onRenderer = true;
+  SpiBus_acquire(SPI_DEV_TFT);
+  c.fn(c.params);
+  SpiBus_release(SPI_DEV_TFT);
+  if(mark) onRenderer = prev;
+}
+
+// newer command with the same key already queued behind slot t?
+static bool superseded(uint8_t t, uint8_t h) {
+  uint8_t key = q[t & QMASK].key;
+  if(key == RK_NONE) return false;
+  for(uint8_t i = t + 1; i != h; i++) {
+    if(q[i & QMASK].key == key) return true;
+  }
+  return false;
+}
+
+// consumer side: returns false once the queue is empty
+static bool drainOne() {
+  uint8_t t = tail.load(std::memory_order_relaxed);
+  uint8_t h = head.load(std::memory_order_acquire);
+  if(t == h) return false;
+
+  busy.store(true, std::memory_order_relaxed);
+  if(superseded(t, h)) stats.coalesced++;
+  else { runCmd(q[t & QMASK]); stats.drawn++; }
+  tail.store(t + 1, std::memory_order_release);
+  busy.store(false, std::memory_order_release);
+  return true;
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void renderLoop(void*) {
+  for(;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    while(drainOne()) {}
+  }
+}
+#endif
+
+void Render_begin() {
+#if defined(ARDUINO_ARCH_ESP32)
+  if(renderTask) return;
+  xTaskCreatePinnedToCore(renderLoop, "render", 4096, nullptr, 1, &renderTask, 0);
+#endif
+}
+
+bool Render_postRaw(RenderFn fn, uint8_t key, const void* params, uint8_t len) {
+  if(len > RENDER_PARAM_BYTES) return false;
+  stats.posted++;
+  generation.fetch_add(1, std::memory_order_relaxed);
+
+  // nested (inside a command) or ordered after inline paints: draw now
+  if(inRenderer() || directDepth > 0) {
+    RenderCmd c;
+    c.fn = fn;
+    c.key = key;
+    c.len = len;
+    if(len) memcpy(c.params, params, len);
+    runCmd(c);
+    stats.inlined++;
+    return true;
+  }
+
+  uint8_t h = head.load(std::memory_order_relaxed);
+  if((uint8_t)(h - tail.load(std::memory_order_acquire)) >= RENDER_QUEUE_LEN) {
+    stats.fullWaits++;
+    while((uint8_t)(h - tail.load(std::memory_order_acquire)) >= RENDER_QUEUE_LEN) {
+      if(taskRunning()) delay(1);
+      else drainOne();
+    }
+  }
+
+  RenderCmd& c = q[h & QMASK];
+  c.fn = fn;
+  c.key = key;
+  c.len = len;
+  if(len) memcpy(c.params, params, len);
+  head.store(h + 1, std::memory_order_release);
+
+  uint8_t depth = (uint8_t)(h + 1 - tail.load(std::memory_order_relaxed));
+  if(depth > stats.maxDepth) stats.maxDepth = depth;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  if(renderTask) xTaskNotifyGive(renderTask);
+#endif
+  return true;
+}
+
+#if !defined(ARDUINO_ARCH_ESP32)
+static uint8_t pumpEvery = 1, pumpCalls = 0;
+
+void Render_setLag(uint8_t passes) {
+  pumpEvery = passes ? passes : 1;
+  pumpCalls = 0;
+}
+#endif
+
+void Render_pump() {
+  if(taskRunning()) return;
+#if !defined(ARDUINO_ARCH_ESP32)
+  // a render task that falls behind: the queue builds up over several passes
+  if(++pumpCalls < pumpEvery) return;
+  pumpCalls = 0;
+#endif
+  while(drainOne()) {}
+}
+
+void Render_sync() {
+  if(!taskRunning()) { while(drainOne()) {} return; }
+  while(tail.load(std::memory_order_acquire) != head.load(std::memory_order_relaxed) ||
+        busy.load(std::memory_order_acquire)) {
+    delay(1);
+  }
+}
+
+bool Render_onRenderer() { return inRenderer(); }
+
+const RenderStats& Render_stats() { return stats; }
+
+uint32_t Render_generation() { return generation.load(std::memory_order_relaxed); }
+
+uint32_t Render_stackFree() {
+#if defined(ARDUINO_ARCH_ESP32)
+  return renderTask ? uxTaskGetStackHighWaterMark(renderTask) : 0;
+#else
+  return 0;
+#endif
+}
+
+// ---------------- RenderDirect ----------------
+RenderDirect::RenderDirect() : held(!inRenderer()) {
+  generation.fetch_add(1, std::memory_order_relaxed);
+  if(!held) return;
+  if(directDepth++ == 0) Render_sync();
+  SpiBus_acquire(SPI_DEV_TFT);
+}
+
+RenderDirect::~RenderDirect() {
+  if(!held) return;
+  SpiBus_release(SPI_DEV_TFT);
+  directDepth--;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include "Shared.h"
+#include "SpiBus.h"
+
+// ---------------- Render queue ----------------
+// Game code posts small draw commands (function + POD params) instead of
+// painting inline. On ESP32 a task pinned to core 0 (loop() runs on core 1)
+// executes them against tft, so a 30 ms card paint no longer pushes the next
+// RFID poll back by 30 ms. Without the task (host build) Render_pump() runs
+// them at the end of the loop pass.
+//
+// Single producer (loop) / single consumer (render task), lock-free. A
+// command with a non-zero key is dropped when a newer command with the same
+// key is already queued behind it: give keys only to widgets that repaint
+// their whole rect (time bars, status boxes, cards).
+//
+// Anything else that draws from loop() must hold a RenderDirect: it waits
+// for the queue to drain and takes the SPI bus (SpiBus.h), so inline paints
+// keep their order. Posts made while holding one run inline.
+
+static const uint8_t RENDER_QUEUE_LEN   = 32;   // power of two
+static const uint8_t RENDER_PARAM_BYTES = 40;
+
+typedef void (*RenderFn)(const void* params);
+
+// widget keys for coalescing (0 = never coalesce)
+enum RenderKey : uint8_t {
+  RK_NONE = 0,
+  RK_TIMEBAR,
+  RK_STATUS,
+  RK_PROGRESS,
+  RK_CARD,
+  RK_HINT,
+  RK_HEADER,
+};
+
+struct RenderStats {
+  uint32_t posted;
+  uint32_t drawn;
+  uint32_t coalesced;
+  uint32_t inlined;      // ran at post time (inside RenderDirect / no queue)
+  uint32_t fullWaits;    // producer had to wait for a free slot
+  uint8_t  maxDepth;
+};
+
+void Render_begin();                       // once, from Shared_setupHardware()
+bool Render_postRaw(RenderFn fn, uint8_t key, const void* params, uint8_t len);
+void Render_pump();                        // drain now (no-op while the task runs)
+#if !defined(ARDUINO_ARCH_ESP32)
+void Render_setLag(uint8_t passes);        // host: Render_pump() drains every Nth call only
+#endif
+void Render_sync();                        // until everything posted has been drawn
+bool Render_onRenderer();                  // true inside a command
+const RenderStats& Render_stats();
+uint32_t Render_stackFree();               // task stack never touched, bytes; 0 = no task
+uint32_t Render_generation();              // bumps on every post and RenderDirect
+
+template<typename T, void (*F)(const T&)>
+void Render_thunk(const void* p) { F(*(const T*)p); }
+
+template<void (*F)()>
+void Render_thunk0(const void*) { F(); }
+
+// Render_post<Params, drawFn>(key, params) -> drawFn(const Params&) later
+template<typename T, void (*F)(const T&)>
+inline bool Render_post(uint8_t key, const T& p) {
+  static_assert(sizeof(T) <= RENDER_PARAM_BYTES, "draw params too big for a render command");
+  return Render_postRaw(&Render_thunk<T, F>, key, &p, sizeof(T));
+}
+
+// Render_call<drawFn>(key) for parameterless draws
+template<void (*F)()>
+inline bool Render_call(uint8_t key = RK_NONE) {
+  return Render_postRaw(&Render_thunk0<F>, key, nullptr, 0);
+}
+
+// scope guard for inline drawing from loop()
+struct RenderDirect {
+  RenderDirect();
+  ~RenderDirect();
+  bool held;
+};
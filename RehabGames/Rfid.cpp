@@ -0,0 +1,458 @@
+// Rfid.cpp – PN532 readers: transactions, scanning, liveness probing and tiered recovery
+#include "Rfid.h"
+#include "I2cBus.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <Preferences.h>
+#endif
+
+static const uint8_t  ERR_STREAK_RECOVER = 3;
+static const uint32_t QUIET_FIRST_MS     = 1000;
+static const uint32_t QUIET_MAX_MS       = 16000;
+static const uint32_t POLL_GAP_MS        = 500;     // longer gap = polling was paused
+static const uint32_t BACKOFF_FIRST_MS   = 100;
+static const uint32_t BACKOFF_MAX_MS     = 3200;
+
+enum Tier : uint8_t { TIER_REARM, TIER_BUS_CLEAR, TIER_REINIT };
+
+struct Reader {
+  RfidReaderCfg cfg;
+  bool     ready;
+  uint8_t  errStreak;
+  uint32_t lastPollMs;
+  uint32_t quietStartMs;
+  uint32_t quietMs;
+
+  bool     recovering;
+  uint8_t  tier;
+  uint32_t backoffMs;
+  uint32_t nextTryMs;
+  uint32_t outageStartMs;
+
+  bool     listing;         // concurrent scan: InListPassiveTarget in flight
+  uint8_t  listTg;
+  uint32_t listStartUs;
+};
+
+// the board as built: one PN532 on the bus, covering every zone
+static const RfidReaderCfg BOARD_READER = { I2C_NO_MUX, 0, LED_COUNT - 1 };
+
+static Reader   readers[RFID_MAX_READERS];
+static uint8_t  nReaders = 0;
+static RfidScan scanMode = RFID_SCAN_ROUND_ROBIN;
+static uint8_t  rrNext = 0;
+static int8_t   readerOf[LED_COUNT];    // -1: no antenna; overlaps go to the first
+
+static RfidHealth health;
+static bool       dirty = false;
+
+// ---------------- PN532 transactions ----------------
+// firmware version and an RF arm: a rung that passes can also run the polls
+static bool nfcProbe() { return nfc.getFirmwareVersion() != 0 && nfc.SAMConfig(); }
+
+bool Nfc_init() {
+  nfc.begin();
+  delay(30);
+  bool ok;
+  {
+    I2cTxn t(I2C_OP_INIT);
+    ok = t.done(nfc.getFirmwareVersion() != 0);
+  }
+  // the reader moved or the wiring got worse since the last negotiation
+  if(!ok && !I2cBus_negotiate()) return false;
+  return Nfc_arm();
+}
+
+bool Nfc_arm() {
+  I2cTxn t(I2C_OP_ARM);
+  return t.done(nfc.SAMConfig());
+}
+
+// Listings run the command themselves and read the response straight off
+// the bus the way the Adafruit driver's I2C path does (status byte until
+// ready, 10 ms steps, then status byte + frame). The driver reports a
+// mangled frame and a chip error frame alike as "no target"; the clock
+// ladder must only hear about the first.
+static bool nfcStartList(uint8_t maxTg, uint16_t timeoutMs) {
+  uint8_t cmd[3] = { PN532_COMMAND_INLISTPASSIVETARGET, maxTg, PN532_MIFARE_ISO14443A };
+  return nfc.sendCommandCheckAck(cmd, 3, timeoutMs);
+}
+
+static bool nfcStatusReady() {
+  return Wire.requestFrom((uint8_t)PN532_I2C_ADDRESS, (uint8_t)1) == 1 &&
+         Wire.read() == PN532_I2C_READY;
+}
+
+static bool nfcWaitReady(uint16_t timeoutMs) {
+  uint16_t waited = 0;
+  for(;;) {
+    if(nfcStatusReady()) return true;
+    if(timeoutMs != 0) {
+      waited += 10;
+      if(waited > timeoutMs) return false;
+    }
+    delay(10);
+  }
+}
+
+// 00 00 FF LEN LCS D5 4B NbTg { Tg SENS_RES(2) SEL_RES NFCIDLength NFCID } DCS 00
+// NFC_ERROR: the frame did not survive the bus (short read, preamble,
+// length or data checksum); NFC_REFUSED: it did, but lists no targets
+static NfcResult nfcReadTargets(NfcTag* out, uint8_t maxTg, uint8_t* n) {
+  uint8_t f[7 + 1 + NFC_MAX_TARGETS * 12 + 2];
+  uint8_t want = (uint8_t)(7 + 1 + maxTg * 12 + 2);
+  *n = 0;
+  if(Wire.requestFrom((uint8_t)PN532_I2C_ADDRESS, (uint8_t)(want + 1)) != want + 1) return NFC_ERROR;
+  Wire.read();
+  for(uint8_t i=0;i<want;i++) f[i] = (uint8_t)Wire.read();
+
+  uint8_t len = f[3];
+  if(f[0] != 0x00 || f[1] != 0x00 || f[2] != 0xFF) return NFC_ERROR;
+  if((uint8_t)(len + f[4]) != 0 || len < 1 || 5 + len + 1 > want) return NFC_ERROR;
+  uint8_t sum = 0;
+  for(uint8_t i=0;i<=len;i++) sum += f[5+i];
+  if(sum != 0) return NFC_ERROR;
+
+  // error frame (00 00 FF 01 FF 7F 81 00) or some other answer
+  if(len < 3 || f[5] != 0xD5 || f[6] != PN532_COMMAND_INLISTPASSIVETARGET + 1) return NFC_REFUSED;
+  uint8_t nb = f[7];
+  if(nb > maxTg) return NFC_REFUSED;
+  uint8_t end = 5 + len, p = 8;
+  for(uint8_t t=0;t<nb;t++) {
+    if(p + 5 > end) return NFC_REFUSED;
+    uint8_t idLen = f[p+4];
+    if((idLen != 4 && idLen != 7) || p + 5 + idLen > end) return NFC_REFUSED;
+    NfcTag& tag = out[*n];
+    memcpy(tag.uid, f + p + 5, idLen);
+    tag.len = idLen;
+    p += 5 + idLen;
+    // a collision the chip didn't resolve can list the same card twice
+    bool dup = false;
+    for(uint8_t k=0;k<*n;k++) {
+      if(out[k].len == idLen && memcmp(out[k].uid, tag.uid, idLen) == 0) dup = true;
+    }
+    if(!dup) (*n)++;
+  }
+  return *n ? NFC_TAG : NFC_EMPTY;
+}
+
+NfcResult Nfc_listTargets(NfcTag* out, uint8_t maxTg, uint8_t* n, uint16_t timeoutMs) {
+  if(maxTg < 1) maxTg = 1;
+  if(maxTg > NFC_MAX_TARGETS) maxTg = NFC_MAX_TARGETS;
+  *n = 0;
+  I2cTxn t(I2C_OP_POLL);
+  NfcResult res;
+  if(nfcStartList(maxTg, timeoutMs) && nfcWaitReady(timeoutMs)) {
+    res = nfcReadTargets(out, maxTg, n);
+  } else {
+    // an empty field runs into the timeout; failing early means the ACK
+    // or the status byte did not make it across
+    uint32_t us = t.elapsedUs();
+    res = (timeoutMs == 0 || us >= (uint32_t)timeoutMs * 1000) ? NFC_EMPTY : NFC_ERROR;
+  }
+  t.done(res != NFC_ERROR);
+  return res;
+}
+
+NfcResult Nfc_list(uint8_t* uid, uint8_t* len, uint16_t timeoutMs) {
+  NfcTag tag;
+  uint8_t n;
+  NfcResult res = Nfc_listTargets(&tag, 1, &n, timeoutMs);
+  if(res == NFC_TAG) {
+    memcpy(uid, tag.uid, tag.len);
+    *len = tag.len;
+  }
+  return res;
+}
+
+// ---------------- NVS ----------------
+static void loadHealth() {
+#if defined(ARDUINO_ARCH_ESP32)
+  Preferences p;
+  if(p.begin("rfid", true)) {
+    if(p.getBytesLength("health") == sizeof(health)) p.getBytes("health", &health, sizeof(health));
+    p.end();
+  }
+#endif
+}
+
+void Rfid_save() {
+  if(!dirty) return;
+  dirty = false;
+#if defined(ARDUINO_ARCH_ESP32)
+  Preferences p;
+  if(p.begin("rfid", false)) {
+    p.putBytes("health", &health, sizeof(health));
+    p.end();
+  }
+#endif
+}
+
+static void bump(uint32_t& c) { c++; dirty = true; }
+
+// ---------------- recovery ----------------
+static bool selectReader(const Reader& r) { return I2cBus_select(r.cfg.muxChannel); }
+
+static void markHealthy(Reader& r) {
+  if(r.recovering) {
+    uint32_t out = millis() - r.outageStartMs;
+    if(out > health.worstOutageMs) health.worstOutageMs = out;
+    r.recovering = false;
+  }
+  r.ready = true;
+  r.errStreak = 0;
+  r.quietStartMs = millis();
+  r.quietMs = QUIET_FIRST_MS;
+}
+
+static void startRecovery(Reader& r, Tier from) {
+  if(!r.recovering) {
+    r.recovering = true;
+    r.outageStartMs = millis();
+    bump(health.outages);
+  }
+  r.ready = false;
+  r.listing = false;
+  r.tier = from;
+  r.backoffMs = BACKOFF_FIRST_MS;
+  r.nextTryMs = millis();
+}
+
+static bool runTier(Reader& r, uint8_t t) {
+  switch(t) {
+    case TIER_REARM:
+      bump(health.rearms);
+      return selectReader(r) && Nfc_arm();
+    case TIER_BUS_CLEAR:
+      bump(health.busClears);
+      I2cBus_clear();
+      return selectReader(r) && Nfc_arm();
+    default:
+      bump(health.reinits);
+      return selectReader(r) && Nfc_init();
+  }
+}
+
+// one tier per call, spaced by the backoff
+static void recoverStep(Reader& r) {
+  if((int32_t)(millis() - r.nextTryMs) < 0) return;
+  if(runTier(r, r.tier)) { markHealthy(r); return; }
+  if(r.tier < TIER_REINIT) r.tier++;
+  r.nextTryMs = millis() + r.backoffMs;
+  if(r.backoffMs < BACKOFF_MAX_MS) r.backoffMs *= 2;
+}
+
+// ---------------- polling ----------------
+// gap check and recovery; false = no poll this time
+static bool pollBegin(Reader& r) {
+  uint32_t now = millis();
+  if(now - r.lastPollMs > POLL_GAP_MS) r.quietStartMs = now;   // polling was paused
+  r.lastPollMs = now;
+
+  if(r.recovering) {
+    recoverStep(r);
+    if(r.recovering) return false;
+  }
+  return true;
+}
+
+static void pollDone(Reader& r, NfcResult res) {
+  switch(res) {
+    case NFC_TAG:
+      bump(health.reads);
+      markHealthy(r);
+      return;
+
+    case NFC_ERROR:
+    case NFC_REFUSED:
+      bump(health.pollErrors);
+      if(++r.errStreak >= ERR_STREAK_RECOVER) startRecovery(r, TIER_REARM);
+      return;
+
+    default:
+      r.errStreak = 0;
+      if(millis() - r.quietStartMs < r.quietMs) return;
+      bump(health.probes);
+      if(selectReader(r) && Nfc_arm()) {
+        r.quietStartMs = millis();
+        if(r.quietMs < QUIET_MAX_MS) r.quietMs *= 2;
+      } else {
+        // SAM just failed; skip straight to a bus clear
+        startRecovery(r, TIER_BUS_CLEAR);
+      }
+      return;
+  }
+}
+
+// merged stream: a peg on the seam between two antennas shows up once
+static void addTag(const NfcTag& t, uint8_t reader, NfcTag* out, uint8_t* from, uint8_t& n, uint8_t maxOut) {
+  for(uint8_t i=0;i<n;i++) {
+    if(out[i].len == t.len && memcmp(out[i].uid, t.uid, t.len) == 0) return;
+  }
+  if(n >= maxOut) return;
+  if(from) from[n] = reader;
+  out[n++] = t;
+}
+
+// one blocking poll on the next reader that can take one; -1 = none could
+static int8_t scanRoundRobin(NfcTag* out, uint8_t* from, uint8_t maxOut, uint8_t maxTg, uint16_t timeoutMs) {
+  for(uint8_t k=0;k<nReaders;k++) {
+    uint8_t i = rrNext;
+    rrNext = (uint8_t)((rrNext + 1) % nReaders);
+    Reader& r = readers[i];
+    if(!pollBegin(r)) continue;
+
+    NfcTag t[NFC_MAX_TARGETS];
+    uint8_t got = 0;
+    NfcResult res = NFC_ERROR;
+    if(selectReader(r)) res = Nfc_listTargets(t, maxTg, &got, timeoutMs);
+    pollDone(r, res);
+    if(res == NFC_ERROR || res == NFC_REFUSED) return -1;
+    uint8_t n = 0;
+    for(uint8_t j=0;j<got;j++) addTag(t[j], i, out, from, n, maxOut);
+    return (int8_t)n;
+  }
+  return -1;
+}
+
+// Every reader keeps an InListPassiveTarget running; the antennas search in
+// parallel and a call returns as soon as any of them answered (or after
+// timeoutMs). A listing that runs into timeoutMs is an empty field and is
+// re-armed on the next pass.
+static int8_t scanConcurrent(NfcTag* out, uint8_t* from, uint8_t maxOut, uint8_t maxTg, uint16_t timeoutMs) {
+  uint8_t n = 0;
+  bool heard = false, failed = false;
+  uint32_t t0 = millis();
+  for(;;) {
+    bool any = false;
+    for(uint8_t i=0;i<nReaders;i++) {
+      Reader& r = readers[i];
+      if(!r.listing) {
+        if(!pollBegin(r)) continue;
+        if(selectReader(r) && nfcStartList(maxTg, timeoutMs)) {
+          r.listing = true;
+          r.listTg = maxTg;
+          r.listStartUs = micros();
+        } else {
+          I2cBus_note(I2C_OP_POLL, false, 0);
+          pollDone(r, NFC_ERROR);
+          failed = true;
+          continue;
+        }
+      }
+      any = true;
+
+      uint32_t us = micros() - r.listStartUs;
+      if(!selectReader(r)) {
+        r.listing = false;
+        pollDone(r, NFC_ERROR);
+        failed = true;
+      } else if(nfcStatusReady()) {
+        r.listing = false;
+        NfcTag t[NFC_MAX_TARGETS];
+        uint8_t got = 0;
+        NfcResult res = nfcReadTargets(t, r.listTg, &got);
+        I2cBus_note(I2C_OP_POLL, res != NFC_ERROR, us);
+        pollDone(r, res);
+        if(res == NFC_TAG || res == NFC_EMPTY) heard = true;
+        else failed = true;
+        for(uint8_t j=0;j<got;j++) addTag(t[j], i, out, from, n, maxOut);
+      } else if(us >= (uint32_t)timeoutMs * 1000) {
+        r.listing = false;
+        I2cBus_note(I2C_OP_POLL, true, us);
+        pollDone(r, NFC_EMPTY);
+        heard = true;
+      }
+    }
+    if(n || !any || millis() - t0 >= timeoutMs) break;
+    delay(10);
+  }
+  if(n) return (int8_t)n;
+  return (failed && !heard) ? -1 : 0;
+}
+
+static int8_t scan(NfcTag* out, uint8_t* from, uint8_t maxOut, uint8_t maxTg, uint16_t timeoutMs) {
+  if(!nReaders) return -1;
+  if(maxTg < 1) maxTg = 1;
+  if(maxTg > NFC_MAX_TARGETS) maxTg = NFC_MAX_TARGETS;
+  if(scanMode == RFID_SCAN_CONCURRENT && nReaders > 1)
+    return scanConcurrent(out, from, maxOut, maxTg, timeoutMs);
+  return scanRoundRobin(out, from, maxOut, maxTg, timeoutMs);
+}
+
+// ---------------- API ----------------
+void Rfid_setReaders(const RfidReaderCfg* cfg, uint8_t n, RfidScan mode) {
+  if(n > RFID_MAX_READERS) n = RFID_MAX_READERS;
+  memset(readers, 0, sizeof(readers));
+  for(uint8_t i=0;i<n;i++) readers[i].cfg = cfg[i];
+  nReaders = n;
+  memset(readerOf, -1, sizeof(readerOf));
+  for(int8_t i=n-1;i>=0;i--) {
+    for(int led=cfg[i].firstLed; led<=cfg[i].lastLed && led<LED_COUNT; led++) readerOf[led] = i;
+  }
+  scanMode = mode;
+  rrNext = 0;
+}
+
+uint8_t Rfid_readerCount() { return nReaders; }
+
+const RfidReaderCfg& Rfid_reader(uint8_t i) { return readers[i < nReaders ? i : 0].cfg; }
+
+int8_t Rfid_readerForLed(uint8_t led) { return led < LED_COUNT ? readerOf[led] : -1; }
+
+void Rfid_begin() {
+  if(!nReaders) Rfid_setReaders(&BOARD_READER, 1, RFID_SCAN_ROUND_ROBIN);
+  loadHealth();
+  bump(health.boots);
+  I2cBus_begin(PN532_SDA, PN532_SCL, nfcProbe);
+  selectReader(readers[0]);
+  nfc.begin();
+  I2cBus_negotiate();
+  rrNext = 0;
+  for(uint8_t i=0;i<nReaders;i++) {
+    Reader& r = readers[i];
+    r.recovering = false;
+    r.listing = false;
+    if(selectReader(r) && Nfc_arm()) markHealthy(r);
+    else startRecovery(r, TIER_BUS_CLEAR);
+  }
+}
+
+bool Rfid_ready() {
+  if(!nReaders) return false;
+  for(uint8_t i=0;i<nReaders;i++) if(!readers[i].ready) return false;
+  return true;
+}
+
+bool Rfid_read(uint8_t uid4[4], uint16_t timeoutMs) {
+  NfcTag t;
+  if(scan(&t, nullptr, 1, 1, timeoutMs) <= 0) return false;
+  memcpy(uid4, t.uid, 4);
+  return true;
+}
+
+int8_t Rfid_readPegs(uint8_t uids[][4], uint8_t maxPegs, uint16_t timeoutMs, uint8_t* from) {
+  NfcTag tags[NFC_MAX_TARGETS * RFID_MAX_READERS];
+  uint8_t maxOut = maxPegs < sizeof(tags)/sizeof(tags[0]) ? maxPegs : sizeof(tags)/sizeof(tags[0]);
+  int8_t n = scan(tags, from, maxOut, maxPegs, timeoutMs);
+  for(int8_t i=0;i<n;i++) memcpy(uids[i], tags[i].uid, 4);
+  return n;
+}
+
+bool Rfid_recoverNow() {
+  bool all = true;
+  for(uint8_t i=0;i<nReaders;i++) {
+    Reader& r = readers[i];
+    if(r.ready && !r.recovering) continue;
+    if(!r.recovering) startRecovery(r, TIER_REARM);
+    bool ok = false;
+    for(uint8_t t = r.tier; t <= TIER_REINIT && !ok; t++) ok = runTier(r, t);
+    if(ok) { markHealthy(r); continue; }
+    r.tier = TIER_REINIT;
+    r.nextTryMs = millis() + r.backoffMs;
+    all = false;
+  }
+  return all;
+}
+
+const RfidHealth& Rfid_health() { return health; }
@@ -0,0 +1,86 @@
+#pragma once
+#include "Shared.h"
+#include "I2cBus.h"
+
+// ---------------- RFID reader health ----------------
+// One manager for the PN532, shared by all games. Games call Rfid_read()
+// while they wait for a peg; everything else happens in there:
+//   - a poll that fails early is an error: the bus mangled it (NAK, bad
+//     ACK, bad checksum) or the chip refused it (error frame, typically RF
+//     side not armed). 3 in a row start a recovery. Only the first kind
+//     counts against the I2C clock (I2cBus.h).
+//   - a poll that runs into its timeout is an empty field. After 1 s of
+//     continuous empty polling one SAMConfiguration doubles as liveness
+//     probe and RF re-arm (a stalled RF side looks exactly like "no peg").
+//     It answers -> reader alive, next check in 2, 4 .. 16 s. It doesn't
+//     -> recovery, starting at the bus clear.
+//   - recovery climbs tiers: re-arm, bus clear + re-arm, full init (may
+//     renegotiate the I2C clock), with 100 ms .. 3.2 s backoff in between
+// Games never block on the reader at entry: Rfid_ready() is a cached flag.
+// Rfid_readPegs() is the same poll with MaxTg=2: the PN532 runs the
+// anticollision loop itself and reports both pegs of a pair in one frame.
+// Boards with several antennas: Rfid_setReaders() before Rfid_begin(), one
+// entry per PN532 (mux channel + the range of LEDs it covers; a peg one
+// antenna reports sits on one of its LEDs, Rfid_readerForLed()). Each reader has
+// its own health state; the tags of all readers come back as one stream,
+// scanned round-robin (one blocking poll per call, as with one reader) or
+// concurrently (every reader keeps a listing running, a call collects the
+// answers), so detect latency no longer grows with the number of zones.
+// Lifetime counters live in NVS on the ESP32 (Rfid_save()).
+
+enum NfcResult : uint8_t {
+  NFC_TAG,
+  NFC_EMPTY,        // ran into the timeout
+  NFC_ERROR,        // the transaction failed on the bus
+  NFC_REFUSED       // well-formed answer that lists no targets (PN532 error frame)
+};
+
+static const uint8_t NFC_MAX_TARGETS = 2;           // PN532 limit for ISO14443A
+
+struct NfcTag { uint8_t uid[7]; uint8_t len; };
+
+enum RfidScan : uint8_t {
+  RFID_SCAN_ROUND_ROBIN,    // one reader per call
+  RFID_SCAN_CONCURRENT      // all readers listing at once
+};
+
+struct RfidReaderCfg {
+  uint8_t  muxChannel;      // I2C_NO_MUX: straight on the bus
+  uint8_t  firstLed;        // LEDs firstLed..lastLed lie on this antenna
+  uint8_t  lastLed;
+};
+
+static const uint8_t RFID_MAX_READERS = 8;
+
+struct RfidHealth {
+  uint32_t boots;
+  uint32_t reads;
+  uint32_t pollErrors;
+  uint32_t probes;          // quiet-field liveness probes (SAMConfiguration)
+  uint32_t rearms;          // recovery tier 1
+  uint32_t busClears;       // recovery tier 2
+  uint32_t reinits;         // recovery tier 3
+  uint32_t outages;         // times the reader was marked not ready
+  uint32_t worstOutageMs;
+};
+
+void Rfid_setReaders(const RfidReaderCfg* readers, uint8_t n, RfidScan scan);   // before Rfid_begin()
+uint8_t Rfid_readerCount();
+const RfidReaderCfg& Rfid_reader(uint8_t i);
+int8_t Rfid_readerForLed(uint8_t led);              // -1: no antenna covers it
+
+void Rfid_begin();                                  // once, from Shared_setupHardware()
+bool Rfid_ready();                                  // every reader; no bus traffic
+bool Rfid_read(uint8_t uid4[4], uint16_t timeoutMs);   // one poll + health bookkeeping
+// up to maxPegs UIDs from one poll; -1 = poll failed or reader recovering.
+// from[i] (optional) = the reader that saw uids[i]
+int8_t Rfid_readPegs(uint8_t uids[][4], uint8_t maxPegs, uint16_t timeoutMs, uint8_t* from = nullptr);
+bool Rfid_recoverNow();                             // RETRY button: all tiers, no backoff
+const RfidHealth& Rfid_health();
+void Rfid_save();                                   // NVS write if anything changed
+
+// PN532 transactions on the selected reader (timed through I2cBus.h)
+bool      Nfc_init();                               // begin + firmware + SAM
+bool      Nfc_arm();                                // SAMConfiguration
+NfcResult Nfc_list(uint8_t* uid, uint8_t* len, uint16_t timeoutMs);   // one InListPassiveTarget
+NfcResult Nfc_listTargets(NfcTag* out, uint8_t maxTg, uint8_t* n, uint16_t timeoutMs);
@@ -0,0 +1,89 @@
+// Rng.cpp – PCG32 streams: per-session seeds for game content, one for decor
+#include "Rng.h"
+
+static Rng master;                  // session seeds
+static Rng session;
+static Rng decor;
+static uint32_t sessionSeed = 0;
+static uint32_t replaySeed = 0;
+static bool     replayPending = false;
+
+static const uint32_t STREAM_MASTER  = 0x6D61;
+static const uint32_t STREAM_SESSION = 0x7365;
+static const uint32_t STREAM_DECOR   = 0x6463;
+
+// ---------------- generator ----------------
+void Rng_seed(Rng& r, uint32_t seed, uint32_t stream) {
+  r.state = 0;
+  r.inc = ((uint64_t)stream << 1) | 1;
+  Rng_next(r);
+  r.state += seed;
+  Rng_next(r);
+}
+
+uint32_t Rng_next(Rng& r) {
+  uint64_t old = r.state;
+  r.state = old * 6364136223846793005ULL + r.inc;
+  uint32_t xs = (uint32_t)(((old >> 18) ^ old) >> 27);
+  uint32_t rot = (uint32_t)(old >> 59);
+  return (xs >> rot) | (xs << ((0u - rot) & 31));
+}
+
+uint32_t Rng_below(Rng& r, uint32_t n) {
+  uint64_t m = (uint64_t)Rng_next(r) * n;
+  uint32_t low = (uint32_t)m;
+  if(low < n) {
+    uint32_t floor = (0u - n) % n;
+    while(low < floor) {
+      m = (uint64_t)Rng_next(r) * n;
+      low = (uint32_t)m;
+    }
+  }
+  return (uint32_t)(m >> 32);
+}
+
+// ---------------- sessions ----------------
+void Rng_begin(uint32_t entropy) {
+  Rng_seed(master, entropy, STREAM_MASTER);
+  Rng_seed(decor, Rng_next(master), STREAM_DECOR);
+  Rng_beginSession();
+}
+
+uint32_t Rng_beginSession() {
+  sessionSeed = replayPending ? replaySeed : Rng_next(master);
+  replayPending = false;
+  Rng_seed(session, sessionSeed, STREAM_SESSION);
+  return sessionSeed;
+}
+
+uint32_t Rng_sessionSeed() { return sessionSeed; }
+
+void Rng_replay(uint32_t seed) {
+  replaySeed = seed;
+  replayPending = true;
+}
+
+// ---------------- session stream ----------------
+uint32_t Rng_below(uint32_t n) { return Rng_below(session, n); }
+
+// uniform over the n - 1 others: step 1..n-1 places past prev
+uint8_t Rng_indexOther(uint8_t n, int16_t prev) {
+  if(prev < 0 || prev >= n || n < 2) return (uint8_t)Rng_below(session, n);
+  return (uint8_t)((prev + 1 + Rng_below(session, n - 1)) % n);
+}
+
+// partial Fisher-Yates: step i swaps a uniform pick from a[i..n) into a[i]
+void Rng_sample(uint8_t* a, uint8_t n, uint8_t k) {
+  if(k > n) k = n;
+  for(uint8_t i=0;i<k && i + 1 < n;i++){
+    uint8_t j = (uint8_t)(i + Rng_below(session, n - i));
+    uint8_t t = a[i]; a[i] = a[j]; a[j] = t;
+  }
+}
+
+void Rng_shuffle(uint8_t* a, uint8_t n) { Rng_sample(a, n, n); }
+
+// ---------------- decor stream ----------------
+int32_t Rng_decor(int32_t lo, int32_t hi) {
+  return hi > lo ? lo + (int32_t)Rng_below(decor, (uint32_t)(hi - lo)) : lo;
+}
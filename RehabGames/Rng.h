@@ -0,0 +1,39 @@
+#pragma once
+#include "Shared.h"
+
+// ---------------- Random numbers ----------------
+// PCG32 (O'Neill: 64-bit LCG, xorshift + rotate on the way out), 8 bytes of
+// state and a multiply per draw, in two streams:
+//   session: everything a game deals (LED picks, sequences, boards). Each
+//            session is seeded explicitly (Rng_beginSession()); the seed goes
+//            out with the session summary, and replaying it at the same
+//            level deals the same rounds.
+//   decor:   stars on backgrounds, drawn by whoever paints (the render task
+//            or a RenderDirect, i.e. with the TFT bus held), so repainting a
+//            screen never shifts what a session deals.
+//
+// Draws are bounded: a value below n is one multiply (Lemire; the retry
+// for an unlucky low word happens n in 2^32 times), a pick that must
+// differ from the last one is one draw among the n - 1 others, and k
+// distinct items out of n are the first k steps of a Fisher-Yates shuffle
+// done in the caller's array. No retry loops, no allocation.
+
+struct Rng { uint64_t state, inc; };
+
+void     Rng_seed(Rng& r, uint32_t seed, uint32_t stream);
+uint32_t Rng_next(Rng& r);
+uint32_t Rng_below(Rng& r, uint32_t n);              // 0..n-1, n > 0
+
+void     Rng_begin(uint32_t entropy);                // once, from setup()
+uint32_t Rng_beginSession();                         // new seed (or the replayed one), returned
+uint32_t Rng_sessionSeed();
+void     Rng_replay(uint32_t seed);                  // the next session uses this seed
+
+// session stream
+uint32_t Rng_below(uint32_t n);
+uint8_t  Rng_indexOther(uint8_t n, int16_t prev);     // 0..n-1 but not prev (prev < 0: any)
+void     Rng_sample(uint8_t* a, uint8_t n, uint8_t k); // a[0..k) = k distinct picks from a[0..n)
+void     Rng_shuffle(uint8_t* a, uint8_t n);
+
+// decor stream
+int32_t  Rng_decor(int32_t lo, int32_t hi);          // lo..hi-1, like random(lo, hi)
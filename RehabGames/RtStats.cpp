@@ -0,0 +1,187 @@
+// RtStats.cpp – streaming reaction-time statistics
+#include "RtStats.h"
+#include <math.h>
+#include <string.h>
+
+// ---------------- Welford ----------------
+void Welford::add(float x) {
+  n++;
+  float d = x - mean;
+  mean += d / n;
+  m2 += d * (x - mean);
+}
+
+float Welford::sd() const { return n > 1 ? sqrtf(m2 / (n - 1)) : 0; }
+
+// ---------------- P² ----------------
+void P2Quantile::init(float quantile) {
+  memset(this, 0, sizeof(*this));
+  p = quantile;
+}
+
+void P2Quantile::add(float x) {
+  if(count < 5) {
+    // first five samples: keep them sorted
+    int i = count++;
+    while(i > 0 && q[i-1] > x) { q[i] = q[i-1]; i--; }
+    q[i] = x;
+    if(count == 5) {
+      for(int k=0;k<5;k++) pos[k] = k + 1;
+      want[0] = 1; want[1] = 1 + 2*p; want[2] = 1 + 4*p; want[3] = 3 + 2*p; want[4] = 5;
+    }
+    return;
+  }
+
+  int k;
+  if(x < q[0])       { q[0] = x; k = 0; }
+  else if(x >= q[4]) { q[4] = x; k = 3; }
+  else { k = 0; while(k < 3 && x >= q[k+1]) k++; }
+
+  for(int i=k+1;i<5;i++) pos[i]++;
+  const float dw[5] = {0, p/2, p, (1+p)/2, 1};
+  for(int i=0;i<5;i++) want[i] += dw[i];
+  count++;
+
+  for(int i=1;i<4;i++) {
+    float d = want[i] - pos[i];
+    if((d >= 1 && pos[i+1] - pos[i] > 1) || (d <= -1 && pos[i-1] - pos[i] < -1)) {
+      int s = d > 0 ? 1 : -1;
+      // parabolic prediction, linear if it would break monotonicity
+      float qp = q[i] + (float)s / (pos[i+1] - pos[i-1]) *
+                 ((pos[i] - pos[i-1] + s) * (q[i+1] - q[i]) / (pos[i+1] - pos[i]) +
+                  (pos[i+1] - pos[i] - s) * (q[i] - q[i-1]) / (pos[i] - pos[i-1]));
+      if(q[i-1] < qp && qp < q[i+1]) q[i] = qp;
+      else q[i] = q[i] + s * (q[i+s] - q[i]) / (pos[i+s] - pos[i]);
+      pos[i] += s;
+    }
+  }
+}
+
+float P2Quantile::value() const {
+  if(count == 0) return 0;
+  if(count < 5) {
+    int i = (int)(p * (count - 1) + 0.5f);
+    return q[i];
+  }
+  return q[2];
+}
+
+// ---------------- cells ----------------
+void RtCell::clear() {
+  memset(&w, 0, sizeof(w));
+  p50.init(0.5f);
+  p90.init(0.9f);
+  minMs = maxMs = 0;
+  correct = misses = 0;
+}
+
+void RtCell::add(float ms, bool ok) {
+  if(w.n == 0 || ms < minMs) minMs = ms;
+  if(w.n == 0 || ms > maxMs) maxMs = ms;
+  w.add(ms);
+  p50.add(ms);
+  p90.add(ms);
+  if(ok) correct++;
+}
+
+static RtCell  life[RT_GAMES][RT_LEVELS];
+static Welford lifeZone[RT_GAMES][LED_COUNT];
+static bool    lifeInit = false;
+
+static RtCell  sess;
+static Welford sessZone[LED_COUNT];
+static RtGame  sessGame = RT_FOLLOW;
+static uint8_t sessLevel = 0;
+
+static void initLife() {
+  if(lifeInit) return;
+  for(int g=0;g<RT_GAMES;g++) for(int l=0;l<RT_LEVELS;l++) life[g][l].clear();
+  memset(lifeZone, 0, sizeof(lifeZone));
+  lifeInit = true;
+}
+
+void RtStats_beginSession(RtGame g, uint8_t level) {
+  initLife();
+  sessGame = g;
+  sessLevel = level < RT_LEVELS ? level : RT_LEVELS - 1;
+  sess.clear();
+  memset(sessZone, 0, sizeof(sessZone));
+}
+
+void RtStats_response(uint8_t led, uint32_t latencyUs, bool correct) {
+  initLife();
+  float ms = latencyUs / 1000.0f;
+  sess.add(ms, correct);
+  life[sessGame][sessLevel].add(ms, correct);
+  if(led < LED_COUNT) {
+    sessZone[led].add(ms);
+    lifeZone[sessGame][led].add(ms);
+  }
+}
+
+void RtStats_miss(uint8_t led) {
+  (void)led;
+  initLife();
+  sess.misses++;
+  life[sessGame][sessLevel].misses++;
+}
+
+void RtStats_endSession(RtSummary& out) {
+  memset(&out, 0, sizeof(out));
+  out.game = sessGame;
+  out.level = sessLevel;
+  out.responses = (uint16_t)sess.w.n;
+  out.correct = sess.correct;
+  out.misses = sess.misses;
+  out.meanMs = sess.w.mean;
+  out.sdMs = sess.w.sd();
+  out.p50Ms = sess.p50.value();
+  out.p90Ms = sess.p90.value();
+  out.minMs = sess.minMs;
+  out.maxMs = sess.maxMs;
+  out.ts = millis();
+  for(int i=0;i<LED_COUNT && out.zoneCount<RT_MAX_SUMMARY_ZONES;i++) {
+    if(!sessZone[i].n) continue;
+    RtZone& z = out.zones[out.zoneCount++];
+    z.led = i;
+    z.n = (uint16_t)sessZone[i].n;
+    z.meanMs = (uint16_t)(sessZone[i].mean + 0.5f);
+  }
+}
+
+const RtCell& RtStats_cell(RtGame g, uint8_t level) {
+  initLife();
+  return life[g][level < RT_LEVELS ? level : RT_LEVELS - 1];
+}
+
+const Welford& RtStats_zone(RtGame g, uint8_t led) {
+  initLife();
+  return lifeZone[g][led < LED_COUNT ? led : 0];
+}
+
+const char* RtStats_gameName(uint8_t g) {
+  static const char* names[RT_GAMES] = {"follow", "sequence", "match"};
+  return g < RT_GAMES ? names[g] : "?";
+}
+
+void RtStats_print(Print& out) {
+  initLife();
+  out.println("game      lvl     n  ok  miss  mean_ms   sd_ms  p50_ms  p90_ms");
+  for(int g=0;g<RT_GAMES;g++) for(int l=0;l<RT_LEVELS;l++) {
+    const RtCell& c = RtStats_cell((RtGame)g, l);
+    if(!c.w.n && !c.misses) continue;
+    out.printf("%-9s %3d %5u %3u %5u %8.1f %7.1f %7.1f %7.1f\n", RtStats_gameName(g), l + 1,
+               (unsigned)c.w.n, c.correct, c.misses, c.w.mean, c.w.sd(), c.p50.value(), c.p90.value());
+  }
+  // zones: mean_ms/n per LED, one line per game that has any
+  for(int g=0;g<RT_GAMES;g++) {
+    bool any = false;
+    for(int i=0;i<LED_COUNT;i++) {
+      const Welford& z = RtStats_zone((RtGame)g, i);
+      if(!z.n) continue;
+      if(!any) { out.printf("%-9s zones", RtStats_gameName(g)); any = true; }
+      out.printf(" %d:%.0f/%u", i, z.mean, (unsigned)z.n);
+    }
+    if(any) out.println();
+  }
+}
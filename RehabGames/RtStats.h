@@ -0,0 +1,76 @@
+#pragma once
+#include "Shared.h"
+#include "MemMon.h"
+
+// ---------------- Reaction-time statistics ----------------
+// Every peg response (stimulus -> tag read, in micros) goes into bounded
+// streaming stats; raw samples are never stored.
+//   lifetime: Welford mean/sd + P² p50/p90 per game x level,
+//             Welford per game x LED zone
+//   session:  the same for the running session -> RtSummary at the end
+
+enum RtGame { RT_FOLLOW, RT_SEQUENCE, RT_MATCH, RT_GAMES };
+static const int RT_LEVELS = 3;
+static const int RT_MAX_SUMMARY_ZONES = 16;
+
+struct Welford {
+  uint32_t n;
+  float mean;
+  float m2;
+  void  add(float x);
+  float sd() const;
+};
+
+// P² single-quantile estimator (Jain & Chlamtac): 5 markers, O(1) memory
+struct P2Quantile {
+  float    p;
+  float    q[5];     // marker heights
+  int32_t  pos[5];   // actual positions
+  float    want[5];  // desired positions
+  uint32_t count;
+  void  init(float quantile);
+  void  add(float x);
+  float value() const;
+};
+
+struct RtCell {
+  Welford    w;
+  P2Quantile p50, p90;
+  float      minMs, maxMs;
+  uint16_t   correct;
+  uint16_t   misses;
+  void clear();
+  void add(float ms, bool ok);
+};
+
+struct RtZone { uint8_t led; uint16_t n; uint16_t meanMs; };
+
+// one session, compact enough to sit in the offline buffer
+struct RtSummary {
+  uint8_t  game;
+  uint8_t  level;
+  uint16_t responses;
+  uint16_t correct;
+  uint16_t misses;
+  float    meanMs, sdMs, p50Ms, p90Ms, minMs, maxMs;
+  int      score;
+  int      coins;
+  unsigned long ts;
+  uint32_t memFreeMin;      // heap low-water marks during the session (MemMon)
+  uint32_t memBlockMin;
+  uint16_t stackFreeMin[MEM_TASKS];   // per MemTask; 0xFFFF = not measured
+  uint32_t seed;            // Rng_sessionSeed(): replaying it deals the same session
+  uint8_t  zoneCount;
+  RtZone   zones[RT_MAX_SUMMARY_ZONES];
+};
+
+void RtStats_beginSession(RtGame g, uint8_t level);   // level 0..RT_LEVELS-1
+void RtStats_response(uint8_t led, uint32_t latencyUs, bool correct);
+void RtStats_miss(uint8_t led);                       // no response before the timeout
+void RtStats_endSession(RtSummary& out);
+
+const RtCell&  RtStats_cell(RtGame g, uint8_t level);
+const Welford& RtStats_zone(RtGame g, uint8_t led);
+void RtStats_print(Print& out);                       // lifetime table + zones ("rt")
+
+const char* RtStats_gameName(uint8_t g);
@@ -0,0 +1,243 @@
+// ScreenCache.cpp – palette + RLE images of static screens
+#include "ScreenCache.h"
+#include "Render.h"
+#include "SpiBus.h"
+#include "MemMon.h"
+#include "Coop.h"
+#include <new>
+
+static const uint16_t MAX_COLORS = 255;
+static const uint16_t LONG_RUN   = 0xFFFF;
+
+struct Image {
+  uint8_t* data;          // palette (colors x 2 bytes), then runs
+  uint32_t len;
+  uint8_t  colors;
+  bool     psram;
+  bool     uncacheable;   // tried once, don't read back again
+};
+
+static Image img[SCREEN_COUNT];
+static uint32_t heapBytes = 0;
+static ScreenCacheStats stats;
+static uint16_t row[SCREEN_W];
+
+// ---------------- memory ----------------
+static uint8_t* allocImage(uint32_t n, bool& psram) {
+#if defined(ARDUINO_ARCH_ESP32)
+  if(psramFound()) {
+    psram = true;
+    return (uint8_t*)ps_malloc(n);
+  }
+#endif
+  psram = false;
+  if(heapBytes + n > SCREEN_CACHE_HEAP_BUDGET) return nullptr;
+  if(ESP.getMaxAllocHeap() < n + MEM_LOW_FREE || ESP.getFreeHeap() < n + 2 * MEM_LOW_FREE) return nullptr;
+  return new (std::nothrow) uint8_t[n];
+}
+
+// psram: the block came from ps_malloc() and is outside the heap budget
+static void freeBytes(uint8_t* p, uint32_t n, bool psram) {
+  if(psram) {
+    free(p);
+  } else {
+    delete[] p;
+    heapBytes -= n;
+  }
+  stats.bytes -= n;
+}
+
+static void freeImage(Image& im) {
+  if(!im.data) return;
+  freeBytes(im.data, im.len, im.psram);
+  im.data = nullptr;
+  im.len = 0;
+}
+
+// ---------------- encoder ----------------
+// Two passes over the panel: the first sizes palette and runs, the second
+// (out != nullptr) writes them with the palette the first one built. Pass 2
+// must see the same pixels, which the Render_generation() check guarantees.
+struct Encoder {
+  uint16_t pal[MAX_COLORS];
+  uint16_t colors;
+  uint8_t* out;
+  uint32_t n;
+  bool     full;
+  uint8_t  runIdx;
+  uint32_t runLen;
+
+  void begin(uint8_t* o) { out = o; n = o ? colors * 2u : 0; runLen = 0; full = false; }
+
+  int index(uint16_t c) {
+    for(uint16_t i=0;i<colors;i++) if(pal[i] == c) return i;
+    if(out || colors == MAX_COLORS) return -1;
+    pal[colors] = c;
+    return colors++;
+  }
+
+  void emit() {
+    while(runLen) {
+      uint32_t len = runLen > LONG_RUN ? LONG_RUN : runLen;
+      if(out) {
+        out[n] = runIdx;
+        if(len <= 255) out[n + 1] = (uint8_t)len;
+        else { out[n + 1] = 0; out[n + 2] = (uint8_t)len; out[n + 3] = (uint8_t)(len >> 8); }
+      }
+      n += len <= 255 ? 2 : 4;
+      runLen -= len;
+    }
+  }
+
+  void pixel(uint16_t c) {
+    int i = index(c);
+    if(i < 0) { full = true; return; }
+    if(runLen && runIdx == i) { runLen++; return; }
+    emit();
+    runIdx = (uint8_t)i;
+    runLen = 1;
+  }
+};
+
+static Encoder enc;
+
+// ---------------- capture ----------------
+struct Capture {
+  bool     active;
+  ScreenId id;
+  uint8_t  pass;          // 0 = sizing, 1 = filling
+  int16_t  y;
+  uint32_t gen;           // Render_generation() after our own last slice
+  uint8_t* data;          // allocated after the sizing pass
+  uint32_t len;
+  bool     psram;
+};
+
+static Capture cap;
+static CoopTimer capTimer;
+
+static void endCapture() {
+  cap.active = false;
+  Coop_cancel(capTimer);
+}
+
+static void abandon() {
+  if(cap.data) freeBytes(cap.data, cap.len, cap.psram);
+  cap.data = nullptr;
+  stats.abandoned++;
+  endCapture();
+}
+
+static void reject() {
+  img[cap.id].uncacheable = true;
+  stats.rejected++;
+  endCapture();
+}
+
+// one slice; the pass ends with the last row
+static void onCaptureSlice(CoopTimer&) {
+  if(!cap.active) return;
+  if(Render_generation() != cap.gen) { abandon(); return; }
+
+  {
+    RenderDirect rd;
+    for(int i=0;i<SCREEN_CACHE_SLICE_ROWS && cap.y < SCREEN_H && !enc.full;i++,cap.y++){
+      tft.readRect(0, cap.y, SCREEN_W, 1, row);
+      for(int x=0;x<SCREEN_W;x++) enc.pixel(row[x]);
+    }
+  }
+  cap.gen = Render_generation();
+  if(enc.full) { reject(); return; }
+  if(cap.y < SCREEN_H) return;
+
+  enc.emit();
+  if(cap.pass == 0) {
+    cap.len = enc.n + enc.colors * 2u;
+    cap.data = allocImage(cap.len, cap.psram);
+    if(!cap.data) { reject(); return; }
+    if(!cap.psram) heapBytes += cap.len;
+    stats.bytes += cap.len;
+    enc.begin(cap.data);
+    memcpy(cap.data, enc.pal, enc.colors * 2u);
+    cap.pass = 1;
+    cap.y = 0;
+    return;
+  }
+
+  Image& im = img[cap.id];
+  im.data = cap.data;
+  im.len = cap.len;
+  im.psram = cap.psram;
+  im.colors = (uint8_t)enc.colors;
+  cap.data = nullptr;
+  stats.captures++;
+  endCapture();
+}
+
+static void startCapture(ScreenId id) {
+  if(cap.active) abandon();
+  cap.active = true;
+  cap.id = id;
+  cap.pass = 0;
+  cap.y = 0;
+  cap.data = nullptr;
+  cap.gen = Render_generation();
+  enc.colors = 0;
+  enc.begin(nullptr);
+  Coop_arm(capTimer, SCREEN_CACHE_SLICE_MS, onCaptureSlice, SCREEN_CACHE_SLICE_MS);
+}
+
+// ---------------- decoder ----------------
+static void blit(const Image& im) {
+  const uint8_t* pal = im.data;
+  const uint8_t* p = im.data + im.colors * 2u;
+  const uint8_t* end = im.data + im.len;
+  uint16_t color = 0;
+  uint32_t left = 0;
+
+  for(int y=0;y<SCREEN_H;y+=SCREEN_CACHE_BAND_ROWS){
+    int h = SCREEN_H - y < SCREEN_CACHE_BAND_ROWS ? SCREEN_H - y : SCREEN_CACHE_BAND_ROWS;
+    uint32_t px = (uint32_t)SCREEN_W * h;
+    tft.startWrite();
+    tft.setAddrWindow(0, y, SCREEN_W, h);
+    while(px) {
+      if(!left) {
+        if(p >= end) break;
+        uint8_t i = *p++;
+        left = *p++;
+        if(!left) { left = p[0] | (p[1] << 8); p += 2; }
+        color = (uint16_t)(pal[2 * i] | (pal[2 * i + 1] << 8));
+      }
+      uint32_t n = left < px ? left : px;
+      tft.pushColor(color, n);
+      left -= n;
+      px -= n;
+    }
+    tft.endWrite();
+    SpiBus_yield(SPI_DEV_TFT);
+  }
+}
+
+// ---------------- API ----------------
+void ScreenCache_draw(ScreenId id, ScreenPaintFn paint) {
+  RenderDirect rd;
+  Image& im = img[id];
+  if(im.data) {
+    blit(im);
+    stats.hits++;
+    return;
+  }
+  paint();
+  stats.paints++;
+  if(!im.uncacheable) startCapture(id);
+}
+
+void ScreenCache_drop(ScreenId id) {
+  if(cap.active && cap.id == id) abandon();
+  freeImage(img[id]);
+  img[id].uncacheable = false;
+}
+
+uint32_t ScreenCache_size(ScreenId id) { return img[id].len; }
+
+const ScreenCacheStats& ScreenCache_stats() { return stats; }
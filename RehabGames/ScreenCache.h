@@ -0,0 +1,57 @@
+#pragma once
+#include "Shared.h"
+
+// ---------------- Screen cache ----------------
+// Static screens (menus, level pickers, RFID retry) are painted primitive by
+// primitive once, read back from the panel (readRect; the ILI9341's SDO sits
+// on MISO) and kept as a palette + run-length image. Every later showing is
+// one pass of pixel streams: a band of 24 rows per address window, so a
+// touch read still gets the bus between bands (SpiBus_yield). 150 KB of
+// pixels at 40 MHz is ~31 ms, against ~75 ms for the primitives.
+//
+// Reading back is slow (3 bytes per pixel at 20 MHz, twice: size, then
+// fill), so it runs from a Coop timer after the first showing, 8 rows per
+// slice. Anything drawn in between (Render_generation() moved) abandons the
+// capture; the next showing paints and starts over.
+//
+// Image: up to 255 RGB565 colours, then runs of (index, length) in row
+// order; length 1..255 in one byte, longer runs as 0 + 16 bits. A screen
+// with more colours is painted every time. Images go to PSRAM when the
+// board has it, otherwise to the heap within SCREEN_CACHE_HEAP_BUDGET and
+// only while MemMon's low-heap threshold stays clear.
+//
+// Paint functions must draw the same thing every time (stars included: the
+// first showing's are kept). Dynamic content is drawn by the caller after
+// ScreenCache_draw() returns, on top of the image.
+
+enum ScreenId : uint8_t {
+  SCREEN_MENU,            // drawMenu() in the sketch
+  SCREEN_MENU_GAMES,      // Menu_draw(), the way back from Games 2 and 3
+  SCREEN_G1_LEVEL,
+  SCREEN_G2_LEVEL,
+  SCREEN_G2_RETRY,
+  SCREEN_G3_LEVEL,
+  SCREEN_G3_RETRY,
+  SCREEN_COUNT
+};
+
+static const uint32_t SCREEN_CACHE_HEAP_BUDGET = 48 * 1024;
+static const uint8_t  SCREEN_CACHE_BAND_ROWS   = 24;
+static const uint8_t  SCREEN_CACHE_SLICE_ROWS  = 8;    // read back per slice (~3 ms)
+static const uint32_t SCREEN_CACHE_SLICE_MS    = 10;
+
+struct ScreenCacheStats {
+  uint32_t hits;          // shown from the image
+  uint32_t paints;        // painted primitive by primitive
+  uint32_t captures;      // images built
+  uint32_t abandoned;     // screen changed while reading back
+  uint32_t rejected;      // too many colours / no memory
+  uint32_t bytes;         // images held
+};
+
+typedef void (*ScreenPaintFn)();
+
+void ScreenCache_draw(ScreenId id, ScreenPaintFn paint);   // takes a RenderDirect
+void ScreenCache_drop(ScreenId id);                         // repaint + recapture next time
+uint32_t ScreenCache_size(ScreenId id);                     // image bytes, 0 = not cached
+const ScreenCacheStats& ScreenCache_stats();
@@ -1,4 +1,10 @@
 #include "Shared.h"
+#include "Stimulus.h"
+#include "Leds.h"
+#include "Render.h"
+#include "SpiBus.h"
+#include "Rfid.h"
+#include "TouchFilter.h"
 
 // --------- global objects (single instance) ----------
 TFT_eSPI tft = TFT_eSPI();
@@ -20,8 +26,6 @@ bool TOUCH_SWAP_XY  = false;
 bool TOUCH_INVERT_X = true;
 bool TOUCH_INVERT_Y = false;
 
-static uint32_t lastTouchMs = 0;
-
 static int clampi(int v,int lo,int hi){ if(v<lo) return lo; if(v>hi) return hi; return v; }
 
 bool inRect(int x,int y,int rx,int ry,int rw,int rh){
@@ -29,20 +33,81 @@ bool inRect(int x,int y,int rx,int ry,int rw,int rh){
 }
 
 // ---- touch reading ----
-static bool readTouchRawInternal(TS_Point &out){
-  digitalWrite(TFT_CS_PIN, HIGH);
-
-  if (TOUCH_IRQ != 255 && digitalRead(TOUCH_IRQ) == HIGH) return false;
+// conversions go through the build-time filter chain (TouchFilter.h)
+static TouchFilter touchFilter;
+static uint32_t    touchPollMs = 0;
+static AppScreen   touchScreen = SCR_MENU;
+
+// longer than this without a poll (a blocking wait, a screen change) and
+// what the filter holds says nothing about the finger now
+static const uint32_t TOUCH_STALE_MS       = 100;
+static const uint32_t TOUCH_RELEASE_MAX_MS = 3000;
+
+#if defined(ARDUINO_ARCH_ESP32)
+static int16_t mid3(int16_t a, int16_t b, int16_t c){
+  if(a > b){ int16_t t=a; a=b; b=t; }
+  return c < a ? a : (c > b ? b : c);
+}
 
-  TS_Point best(0,0,0);
-  for(int i=0;i<6;i++){
-    TS_Point p = ts.getPoint();
-    if(p.z > best.z) best = p;
-    delay(2);
+// One XPT2046 conversion straight off the bus, at the touch entry of the
+// SpiBus table: ts.getPoint() opens its own transaction at its own clock
+// (and hands back a cached point inside 3 ms, which the filter's gap is
+// shorter than). Same command sequence as the library: Z1, Z2, a dummy X,
+// three X/Y pairs, the last Y powering down so PENIRQ works again.
+static TS_Point xptConversion(){
+  int16_t x[3], y[3];
+  SPI.beginTransaction(SpiBus_settings(SPI_DEV_TOUCH));
+  digitalWrite(TOUCH_CS, LOW);
+  SPI.transfer(0xB1);
+  int16_t z1 = SPI.transfer16(0xC1) >> 3;
+  int16_t z2 = SPI.transfer16(0x91) >> 3;
+  SPI.transfer16(0x91);
+  x[0] = SPI.transfer16(0xD1) >> 3;
+  y[0] = SPI.transfer16(0x91) >> 3;
+  x[1] = SPI.transfer16(0xD1) >> 3;
+  y[1] = SPI.transfer16(0x91) >> 3;
+  x[2] = SPI.transfer16(0xD0) >> 3;
+  y[2] = SPI.transfer16(0) >> 3;
+  digitalWrite(TOUCH_CS, HIGH);
+  SPI.endTransaction();
+
+  int z = z1 + 4095 - z2;
+  if(z < 0) z = 0;
+  int16_t px = mid3(x[0], x[1], x[2]), py = mid3(y[0], y[1], y[2]);
+  switch(TS_ROT){                  // as XPT2046_Touchscreen::setRotation
+    case 0:  return TS_Point(4095 - py, px, z);
+    case 1:  return TS_Point(px, py, z);
+    case 2:  return TS_Point(py, 4095 - px, z);
+    default: return TS_Point(4095 - px, 4095 - py, z);
   }
+}
+#endif
+
+static TouchSample readConversion(void*, uint8_t i){
+  if(i) delayMicroseconds(TOUCH_FILTER_GAP_US);
+  TS_Point p;
+  {
+    SpiLock bus(SPI_DEV_TOUCH);    // slots in between TFT primitives
+#if defined(ARDUINO_ARCH_ESP32)
+    p = xptConversion();
+#else
+    p = ts.getPoint();             // the simulator's panel
+#endif
+  }
+  TouchSample s = { p.x, p.y, p.z };
+  return s;
+}
 
-  if(best.z < Z_MIN || best.z > Z_MAX) return false;
-  out = best;
+static bool readTouchRawInternal(TS_Point &out){
+  uint32_t now = millis();
+  if(now - touchPollMs > TOUCH_STALE_MS || g_screen != touchScreen) TouchFilter_restart(touchFilter);
+  touchPollMs = now;
+  touchScreen = g_screen;
+  if (TOUCH_IRQ != 255 && digitalRead(TOUCH_IRQ) == HIGH) { TouchFilter_reset(touchFilter); return false; }
+
+  TouchSample s;
+  if(!TouchFilter_poll(touchFilter, readConversion, nullptr, s)) return false;
+  out = TS_Point(s.x, s.y, s.z);
   return true;
 }
 
@@ -66,49 +131,59 @@ static bool rawToScreenInternal(const TS_Point &raw, int &sx, int &sy){
 
 bool Touch_pressed(int &sx, int &sy){
   TS_Point raw;
-  if(!readTouchRawInternal(raw)) return false;
-  if(millis() - lastTouchMs < 220) return false;
-  lastTouchMs = millis();
+  if(!readTouchRawInternal(raw)) return false;   // once per press (TouchFilter.h)
   return rawToScreenInternal(raw, sx, sy);
 }
 
+void Touch_waitRelease(){
+  uint32_t start = millis();
+  TouchSample s;
+  for(;;){
+    if (TOUCH_IRQ != 255 && digitalRead(TOUCH_IRQ) == HIGH) { TouchFilter_reset(touchFilter); break; }
+    TouchFilter_poll(touchFilter, readConversion, nullptr, s);
+    if(TouchFilter_idle(touchFilter)) break;
+    // a panel stuck at pressure: give up, the press stays reported
+    if(millis() - start > TOUCH_RELEASE_MAX_MS) break;
+    delay(5);
+  }
+  touchPollMs = millis();
+  touchScreen = g_screen;
+}
+
 bool Touch_pressedRaw(int &sx, int &sy, TS_Point &raw){
   if(!readTouchRawInternal(raw)) return false;
-  if(millis() - lastTouchMs < 220) return false;
-  lastTouchMs = millis();
   rawToScreenInternal(raw, sx, sy);
   return true;
 }
 
 
-void Shared_setupHardware(){
-  pinMode(TFT_CS_PIN, OUTPUT);
-  digitalWrite(TFT_CS_PIN, HIGH);
-
-  pinMode(TOUCH_CS, OUTPUT);
-  digitalWrite(TOUCH_CS, HIGH);
+// the TFT may still be pushing a DMA block when touch wants the bus
+static void tftQuiesce(){
+#if defined(ARDUINO_ARCH_ESP32)
+  tft.dmaWait();
+#endif
+}
 
+void Shared_setupHardware(){
   if(TOUCH_IRQ != 255) pinMode(TOUCH_IRQ, INPUT);
 
-  SPI.begin(SPI_SCK_PIN, SPI_MISO_PIN, SPI_MOSI_PIN);
+  SpiBus_begin(SPI_SCK_PIN, SPI_MISO_PIN, SPI_MOSI_PIN);
+  SpiBus_addDevice(SPI_DEV_TFT,   { "tft",   TFT_CS_PIN, TFT_SPI_HZ,   SPI_MODE0, tftQuiesce });
+  SpiBus_addDevice(SPI_DEV_TOUCH, { "touch", TOUCH_CS,   TOUCH_SPI_HZ, SPI_MODE0, nullptr });
 
   tft.init();
   tft.setRotation(TFT_ROT);
   tft.setTextWrap(false);
+  Render_begin();
 
   ts.begin();
   ts.setRotation(TS_ROT);
+  TouchFilter_init(touchFilter, TOUCH_FILTER_BUILD);
 
-  strip.begin();
-  strip.clear();
-  strip.show();
-
-  Wire.begin(PN532_SDA, PN532_SCL);
-  Wire.setClock(100000);
-  Wire.setTimeOut(50);
+  Leds_begin();
+  Stimulus_begin();
 
-  nfc.begin();
-  nfc.SAMConfig();
+  Rfid_begin();
 }
 void Shared_touchTick() {
   // optional place to handle touch IRQ filtering / future features.
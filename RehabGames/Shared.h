@@ -16,11 +16,23 @@
 
 #define LED_PIN      25
 #define LED_COUNT    32
+// Bigger peg boards split the strip into chains on their own pins, sent in
+// parallel (Leds.h). Indices stay 0..LED_COUNT-1 (LED_ZONES are unchanged);
+// chain c holds [c * LED_CHAIN_LEN, (c + 1) * LED_CHAIN_LEN).
+#ifndef LED_CHAINS
+#define LED_CHAINS     1
+#define LED_CHAIN_PINS { LED_PIN }
+#endif
 
 #define SPI_SCK_PIN  18
 #define SPI_MISO_PIN 19
 #define SPI_MOSI_PIN 23
 
+// SPI clocks: TFT = SPI_FREQUENCY in TFT_eSPI's User_Setup.h (55 MHz there,
+// 40 MHz effective on the ESP32); touch reads run at TOUCH_SPI_HZ (SpiBus.h)
+#define TFT_SPI_HZ   40000000UL
+#define TOUCH_SPI_HZ 2000000UL
+
 // ---------------- SCREEN ----------------
 static const int SCREEN_W = 320;
 static const int SCREEN_H = 240;
@@ -54,10 +66,14 @@ extern AppScreen g_screen;
 // ---------------- Touch API ----------------
 bool Touch_pressed(int &sx, int &sy);                 // debounced press -> screen coords
 bool Touch_pressedRaw(int &sx, int &sy, TS_Point &raw);
+void Touch_waitRelease();                             // until the finger is off; the next press starts fresh
 
 bool inRect(int x,int y,int rx,int ry,int rw,int rh);
 void reportScore(int coins, int score);
 
+struct RtSummary;
+void reportSession(const RtSummary& s);   // RtStats.h, one per finished session
+
 
 // init all hardware once (called from setup in .ino)
 void Shared_setupHardware();
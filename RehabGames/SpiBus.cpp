@@ -0,0 +1,122 @@
+// SpiBus.cpp – shared SPI bus ownership (TFT + touch)
+#include "SpiBus.h"
+#include <atomic>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+static SemaphoreHandle_t busMutex = nullptr;
+#endif
+
+static SpiDevice   devs[SPI_DEV_COUNT];
+static SpiDevStats stats[SPI_DEV_COUNT];
+
+// only touched by whoever holds the bus
+static int8_t   owner = -1;          // device the bus was last handed to
+static uint8_t  depth = 0;           // recursion depth of the holder
+static SpiDev   holdDev = SPI_DEV_TFT;
+static uint32_t holdStartUs = 0;
+static uint32_t stretchStartUs = 0;
+
+static std::atomic<uint8_t> waiters(0);
+
+static void noteMax(uint32_t& m, uint32_t v) { if(v > m) m = v; }
+
+static void handoff(SpiDev d) {
+  if(owner >= 0 && devs[owner].quiesce) devs[owner].quiesce();
+  for(int i=0;i<SPI_DEV_COUNT;i++) {
+    if(i != d && devs[i].csPin >= 0) digitalWrite(devs[i].csPin, HIGH);
+  }
+  owner = d;
+  stats[d].handoffs++;
+}
+
+void SpiBus_begin(int8_t sck, int8_t miso, int8_t mosi) {
+  SPI.begin(sck, miso, mosi);
+#if defined(ARDUINO_ARCH_ESP32)
+  if(!busMutex) busMutex = xSemaphoreCreateRecursiveMutex();
+#endif
+}
+
+void SpiBus_addDevice(SpiDev d, const SpiDevice& cfg) {
+  devs[d] = cfg;
+  if(cfg.csPin >= 0) {
+    pinMode(cfg.csPin, OUTPUT);
+    digitalWrite(cfg.csPin, HIGH);
+  }
+}
+
+void SpiBus_acquire(SpiDev d) {
+#if defined(ARDUINO_ARCH_ESP32)
+  if(busMutex && xSemaphoreTakeRecursive(busMutex, 0) != pdTRUE) {
+    uint32_t t0 = micros();
+    waiters++;
+    xSemaphoreTakeRecursive(busMutex, portMAX_DELAY);
+    waiters--;
+    stats[d].contended++;
+    noteMax(stats[d].waitUsMax, micros() - t0);
+  }
+#endif
+  if(depth++ == 0) {
+    holdDev = d;
+    holdStartUs = stretchStartUs = micros();
+  }
+  stats[d].acquires++;
+  if(owner != d) handoff(d);
+}
+
+void SpiBus_release(SpiDev d) {
+  (void)d;
+  if(depth == 0) return;
+  if(--depth == 0) {
+    uint32_t now = micros();
+    noteMax(stats[holdDev].holdUsMax, now - holdStartUs);
+    noteMax(stats[holdDev].stretchUsMax, now - stretchStartUs);
+  }
+#if defined(ARDUINO_ARCH_ESP32)
+  if(busMutex) xSemaphoreGiveRecursive(busMutex);
+#endif
+}
+
+bool SpiBus_yield(SpiDev d) {
+  if(depth == 0) return false;
+  uint32_t now = micros();
+  noteMax(stats[holdDev].stretchUsMax, now - stretchStartUs);
+  stretchStartUs = now;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  uint8_t w = waiters.load();
+  if(!busMutex || w == 0) return false;
+
+  // let go completely (the mutex is recursive), give the waiter a moment
+  // to take it, then queue up behind it
+  uint8_t  savedDepth = depth;
+  SpiDev   savedDev = holdDev;
+  uint32_t savedStart = holdStartUs;
+  if(owner >= 0 && devs[owner].quiesce) devs[owner].quiesce();
+  depth = 0;
+  for(uint8_t i=0;i<savedDepth;i++) xSemaphoreGiveRecursive(busMutex);
+
+  uint32_t t0 = micros();
+  while(waiters.load() >= w && micros() - t0 < 200) taskYIELD();
+
+  for(uint8_t i=0;i<savedDepth;i++) xSemaphoreTakeRecursive(busMutex, portMAX_DELAY);
+  depth = savedDepth;
+  holdDev = savedDev;
+  holdStartUs = savedStart;
+  stretchStartUs = micros();
+  if(owner != d) handoff(d);
+  stats[d].yields++;
+  return true;
+#else
+  (void)d;
+  return false;
+#endif
+}
+
+SPISettings SpiBus_settings(SpiDev d) {
+  return SPISettings(devs[d].clockHz, MSBFIRST, devs[d].mode);
+}
+
+const SpiDevice&   SpiBus_device(SpiDev d) { return devs[d]; }
+const SpiDevStats& SpiBus_stats(SpiDev d) { return stats[d]; }
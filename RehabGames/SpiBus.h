@@ -0,0 +1,54 @@
+#pragma once
+#include <Arduino.h>
+#include <SPI.h>
+
+// ---------------- SPI bus manager ----------------
+// The TFT and the XPT2046 share SCK/MOSI/MISO. Whoever talks to a device
+// holds the bus for it (SpiLock / SpiBus_acquire); handing the bus to another
+// device first lets the previous one finish (quiesce: e.g. wait for a TFT
+// DMA transfer) and makes sure every other chip select is released.
+//
+// Long paints call SpiBus_yield() between primitives: if another device is
+// waiting it gets the bus right there, so a touch read waits at most one
+// stretch (tracked as stretchUsMax) instead of a whole screen.
+//
+// Touch conversions are raw transfers under SpiBus_settings(SPI_DEV_TOUCH)
+// (Shared.cpp), so the touch entry's clock and mode are what the XPT2046
+// sees. TFT_eSPI opens its own transactions at SPI_FREQUENCY; its entry
+// mirrors that and only names the device. Never yield inside
+// startWrite()/endWrite().
+
+enum SpiDev : uint8_t { SPI_DEV_TFT, SPI_DEV_TOUCH, SPI_DEV_COUNT };
+
+struct SpiDevice {
+  const char* name;
+  int8_t      csPin;
+  uint32_t    clockHz;
+  uint8_t     mode;
+  void      (*quiesce)();   // before the bus goes to another device (may be null)
+};
+
+struct SpiDevStats {
+  uint32_t acquires;
+  uint32_t contended;       // had to wait for another device
+  uint32_t handoffs;        // bus switched to this device
+  uint32_t yields;          // gave the bus away mid-paint
+  uint32_t waitUsMax;
+  uint32_t holdUsMax;       // longest acquire..release
+  uint32_t stretchUsMax;    // longest hold without a yield point
+};
+
+void SpiBus_begin(int8_t sck, int8_t miso, int8_t mosi);
+void SpiBus_addDevice(SpiDev d, const SpiDevice& cfg);
+void SpiBus_acquire(SpiDev d);             // recursive
+void SpiBus_release(SpiDev d);
+bool SpiBus_yield(SpiDev d);               // holder only; true if the bus was handed over
+SPISettings SpiBus_settings(SpiDev d);
+const SpiDevice&   SpiBus_device(SpiDev d);
+const SpiDevStats& SpiBus_stats(SpiDev d);
+
+struct SpiLock {
+  explicit SpiLock(SpiDev d) : dev(d) { SpiBus_acquire(d); }
+  ~SpiLock() { SpiBus_release(dev); }
+  SpiDev dev;
+};
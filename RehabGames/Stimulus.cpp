@@ -0,0 +1,169 @@
+// Stimulus.cpp – timer-driven LED stimulus presentation
+#include "Stimulus.h"
+#include "Coop.h"
+#include "Leds.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <esp_timer.h>
+static esp_timer_handle_t stimTimer = nullptr;
+#endif
+
+static StimStep steps[STIM_MAX_STEPS];
+static int nSteps = 0;
+
+// edges: 2 per step (on, off) + one "timeline over" after the last gap
+static volatile int  edge = 0;
+static volatile bool running = false;
+static uint32_t t0Us = 0;
+static uint32_t planUs[2 * STIM_MAX_STEPS + 1];
+static uint32_t showUs = 1000;        // how long strip.show() takes (learned)
+static int32_t  worstErrUs = 0;
+
+static int edgeCount() { return 2 * nSteps + 1; }
+
+static void armNext();
+
+// the LED frame is shared with the game loop: hold it for the whole edge
+static void fireEdge() {
+  LedsLock leds;
+  if(!running) return;                // stopped while this edge waited for the lock
+  int e = edge;
+  int i = e >> 1;
+  uint32_t doneUs;
+
+  if(e == 2 * nSteps) {
+    doneUs = micros();
+  } else {
+    uint32_t startUs = micros();
+    Leds_clear();
+    if(!(e & 1) && steps[i].led >= 0) Leds_set(steps[i].led, steps[i].color);
+    bool pushed = Leds_showNow();
+    doneUs = micros();
+    if(pushed) showUs = (showUs * 3 + (doneUs - startUs)) / 4;
+
+    if(e & 1) steps[i].offsetUs = doneUs;
+    else      steps[i].onsetUs  = doneUs;
+
+    int32_t err = (int32_t)(doneUs - planUs[e]);
+    if(err < 0) err = -err;
+    if(err > worstErrUs) worstErrUs = err;
+  }
+
+  edge = e + 1;
+  if(edge >= edgeCount()) running = false;
+  else armNext();
+}
+
+// show() latches at its end, so start it showUs early
+static int32_t dueInUs() {
+  uint32_t at = planUs[edge];
+  if(edge < 2 * nSteps) at -= showUs;
+  return (int32_t)(at - micros());
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void onStimTimer(void*) {
+  fireEdge();
+}
+
+static void armNext() {
+  int32_t d = dueInUs();
+  esp_timer_start_once(stimTimer, d > 0 ? d : 1);
+}
+#else
+// no hardware timer: the cooperative runtime wakes loop() for each edge
+static CoopTimer stimCoop;
+
+static void onStimCoop(CoopTimer&) {
+  if(!running) return;
+  int32_t d = dueInUs();
+  if(d > 0) delayMicroseconds(d);
+  fireEdge();
+}
+
+static void armNext() {
+  int32_t d = dueInUs();
+  Coop_arm(stimCoop, d > 0 ? d / 1000 : 0, onStimCoop);
+}
+#endif
+
+void Stimulus_begin() {
+#if defined(ARDUINO_ARCH_ESP32)
+  if(stimTimer) return;
+  esp_timer_create_args_t args = {};
+  args.callback = onStimTimer;
+  args.dispatch_method = ESP_TIMER_TASK;
+  args.name = "stim";
+  esp_timer_create(&args, &stimTimer);
+#endif
+}
+
+void Stimulus_clear() {
+  if(running) return;
+  nSteps = 0;
+}
+
+bool Stimulus_add(int16_t led, uint32_t color, uint32_t onMs, uint32_t gapMs) {
+  if(running || nSteps >= STIM_MAX_STEPS) return false;
+  StimStep& s = steps[nSteps++];
+  s.led = led;
+  s.color = color;
+  s.onUs = onMs * 1000UL;
+  s.gapUs = gapMs * 1000UL;
+  s.onsetUs = s.offsetUs = 0;
+  return true;
+}
+
+void Stimulus_start(uint32_t leadUs) {
+  if(running || nSteps == 0) return;
+#if defined(ARDUINO_ARCH_ESP32)
+  if(!stimTimer) Stimulus_begin();
+#endif
+
+  Leds_flush();   // nothing of the game's may land mid-timeline
+
+  // plan every edge up front so timer latency never accumulates
+  t0Us = micros() + leadUs;
+  uint32_t t = t0Us;
+  for(int i=0;i<nSteps;i++){
+    planUs[2*i]     = t;  t += steps[i].onUs;
+    planUs[2*i + 1] = t;  t += steps[i].gapUs;
+  }
+  planUs[2 * nSteps] = t;
+
+  worstErrUs = 0;
+  edge = 0;
+  running = true;
+  armNext();
+}
+
+bool Stimulus_running() { return running; }
+
+void Stimulus_stop() {
+  running = false;
+#if defined(ARDUINO_ARCH_ESP32)
+  if(stimTimer) esp_timer_stop(stimTimer);
+  // an edge already in the timer task finishes before the caller's LEDs go out
+  LedsLock leds;
+#else
+  Coop_cancel(stimCoop);
+#endif
+}
+
+void Stimulus_wait() {
+#if defined(ARDUINO_ARCH_ESP32)
+  while(running) delay(1);
+#else
+  // no hardware timer: sleep up to each edge and fire it here
+  while(running) {
+    int32_t d = dueInUs();
+    if(d >= 1000) delay(d / 1000);
+    else if(d > 0) delayMicroseconds(d);
+    else fireEdge();
+  }
+#endif
+}
+
+int Stimulus_count() { return nSteps; }
+const StimStep& Stimulus_step(int i) { return steps[i]; }
+int32_t Stimulus_worstErrorUs() { return worstErrUs; }
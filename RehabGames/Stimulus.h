@@ -0,0 +1,33 @@
+#pragma once
+#include "Shared.h"
+
+// ---------------- Stimulus timeline ----------------
+// LED steps (light one LED for onMs, dark for gapMs) latched by esp_timer at
+// their scheduled time instead of by delay() in the game loop, so exposure
+// does not drift with SPI/RFID load. Every edge records when the strip
+// actually latched (micros()).
+//
+// Don't touch the strip while Stimulus_running().
+
+static const int STIM_MAX_STEPS = 16;
+
+struct StimStep {
+  int16_t  led;        // -1 = nothing lit
+  uint32_t color;
+  uint32_t onUs;
+  uint32_t gapUs;
+  uint32_t onsetUs;    // measured, micros() when the LED latched on
+  uint32_t offsetUs;   // measured, micros() when it latched off
+};
+
+void Stimulus_begin();                     // once, from Shared_setupHardware()
+void Stimulus_clear();
+bool Stimulus_add(int16_t led, uint32_t color, uint32_t onMs, uint32_t gapMs);
+void Stimulus_start(uint32_t leadUs = 0);  // first onset lands at now + leadUs
+bool Stimulus_running();
+void Stimulus_stop();                      // abandon (e.g. BACK); LEDs stay as they are, an edge
+                                           // already firing lands before this returns
+void Stimulus_wait();                      // until the last gap has passed
+int  Stimulus_count();
+const StimStep& Stimulus_step(int i);
+int32_t Stimulus_worstErrorUs();           // max |measured - planned| of the last run
@@ -0,0 +1,103 @@
+// TouchFilter.cpp – median / pressure gate / press count / IIR / jitter, integers only
+#include "TouchFilter.h"
+
+static int16_t median(int16_t* v, uint8_t n) {
+  for(uint8_t i=1;i<n;i++){
+    int16_t t = v[i];
+    uint8_t j = i;
+    while(j > 0 && v[j - 1] > t) { v[j] = v[j - 1]; j--; }
+    v[j] = t;
+  }
+  return v[n / 2];
+}
+
+static int32_t absi(int32_t v) { return v < 0 ? -v : v; }
+
+void TouchFilter_init(TouchFilter& f, const TouchFilterCfg& cfg) {
+  f.cfg = cfg;
+  if(f.cfg.median < 1) f.cfg.median = 1;
+  if(f.cfg.median > TOUCH_FILTER_MAX_MEDIAN) f.cfg.median = TOUCH_FILTER_MAX_MEDIAN;
+  if(f.cfg.pressN < 1) f.cfg.pressN = 1;
+  if(f.cfg.burst < 1) f.cfg.burst = 1;
+  TouchFilter_reset(f);
+}
+
+void TouchFilter_reset(TouchFilter& f) {
+  f.fill = 0;
+  f.pos = 0;
+  f.run = 0;
+  f.down = false;
+}
+
+void TouchFilter_restart(TouchFilter& f) {
+  f.fill = 0;
+  f.pos = 0;
+  f.run = 0;
+}
+
+bool TouchFilter_idle(const TouchFilter& f) { return f.fill == 0 && !f.down; }
+
+bool TouchFilter_add(TouchFilter& f, const TouchSample& s, TouchSample& out) {
+  const TouchFilterCfg& c = f.cfg;
+
+  // median
+  f.ring[f.pos] = s;
+  f.pos = (uint8_t)((f.pos + 1) % c.median);
+  if(f.fill < c.median) f.fill++;
+  if(f.fill < c.median) return false;
+  TouchSample m;
+  int16_t v[TOUCH_FILTER_MAX_MEDIAN];
+  for(uint8_t i=0;i<c.median;i++) v[i] = f.ring[i].x;
+  m.x = median(v, c.median);
+  for(uint8_t i=0;i<c.median;i++) v[i] = f.ring[i].y;
+  m.y = median(v, c.median);
+  for(uint8_t i=0;i<c.median;i++) v[i] = f.ring[i].z;
+  m.z = median(v, c.median);
+
+  // gate
+  if(m.z < (int16_t)c.zMin || m.z > (int16_t)c.zMax) { f.run = 0; return false; }
+
+  // press
+  if(f.run < 255) f.run++;
+  if(f.run < c.pressN) return false;
+
+  // iir, jitter
+  if(f.run == c.pressN) {
+    f.sx = (int32_t)m.x << 4;
+    f.sy = (int32_t)m.y << 4;
+    f.hx = m.x;
+    f.hy = m.y;
+  } else {
+    if(c.iirShift) {
+      f.sx += (((int32_t)m.x << 4) - f.sx) >> c.iirShift;
+      f.sy += (((int32_t)m.y << 4) - f.sy) >> c.iirShift;
+    } else {
+      f.sx = (int32_t)m.x << 4;
+      f.sy = (int32_t)m.y << 4;
+    }
+    int16_t px = (int16_t)((f.sx + 8) >> 4), py = (int16_t)((f.sy + 8) >> 4);
+    if(absi(px - f.hx) > c.jitter || absi(py - f.hy) > c.jitter) { f.hx = px; f.hy = py; }
+  }
+  out.x = f.hx;
+  out.y = f.hy;
+  out.z = m.z;
+  return true;
+}
+
+bool TouchFilter_poll(TouchFilter& f, TouchReadFn read, void* ctx, TouchSample& out, uint8_t* used) {
+  bool pressed = false;
+  uint8_t i = 0;
+  while(i < f.cfg.burst) {
+    TouchSample s = read(ctx, i++);
+    // no pressure and no press going on: released (or never touched), stop
+    if(s.z < (int16_t)f.cfg.zMin && f.run == 0) { TouchFilter_reset(f); break; }
+    if(TouchFilter_add(f, s, out)) {
+      // held since the last report: nothing new
+      pressed = !f.down;
+      f.down = true;
+      break;
+    }
+  }
+  if(used) *used = i;
+  return pressed;
+}
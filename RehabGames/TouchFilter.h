@@ -0,0 +1,99 @@
+#pragma once
+#include "Shared.h"
+
+// ---------------- Touch filter ----------------
+// Raw XPT2046 conversions go through a chain of integer stages, in order:
+//   median   x, y and z each the median of the last TOUCH_FILTER_MEDIAN
+//            conversions (1 = off, up to 5): drops single spikes, costs
+//            N - 1 conversions before the first output
+//   gate     z inside [TOUCH_FILTER_Z_MIN, TOUCH_FILTER_Z_MAX], else the
+//            panel counts as released and every stage starts over
+//   press    TOUCH_FILTER_PRESS_N gated outputs in a row before it counts
+//            as a press: a one-conversion EMI blip never gets there
+//   iir      p += (s - p) >> TOUCH_FILTER_IIR_SHIFT on 4 fractional bits
+//            (0 = off)
+//   jitter   the reported point moves only once the smoothed one is more
+//            than TOUCH_FILTER_JITTER raw units away (0 = off)
+// A poll (Touch_pressed()) takes at most TOUCH_FILTER_BURST conversions,
+// TOUCH_FILTER_GAP_US apart, and stops at the first press or the first
+// conversion without pressure; state carries over to the next poll while
+// the finger stays down. An untouched panel costs one conversion a poll.
+// A poll reports a press once, on the poll that completes it; a finger held
+// down reports nothing more until the panel reads released (no pressure
+// with the press count back at 0, TouchFilter_idle()), so a long press is
+// one tap. TouchFilter_restart() drops the median and press count but not
+// that memory: for state that went stale while nobody polled.
+//
+// Everything is set at build time (-DTOUCH_FILTER_MEDIAN=5 ...); the host
+// harness (host/touch_eval.cpp) replays raw traces through any set of
+// TouchFilterCfg and reports press latency, repeated and ghost presses and
+// position error, which is how the defaults below were picked: on its
+// synthetic traces ~10 ms from finger down to press, no repeats and no
+// ghost presses, against 17-18 ms, ~4 ghosts a minute and a repeat on
+// about one press in three (held past Touch_pressed()'s old 220 ms gap)
+// for the old highest-pressure-of-six read, which also held loop() for
+// 12 ms on every poll.
+#ifndef TOUCH_FILTER_MEDIAN
+#define TOUCH_FILTER_MEDIAN     3
+#endif
+#ifndef TOUCH_FILTER_Z_MIN
+#define TOUCH_FILTER_Z_MIN      Z_MIN
+#endif
+#ifndef TOUCH_FILTER_Z_MAX
+#define TOUCH_FILTER_Z_MAX      Z_MAX
+#endif
+#ifndef TOUCH_FILTER_PRESS_N
+#define TOUCH_FILTER_PRESS_N    3
+#endif
+#ifndef TOUCH_FILTER_IIR_SHIFT
+#define TOUCH_FILTER_IIR_SHIFT  0
+#endif
+#ifndef TOUCH_FILTER_JITTER
+#define TOUCH_FILTER_JITTER     0
+#endif
+#ifndef TOUCH_FILTER_BURST
+#define TOUCH_FILTER_BURST      6
+#endif
+#ifndef TOUCH_FILTER_GAP_US
+#define TOUCH_FILTER_GAP_US     1000
+#endif
+
+static const uint8_t TOUCH_FILTER_MAX_MEDIAN = 5;
+
+struct TouchFilterCfg {
+  uint8_t  median;
+  uint16_t zMin, zMax;
+  uint8_t  pressN;
+  uint8_t  iirShift;
+  uint16_t jitter;
+  uint8_t  burst;
+  uint16_t gapUs;
+};
+
+static const TouchFilterCfg TOUCH_FILTER_BUILD = {
+  TOUCH_FILTER_MEDIAN, TOUCH_FILTER_Z_MIN, TOUCH_FILTER_Z_MAX, TOUCH_FILTER_PRESS_N,
+  TOUCH_FILTER_IIR_SHIFT, TOUCH_FILTER_JITTER, TOUCH_FILTER_BURST, TOUCH_FILTER_GAP_US
+};
+
+struct TouchSample { int16_t x, y, z; };
+
+struct TouchFilter {
+  TouchFilterCfg cfg;
+  TouchSample ring[TOUCH_FILTER_MAX_MEDIAN];
+  uint8_t  fill, pos;
+  uint8_t  run;              // gated outputs in a row
+  int32_t  sx, sy;           // smoothed, raw units << 4
+  int16_t  hx, hy;           // reported
+  bool     down;             // this press was reported by a poll
+};
+
+// one conversion; i = index within the poll (wait gapUs before it when i > 0)
+typedef TouchSample (*TouchReadFn)(void* ctx, uint8_t i);
+
+void TouchFilter_init(TouchFilter& f, const TouchFilterCfg& cfg);
+void TouchFilter_reset(TouchFilter& f);
+void TouchFilter_restart(TouchFilter& f);
+bool TouchFilter_idle(const TouchFilter& f);    // released, nothing carried over
+bool TouchFilter_add(TouchFilter& f, const TouchSample& s, TouchSample& out);   // true = pressed, out = point
+// true once per press (the transition), out = point
+bool TouchFilter_poll(TouchFilter& f, TouchReadFn read, void* ctx, TouchSample& out, uint8_t* used = nullptr);
@@ -0,0 +1,117 @@
+// HostPn532.cpp – Adafruit_PN532 stand-in speaking real frames over Wire
+#include <Adafruit_PN532.h>
+#include <string.h>
+
+static const uint8_t pn532ack[6] = {0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00};
+static const uint8_t pn532response_firmwarevers[6] = {0x00, 0x00, 0xFF, 0x06, 0xFA, 0xD5};
+
+bool Adafruit_PN532::begin() {
+  wire_->begin();
+  wire_->beginTransmission(PN532_I2C_ADDRESS);
+  if(wire_->endTransmission() != 0) return false;
+  delay(10);
+  return true;
+}
+
+bool Adafruit_PN532::SAMConfig() {
+  packetbuffer_[0] = PN532_COMMAND_SAMCONFIGURATION;
+  packetbuffer_[1] = 0x01;   // normal mode
+  packetbuffer_[2] = 0x14;   // timeout 50ms * 20 = 1 second
+  packetbuffer_[3] = 0x01;   // use IRQ pin
+  if(!sendCommandCheckAck(packetbuffer_, 4)) return false;
+  if(!waitready(100)) return false;
+  readdata(packetbuffer_, 9);
+  return packetbuffer_[6] == 0x15;
+}
+
+uint32_t Adafruit_PN532::getFirmwareVersion() {
+  packetbuffer_[0] = PN532_COMMAND_GETFIRMWAREVERSION;
+  if(!sendCommandCheckAck(packetbuffer_, 1)) return 0;
+  if(!waitready(100)) return 0;
+  readdata(packetbuffer_, 13);
+  if(memcmp(packetbuffer_, pn532response_firmwarevers, 6) != 0) return 0;
+
+  int offset = 7;
+  uint32_t response = packetbuffer_[offset++];
+  response <<= 8; response |= packetbuffer_[offset++];
+  response <<= 8; response |= packetbuffer_[offset++];
+  response <<= 8; response |= packetbuffer_[offset++];
+  return response;
+}
+
+bool Adafruit_PN532::sendCommandCheckAck(uint8_t* cmd, uint8_t cmdlen, uint16_t timeout) {
+  writecommand(cmd, cmdlen);
+  if(!waitready(timeout)) return false;
+  return readack();
+}
+
+bool Adafruit_PN532::readPassiveTargetID(uint8_t cardbaudrate, uint8_t* uid, uint8_t* uidLength,
+                                         uint16_t timeout) {
+  packetbuffer_[0] = PN532_COMMAND_INLISTPASSIVETARGET;
+  packetbuffer_[1] = 1;   // max 1 card at once
+  packetbuffer_[2] = cardbaudrate;
+  if(!sendCommandCheckAck(packetbuffer_, 3, timeout)) return false;
+
+  // wait for a card to enter the field (only possible with I2C)
+  if(!waitready(timeout)) return false;
+  readdata(packetbuffer_, 20);
+
+  // 00 00 FF LEN LCS D5 4B NbTg Tg SENS_RES(2) SEL_RES NFCIDLength NFCID..
+  if(packetbuffer_[7] != 1) return false;
+  *uidLength = packetbuffer_[12];
+  if(*uidLength > 7) return false;
+  for(uint8_t i=0;i<*uidLength;i++) uid[i] = packetbuffer_[13+i];
+  return true;
+}
+
+// ---------------- low level ----------------
+bool Adafruit_PN532::isready() {
+  if(wire_->requestFrom((uint8_t)PN532_I2C_ADDRESS, (uint8_t)1) != 1) return false;
+  return wire_->read() == PN532_I2C_READY;
+}
+
+bool Adafruit_PN532::waitready(uint16_t timeout) {
+  uint16_t timer = 0;
+  while(!isready()) {
+    if(timeout != 0) {
+      timer += 10;
+      if(timer > timeout) return false;
+    }
+    delay(10);
+  }
+  return true;
+}
+
+bool Adafruit_PN532::readack() {
+  uint8_t ackbuff[6];
+  readdata(ackbuff, 6);
+  return memcmp(ackbuff, pn532ack, 6) == 0;
+}
+
+// every I2C read starts with the status byte; drop it
+void Adafruit_PN532::readdata(uint8_t* buff, uint8_t n) {
+  memset(buff, 0, n);
+  if(wire_->requestFrom((uint8_t)PN532_I2C_ADDRESS, (uint8_t)(n + 1)) != n + 1) return;
+  wire_->read();
+  for(uint8_t i=0;i<n;i++) buff[i] = (uint8_t)wire_->read();
+}
+
+void Adafruit_PN532::writecommand(uint8_t* cmd, uint8_t cmdlen) {
+  uint8_t packet[8 + PN532_PACKBUFFSIZ];
+  uint8_t len = cmdlen + 1;
+  uint8_t sum = 0xD4;
+
+  packet[0] = 0x00;                  // preamble
+  packet[1] = 0x00;                  // start code
+  packet[2] = 0xFF;
+  packet[3] = len;
+  packet[4] = (uint8_t)(~len + 1);
+  packet[5] = 0xD4;                  // host -> PN532
+  for(uint8_t i=0;i<cmdlen;i++) { packet[6+i] = cmd[i]; sum += cmd[i]; }
+  packet[6+cmdlen] = (uint8_t)(~sum + 1);
+  packet[7+cmdlen] = 0x00;           // postamble
+
+  wire_->beginTransmission(PN532_I2C_ADDRESS);
+  wire_->write(packet, 8 + cmdlen);
+  wire_->endTransmission();
+}
@@ -0,0 +1,116 @@
+// HostSim.cpp – simulator core (clock, heap accounting, screen text model)
+#include "HostSim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+
+// ---------------- virtual clock ----------------
+static uint64_t g_nowUs = 0;
+static SimWorld* g_world = nullptr;
+static bool g_inTick = false;
+
+uint64_t Sim_nowUs() { return g_nowUs; }
+
+void Sim_advanceUs(uint64_t us) {
+  g_nowUs += us;
+  if(g_world && !g_inTick) {
+    g_inTick = true;
+    SimUntracked u;
+    g_world->tick(g_nowUs);
+    g_inTick = false;
+  }
+}
+
+void      Sim_setWorld(SimWorld* w) { g_world = w; }
+SimWorld* Sim_world() { return g_world; }
+
+// ---------------- heap accounting ----------------
+static bool g_track = false;
+static SimHeapStats g_heap = {0, 0, 0, 0};
+
+// size header keeps delete() honest without relying on malloc_usable_size
+static const size_t HDR = 16;
+
+static void* countedAlloc(size_t n) {
+  unsigned char* p = (unsigned char*)malloc(n + HDR);
+  if(!p) throw std::bad_alloc();
+  *(size_t*)p = n;
+  p[sizeof(size_t)] = g_track ? 1 : 0;
+  if(g_track) {
+    g_heap.allocs++;
+    g_heap.bytesLive += n;
+    if(g_heap.bytesLive > g_heap.bytesPeak) g_heap.bytesPeak = g_heap.bytesLive;
+  }
+  return p + HDR;
+}
+
+static void countedFree(void* q) {
+  if(!q) return;
+  unsigned char* p = (unsigned char*)q - HDR;
+  if(p[sizeof(size_t)]) {
+    g_heap.frees++;
+    g_heap.bytesLive -= *(size_t*)p;
+  }
+  free(p);
+}
+
+void* operator new(size_t n)   { return countedAlloc(n); }
+void* operator new[](size_t n) { return countedAlloc(n); }
+void  operator delete(void* p) noexcept   { countedFree(p); }
+void  operator delete[](void* p) noexcept { countedFree(p); }
+void  operator delete(void* p, size_t) noexcept   { countedFree(p); }
+void  operator delete[](void* p, size_t) noexcept { countedFree(p); }
+
+void Sim_heapStats(SimHeapStats& out) { out = g_heap; }
+void Sim_heapTrack(bool on) { g_track = on; }
+void Sim_heapResetPeak() { g_heap.bytesPeak = g_heap.bytesLive; }
+
+SimUntracked::SimUntracked() : prev(g_track) { g_track = false; }
+SimUntracked::~SimUntracked() { g_track = prev; }
+
+// ---------------- screen text model ----------------
+static SimLabel g_labels[SIM_LABEL_MAX];
+static int g_labelCount = 0;
+static uint32_t g_screenVersion = 0;
+
+static void removeLabel(int i) {
+  g_labels[i] = g_labels[--g_labelCount];
+  g_screenVersion++;
+}
+
+void Sim_areaPainted(int x, int y, int w, int h) {
+  for(int i=0;i<g_labelCount;){
+    const SimLabel& l = g_labels[i];
+    int cx = l.x + l.w/2, cy = l.y + l.h/2;
+    if(cx >= x && cx < x + w && cy >= y && cy < y + h) removeLabel(i);
+    else i++;
+  }
+}
+
+void Sim_labelDrawn(const char* text, int x, int y, int w, int h) {
+  if(!text || !*text) return;
+  Sim_areaPainted(x, y, w, h);
+  if(g_labelCount >= SIM_LABEL_MAX) removeLabel(0);
+
+  SimLabel& l = g_labels[g_labelCount++];
+  strncpy(l.text, text, SIM_LABEL_LEN - 1);
+  l.text[SIM_LABEL_LEN - 1] = 0;
+  l.x = (int16_t)x; l.y = (int16_t)y; l.w = (int16_t)w; l.h = (int16_t)h;
+  g_screenVersion++;
+}
+
+bool Sim_findLabel(const char* text, int& cx, int& cy) {
+  for(int i=g_labelCount-1;i>=0;i--){
+    if(strcmp(g_labels[i].text, text) == 0) {
+      cx = g_labels[i].x + g_labels[i].w/2;
+      cy = g_labels[i].y + g_labels[i].h/2;
+      return true;
+    }
+  }
+  return false;
+}
+
+int Sim_labelCount() { return g_labelCount; }
+const SimLabel& Sim_label(int i) { return g_labels[i]; }
+uint32_t Sim_screenVersion() { return g_screenVersion; }
@@ -0,0 +1,71 @@
+// HostSim.h – simulator core shared by the host stand-ins
+// Virtual clock, heap accounting and the hook into the world model
+// (the thing that "is" the patient, the pegs and the finger).
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// ---------------- virtual clock ----------------
+uint64_t Sim_nowUs();
+void     Sim_advanceUs(uint64_t us);
+
+// ---------------- heap accounting ----------------
+// Every operator new/delete is counted while tracking is on. The harness
+// turns it on around setup()/loop() so only the sketch's own heap use shows.
+struct SimHeapStats {
+  uint64_t allocs;
+  uint64_t frees;
+  uint64_t bytesLive;
+  uint64_t bytesPeak;
+};
+void Sim_heapStats(SimHeapStats& out);
+void Sim_heapTrack(bool on);
+void Sim_heapResetPeak();
+
+// Pause tracking while harness code runs from inside a sketch call.
+struct SimUntracked {
+  SimUntracked();
+  ~SimUntracked();
+  bool prev;
+};
+
+// ---------------- screen text model ----------------
+// Text drawn by the sketch stays "visible" until something paints over its
+// centre. Coordinates are in drawing space (what the user sees).
+static const int SIM_LABEL_MAX = 64;
+static const int SIM_LABEL_LEN = 40;
+
+struct SimLabel {
+  char    text[SIM_LABEL_LEN];
+  int16_t x, y, w, h;       // bounding box
+};
+
+void Sim_labelDrawn(const char* text, int x, int y, int w, int h);
+void Sim_areaPainted(int x, int y, int w, int h);
+bool Sim_findLabel(const char* text, int& cx, int& cy);
+int  Sim_labelCount();
+const SimLabel& Sim_label(int i);
+uint32_t Sim_screenVersion();      // bumps whenever the visible text set changes
+
+// ---------------- world model ----------------
+class SimWorld {
+public:
+  virtual ~SimWorld() {}
+  virtual void tick(uint64_t nowUs) { (void)nowUs; }
+  virtual void onLedShow(const uint32_t* px, int n) { (void)px; (void)n; }
+  // true while a finger is down; raw XPT2046 coordinates
+  virtual bool touch(int& rawX, int& rawY, int& z) { (void)rawX; (void)rawY; (void)z; return false; }
+  // true while a tag sits on the antenna
+  virtual bool tag(uint8_t uid[7], uint8_t& len) { (void)uid; (void)len; return false; }
+  // every tag on the antenna (up to max); worlds with one hand keep tag()
+  virtual int tags(uint8_t uid[][7], uint8_t* len, int max) {
+    return max > 0 && tag(uid[0], len[0]) ? 1 : 0;
+  }
+};
+
+void      Sim_setWorld(SimWorld* w);
+SimWorld* Sim_world();
+
+// ---------------- misc ----------------
+void Sim_serialEcho(bool on);
+void Sim_serialInput(const char* text);   // queued for Serial.read()
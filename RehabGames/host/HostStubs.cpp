@@ -0,0 +1,171 @@
+// HostStubs.cpp – implementations behind the host stand-in headers
+#include <Arduino.h>
+#include <SPI.h>
+#include <Wire.h>
+#include <TFT_eSPI.h>
+#include <XPT2046_Touchscreen.h>
+#include <Adafruit_NeoPixel.h>
+#include <WiFi.h>
+#include <Firebase_ESP_Client.h>
+#include <stdio.h>
+#include "HostSim.h"
+#include "TftEmu.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+SPIClass SPI;
+WiFiClass WiFi;
+FirebaseESP Firebase;
+
+// ---------------- time / gpio ----------------
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int  digitalRead(uint8_t) { return HIGH; }
+
+unsigned long millis() { return (unsigned long)(Sim_nowUs() / 1000); }
+unsigned long micros() { return (unsigned long)Sim_nowUs(); }
+void delay(uint32_t ms) { TftEmu_endFrame(); Sim_advanceUs((uint64_t)ms * 1000); }
+void delayMicroseconds(uint32_t us) { Sim_advanceUs(us); }
+void yield() {}
+
+// ---------------- random ----------------
+static uint32_t g_rand = 1;
+
+long random(long howbig) {
+  if(howbig <= 0) return 0;
+  g_rand = g_rand * 1664525u + 1013904223u;
+  return (long)((g_rand >> 8) % (uint32_t)howbig);
+}
+long random(long howsmall, long howbig) {
+  if(howsmall >= howbig) return howsmall;
+  return howsmall + random(howbig - howsmall);
+}
+void randomSeed(unsigned long seed) { if(seed) g_rand = (uint32_t)seed; }
+
+// ---------------- String ----------------
+String::String(const char* s) { append(s, (unsigned int)strlen(s)); }
+String::String(const String& o) { append(o.c_str(), o.len_); }
+String::String(char c) { append(&c, 1); }
+String::String(int v)           { char b[16]; snprintf(b, sizeof(b), "%d", v);  append(b, (unsigned int)strlen(b)); }
+String::String(unsigned int v)  { char b[16]; snprintf(b, sizeof(b), "%u", v);  append(b, (unsigned int)strlen(b)); }
+String::String(long v)          { char b[24]; snprintf(b, sizeof(b), "%ld", v); append(b, (unsigned int)strlen(b)); }
+String::String(unsigned long v) { char b[24]; snprintf(b, sizeof(b), "%lu", v); append(b, (unsigned int)strlen(b)); }
+String::~String() { delete[] buf_; }
+
+String& String::operator=(const String& o) {
+  if(this == &o) return *this;
+  len_ = 0;
+  if(buf_) buf_[0] = 0;
+  append(o.c_str(), o.len_);
+  return *this;
+}
+String& String::operator+=(const String& o)   { append(o.c_str(), o.len_); return *this; }
+String& String::operator+=(const char* s)     { append(s, (unsigned int)strlen(s)); return *this; }
+String& String::operator+=(int v)             { return *this += String(v); }
+String& String::operator+=(long v)            { return *this += String(v); }
+String& String::operator+=(unsigned int v)    { return *this += String(v); }
+String& String::operator+=(unsigned long v)   { return *this += String(v); }
+
+// grows exactly like WString: realloc to the new length, no slack
+void String::append(const char* s, unsigned int n) {
+  if(len_ + n + 1 > cap_) {
+    unsigned int ncap = len_ + n + 1;
+    char* nb = new char[ncap];
+    if(buf_) memcpy(nb, buf_, len_);
+    delete[] buf_;
+    buf_ = nb;
+    cap_ = ncap;
+  }
+  memcpy(buf_ + len_, s, n);
+  len_ += n;
+  buf_[len_] = 0;
+}
+
+String operator+(const String& a, const String& b)   { String r(a); r += b; return r; }
+String operator+(const String& a, const char* b)     { String r(a); r += b; return r; }
+String operator+(const String& a, int b)             { String r(a); r += b; return r; }
+String operator+(const String& a, long b)            { String r(a); r += b; return r; }
+String operator+(const String& a, unsigned int b)    { String r(a); r += b; return r; }
+String operator+(const String& a, unsigned long b)   { String r(a); r += b; return r; }
+
+// ---------------- Print / Serial ----------------
+static bool g_serialEcho = false;
+void Sim_serialEcho(bool on) { g_serialEcho = on; }
+
+size_t Print::print(int v)           { char b[16]; int n = snprintf(b, sizeof(b), "%d", v);  return write(b, (size_t)n); }
+size_t Print::print(unsigned long v) { char b[24]; int n = snprintf(b, sizeof(b), "%lu", v); return write(b, (size_t)n); }
+
+size_t Print::printf(const char* fmt, ...) {
+  char b[128];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(b, sizeof(b), fmt, ap);
+  va_end(ap);
+  if(n < 0) return 0;
+  if(n >= (int)sizeof(b)) n = sizeof(b) - 1;
+  return write(b, (size_t)n);
+}
+
+static char     g_serialIn[64];
+static uint8_t  g_serialInHead = 0, g_serialInLen = 0;
+
+void Sim_serialInput(const char* text) {
+  for(; *text && g_serialInLen < sizeof(g_serialIn); text++, g_serialInLen++)
+    g_serialIn[(g_serialInHead + g_serialInLen) % sizeof(g_serialIn)] = *text;
+}
+
+int HardwareSerial::available() { return g_serialInLen; }
+int HardwareSerial::read() {
+  if(!g_serialInLen) return -1;
+  char c = g_serialIn[g_serialInHead];
+  g_serialInHead = (uint8_t)((g_serialInHead + 1) % sizeof(g_serialIn));
+  g_serialInLen--;
+  return (uint8_t)c;
+}
+size_t HardwareSerial::write(const char* s, size_t n) {
+  if(g_serialEcho) fwrite(s, 1, n, stdout);
+  return n;
+}
+
+// ---------------- ESP heap ----------------
+// Free heap after WiFi + Firebase on a plain ESP32, minus what the sketch
+// holds. No fragmentation model: the largest block is all of it.
+static const uint32_t SIM_HEAP_FREE = 160 * 1024;
+
+static uint32_t simFree(uint64_t used) { return used >= SIM_HEAP_FREE ? 0 : SIM_HEAP_FREE - (uint32_t)used; }
+
+uint32_t EspClass::getHeapSize() { return 320 * 1024; }
+uint32_t EspClass::getFreeHeap() { SimHeapStats s; Sim_heapStats(s); return simFree(s.bytesLive); }
+uint32_t EspClass::getMinFreeHeap() { SimHeapStats s; Sim_heapStats(s); return simFree(s.bytesPeak); }
+uint32_t EspClass::getMaxAllocHeap() { return getFreeHeap(); }
+
+// ---------------- touch ----------------
+TS_Point XPT2046_Touchscreen::getPoint() {
+  Sim_advanceUs(60);                    // 3 conversions @ 2 MHz SPI
+  int x, y, z;
+  SimWorld* w = Sim_world();
+  if(w) {
+    SimUntracked u;
+    if(w->touch(x, y, z)) return TS_Point((int16_t)x, (int16_t)y, (int16_t)z);
+  }
+  return TS_Point(0, 0, 0);
+}
+
+bool XPT2046_Touchscreen::touched() { return getPoint().z > 0; }
+
+// ---------------- NeoPixel ----------------
+Adafruit_NeoPixel::Adafruit_NeoPixel(uint16_t n, int16_t pin, uint16_t)
+  : n_(n), pin_(pin), px_(new uint32_t[n]()) {}
+Adafruit_NeoPixel::~Adafruit_NeoPixel() { delete[] px_; }
+
+void Adafruit_NeoPixel::clear() { memset(px_, 0, n_ * sizeof(uint32_t)); }
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint32_t c) { if(n < n_) px_[n] = c & 0xFFFFFF; }
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b) { setPixelColor(n, Color(r, g, b)); }
+uint32_t Adafruit_NeoPixel::getPixelColor(uint16_t n) const { return n < n_ ? px_[n] : 0; }
+
+void Adafruit_NeoPixel::show() {
+  Sim_advanceUs(50 + (uint64_t)n_ * 30);   // 24 bits @ 800 kHz + latch
+  SimWorld* w = Sim_world();
+  if(w) { SimUntracked u; w->onLedShow(px_, n_); }
+}
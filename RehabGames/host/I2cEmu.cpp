@@ -0,0 +1,128 @@
+// I2cEmu.cpp – emulated I2C bus + TwoWire stand-in
+#include <Wire.h>
+#include <string.h>
+#include "I2cEmu.h"
+#include "HostSim.h"
+
+TwoWire Wire;
+
+static I2cDevice*  g_dev[128];
+static I2cRouter*  g_router = nullptr;
+static I2cBusStats g_stats;
+static uint32_t    g_clockHz = 100000;
+
+void I2cEmu_attach(uint8_t addr, I2cDevice* dev) { g_dev[addr & 0x7F] = dev; }
+void I2cEmu_detach(uint8_t addr) { g_dev[addr & 0x7F] = nullptr; }
+void I2cEmu_setRouter(I2cRouter* r) { g_router = r; }
+
+I2cDevice* I2cEmu_device(uint8_t addr) {
+  if(g_dev[addr & 0x7F]) return g_dev[addr & 0x7F];
+  return g_router ? g_router->route(addr & 0x7F) : nullptr;
+}
+
+uint32_t I2cEmu_clockHz() { return g_clockHz; }
+const I2cBusStats& I2cEmu_stats() { return g_stats; }
+void I2cEmu_resetStats() { memset(&g_stats, 0, sizeof(g_stats)); }
+
+static bool busHung() {
+  for(int a=0;a<128;a++) if(g_dev[a] && g_dev[a]->holdsSda()) return true;
+  return false;
+}
+
+static void charge(uint64_t ns) {
+  g_stats.busNs += ns;
+  Sim_advanceUs((ns + 999) / 1000);
+}
+
+// START + address + n bytes (9 clocks each) + STOP
+int I2cEmu_transfer(uint8_t addr, bool read, uint8_t* buf, size_t n, uint32_t clockHz, uint16_t timeoutMs) {
+  g_stats.txns++;
+  g_clockHz = clockHz ? clockHz : 100000;
+  uint64_t bitNs = 1000000000ull / g_clockHz;
+
+  if(busHung()) {
+    g_stats.timeouts++;
+    charge((uint64_t)timeoutMs * 1000000ull);
+    return I2C_TIMEOUT;
+  }
+
+  I2cDevice* d = I2cEmu_device(addr);
+  if(!d || !d->ackAddress(read)) {
+    g_stats.nacks++;
+    charge(bitNs * 11);
+    return I2C_NACK_ADDR;
+  }
+
+  uint32_t stretch = d->stretchUs();
+  if(stretch >= (uint32_t)timeoutMs * 1000) {
+    g_stats.timeouts++;
+    charge((uint64_t)timeoutMs * 1000000ull);
+    return I2C_TIMEOUT;
+  }
+
+  charge(bitNs * (11 + 9 * n) + (uint64_t)stretch * 1000);
+  g_stats.bytes += n;
+
+  if(read) {
+    size_t got = d->read(buf, n);
+    for(size_t i=got;i<n;i++) buf[i] = 0xFF;   // released SDA reads as ones
+    return I2C_OK;
+  }
+  if(!d->write(buf, n)) { g_stats.nacks++; return I2C_NACK_DATA; }
+  return I2C_OK;
+}
+
+void I2cEmu_busClear() {
+  g_stats.busClears++;
+  for(int a=0;a<128;a++) if(g_dev[a]) g_dev[a]->busClear();
+}
+
+// ---------------- TwoWire ----------------
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+  (void)sda; (void)scl;
+  if(frequency) clock_ = frequency;
+  if(!running_) {
+    I2cEmu_busClear();
+    Sim_advanceUs(100);
+  }
+  running_ = true;
+  return true;
+}
+
+bool TwoWire::end() {
+  running_ = false;
+  return true;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  txAddr_ = address;
+  txLen_ = 0;
+}
+
+size_t TwoWire::write(uint8_t b) {
+  if(txLen_ >= sizeof(txBuf_)) return 0;
+  txBuf_[txLen_++] = b;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t n) {
+  size_t w = 0;
+  while(w < n && write(data[w])) w++;
+  return w;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  (void)sendStop;
+  if(!running_) return 4;
+  return (uint8_t)I2cEmu_transfer(txAddr_, false, txBuf_, txLen_, clock_, timeoutMs_);
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t n, bool sendStop) {
+  (void)sendStop;
+  rxLen_ = rxPos_ = 0;
+  if(!running_) return 0;
+  if(n > sizeof(rxBuf_)) n = sizeof(rxBuf_);
+  if(I2cEmu_transfer(address, true, rxBuf_, n, clock_, timeoutMs_) != I2C_OK) return 0;
+  rxLen_ = n;
+  return n;
+}
@@ -0,0 +1,48 @@
+// I2cEmu.h – emulated I2C bus behind the TwoWire stand-in
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// A device on the bus. Called once per transaction, after the address byte.
+class I2cDevice {
+public:
+  virtual ~I2cDevice() {}
+  virtual bool   ackAddress(bool read) { (void)read; return true; }  // false = address NAK
+  virtual bool   write(const uint8_t* p, size_t n) = 0;               // false = data NAK
+  virtual size_t read(uint8_t* p, size_t n) = 0;
+  virtual uint32_t stretchUs() { return 0; }     // SCL held low during this transaction
+  virtual bool   holdsSda() { return false; }    // bus hung until a bus clear
+  virtual void   busClear() {}                   // 9 SCL pulses from Wire.begin()
+};
+
+// Result codes match the ESP32 Arduino core (endTransmission).
+enum I2cResult { I2C_OK = 0, I2C_NACK_ADDR = 2, I2C_NACK_DATA = 3, I2C_TIMEOUT = 5 };
+
+struct I2cBusStats {
+  uint64_t txns;
+  uint64_t bytes;
+  uint64_t nacks;
+  uint64_t timeouts;
+  uint64_t busClears;
+  uint64_t busNs;
+};
+
+void I2cEmu_attach(uint8_t addr, I2cDevice* dev);
+void I2cEmu_detach(uint8_t addr);
+I2cDevice* I2cEmu_device(uint8_t addr);
+
+// Used by the mux emulator: lets a device claim other addresses.
+class I2cRouter {
+public:
+  virtual ~I2cRouter() {}
+  virtual I2cDevice* route(uint8_t addr) = 0;
+};
+void I2cEmu_setRouter(I2cRouter* r);
+
+uint32_t I2cEmu_clockHz();            // SCL of the transaction in flight
+const I2cBusStats& I2cEmu_stats();
+void I2cEmu_resetStats();
+
+// called by TwoWire
+int  I2cEmu_transfer(uint8_t addr, bool read, uint8_t* buf, size_t n, uint32_t clockHz, uint16_t timeoutMs);
+void I2cEmu_busClear();
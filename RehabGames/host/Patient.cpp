@@ -0,0 +1,306 @@
+// Patient.cpp – virtual patient behaviour
+#include "Patient.h"
+#include <math.h>
+#include <string.h>
+
+// Same UID map as the games (one physical peg per LED zone)
+struct PegUid { uint8_t led; uint8_t uid[4]; };
+static const PegUid PEGS[] = {
+  {0,{0x49,0x04,0x16,0xA4}}, {2,{0xC4,0x90,0x86,0xBB}},
+  {4,{0x39,0x94,0xBB,0xA2}}, {6,{0x46,0xC2,0x86,0xBB}},
+  {9,{0x79,0x78,0x21,0xA4}}, {11,{0x49,0xB3,0x25,0xA4}},
+  {13,{0x79,0x69,0xCC,0xA2}}, {15,{0xB9,0xB7,0x84,0xC1}},
+  {16,{0x89,0x74,0x85,0xC2}}, {18,{0x6B,0x8F,0xD5,0xAB}},
+  {20,{0x89,0x59,0x23,0xA4}}, {22,{0x29,0xCF,0x38,0x59}},
+  {25,{0xD9,0x60,0x22,0xA4}}, {27,{0x89,0xE9,0xC3,0xA2}},
+  {29,{0x19,0xF7,0x80,0xC1}}, {31,{0x09,0xC3,0xCA,0xA2}}
+};
+static const int NUM_PEGS = sizeof(PEGS) / sizeof(PEGS[0]);
+
+// Touch calibration lives in Shared.cpp; the patient inverts it.
+extern int  TOUCH_X_MIN, TOUCH_X_MAX, TOUCH_Y_MIN, TOUCH_Y_MAX;
+extern bool TOUCH_SWAP_XY, TOUCH_INVERT_X, TOUCH_INVERT_Y;
+
+static const int SIM_SCREEN_W = 320;
+static const int SIM_SCREEN_H = 240;
+
+static const PegUid* pegFor(uint8_t led) {
+  for(int i=0;i<NUM_PEGS;i++) if(PEGS[i].led == led) return &PEGS[i];
+  return nullptr;
+}
+
+static bool visible(const char* text) {
+  int x, y;
+  return Sim_findLabel(text, x, y);
+}
+
+Patient::Patient(const PatientConfig& cfg) : cfg_(cfg), rng_(cfg.seed) {
+  memset(&st_, 0, sizeof(st_));
+}
+
+// ---------------- randomness ----------------
+uint32_t Patient::sampleLogNormalMs(float mean, float sd) {
+  float s2 = logf(1.0f + (sd*sd) / (mean*mean));
+  float mu = logf(mean) - s2/2;
+  std::lognormal_distribution<float> d(mu, sqrtf(s2));
+  float v = d(rng_);
+  if(v < 80) v = 80;            // nobody reacts faster than this
+  if(v > 20000) v = 20000;
+  return (uint32_t)v;
+}
+
+uint32_t Patient::uniformMs(uint32_t lo, uint32_t hi) {
+  std::uniform_int_distribution<uint32_t> d(lo, hi > lo ? hi : lo);
+  return d(rng_);
+}
+
+bool Patient::chance(float p) {
+  std::uniform_real_distribution<float> d(0, 1);
+  return d(rng_) < p;
+}
+
+// ---------------- perception ----------------
+Patient::Ctx Patient::classify() const {
+  if(visible("PLAY AGAIN"))         return CTX_DONE;
+  if(visible("RETRY"))              return CTX_RETRY;
+  if(visible("FOLLOW THE LIGHT"))   return CTX_MENU;
+  if(visible("WARM-UP") || visible("EASY")) return CTX_LEVEL;
+  if(visible("Watch the sequence")) return CTX_G2_WATCH;
+  if(visible("REPEAT"))             return CTX_G2_REPEAT;
+  if(visible("SCAN 2 TAGS"))        return CTX_G3_PLAY;
+  if(visible("Follow the Light")) {
+    if(visible("SCAN"))  return CTX_G1_SCAN;
+    if(visible("WATCH")) return CTX_G1_WATCH;
+    return CTX_G1_OTHER;
+  }
+  return CTX_UNKNOWN;
+}
+
+void Patient::onLedShow(const uint32_t* px, int n) {
+  lastN_ = n < LED_MAX ? n : LED_MAX;
+  memcpy(lastPx_, px, lastN_ * sizeof(uint32_t));
+  lastShowUs_ = nowUs_;
+  takeFrame(px, n);
+}
+
+// the strip gets gamma/brightness-corrected colours; white stays r = g = b
+static bool isWhite(uint32_t c) {
+  uint8_t r = c >> 16, g = c >> 8, b = c;
+  return r && r == g && g == b;
+}
+
+void Patient::takeFrame(const uint32_t* px, int n) {
+  int lit = 0, idx = -1;
+  for(int i=0;i<n;i++) if(px[i]) { lit++; idx = i; }
+
+  if(ctx_ == CTX_G1_WATCH && lit == 1 && isWhite(px[idx])) {
+    g1Target_ = idx;
+    return;
+  }
+
+  if(ctx_ == CTX_G2_WATCH && lit == 1 && g2Len_ < PLAN_MAX) {
+    g2Seq_[g2Len_++] = (uint8_t)idx;
+    return;
+  }
+
+  // first frame of a Color Match board: pair LEDs up by colour
+  if(ctx_ == CTX_G3_PLAY && !g3BoardTaken_ && lit >= 2) {
+    uint8_t order[PLAN_MAX];
+    int len = 0;
+    bool used[64] = {false};
+    for(int i=0;i<n && i<64;i++){
+      if(!px[i] || used[i]) continue;
+      for(int j=i+1;j<n && j<64;j++){
+        if(!used[j] && px[j] == px[i] && len + 2 <= PLAN_MAX) {
+          used[i] = used[j] = true;
+          order[len++] = (uint8_t)i;
+          order[len++] = (uint8_t)j;
+          break;
+        }
+      }
+    }
+    g3BoardTaken_ = true;
+    startPlan(order, len, nowUs_);
+  }
+}
+
+// ---------------- behaviour ----------------
+void Patient::tick(uint64_t nowUs) {
+  nowUs_ = nowUs;
+  Ctx c = classify();
+  if(c != ctx_) enterCtx(c, nowUs);
+  tickTouch(c, nowUs);
+  tickTags(c, nowUs);
+}
+
+void Patient::enterCtx(Ctx c, uint64_t now) {
+  ctx_ = c;
+  if(isTouchCtx(c)) {
+    planLen_ = planPos_ = 0;
+    g1Target_ = -1;
+    g2Len_ = 0;
+    g3BoardTaken_ = false;
+    tapAtUs_ = 0;
+  }
+  if(c == CTX_G2_WATCH) g2Len_ = 0;
+  // LEDs came up while the screen was still painting
+  if((c == CTX_G1_WATCH || c == CTX_G3_PLAY) && lastN_ && now - lastShowUs_ < 400000)
+    takeFrame(lastPx_, lastN_);
+  if(c == CTX_G2_REPEAT && g2Len_ > 0) {
+    startPlan(g2Seq_, g2Len_, now);
+    g2Len_ = 0;
+  }
+}
+
+void Patient::startPlan(const uint8_t* leds, int n, uint64_t now) {
+  if(n > PLAN_MAX) n = PLAN_MAX;
+  memcpy(plan_, leds, n);
+  planLen_ = n;
+  planPos_ = 0;
+  placeAtUs_ = now + (uint64_t)sampleLogNormalMs(cfg_.rtMeanMs, cfg_.rtSdMs) * 1000;
+}
+
+const char* Patient::pickButton(Ctx c) {
+  switch(c) {
+    case CTX_MENU: {
+      static const char* const GAMES[3] = { "FOLLOW THE LIGHT", "LIGHT SEQUENCE", "COLOR MATCH" };
+      return GAMES[nextGame_];
+    }
+    case CTX_LEVEL:
+      if(visible("WARM-UP")) return chance(0.5f) ? "WARM-UP" : "HOT MODE";
+      switch(uniformMs(0, 2)) { case 0: return "EASY"; case 1: return "MEDIUM"; default: return "HARD"; }
+    case CTX_DONE:  return chance(0.6f) ? "PLAY AGAIN" : "GAMES MENU";
+    case CTX_RETRY: return "RETRY";
+    default:        return nullptr;
+  }
+}
+
+void Patient::tickTouch(Ctx c, uint64_t now) {
+  if(tapDown_) {
+    if(now >= tapUntilUs_) {
+      tapDown_ = false;
+      tapCooldownUs_ = now + 500000;
+    }
+    return;
+  }
+  if(!isTouchCtx(c) || now < tapCooldownUs_) { tapAtUs_ = 0; return; }
+
+  // people read a screen once it has stopped changing
+  if(Sim_screenVersion() != screenVer_) {
+    screenVer_ = Sim_screenVersion();
+    screenSettledUs_ = now + 150000;
+  }
+
+  if(tapAtUs_ == 0) {
+    if(now < screenSettledUs_) return;
+    const char* label = pickButton(c);
+    int x, y;
+    if(!label || !Sim_findLabel(label, x, y)) return;
+
+    if(chance(cfg_.mistapRate)) {
+      // finger lands near the button edge – on the DONE screen that is the
+      // gap between PLAY AGAIN and GAMES MENU
+      int dx = (int)uniformMs(55, 80);
+      x += chance(0.5f) ? dx : -dx;
+      y += (int)uniformMs(0, 30) - 15;
+      st_.mistaps++;
+    } else if(c == CTX_MENU) {
+      st_.sessions[nextGame_]++;
+      nextGame_ = (nextGame_ + 1) % 3;
+    }
+    tapTargetX_ = x;
+    tapTargetY_ = y;
+    tapMirrored_ = (c != CTX_MENU);   // games hit-test in mirrored X, the menu does not
+    tapAtUs_ = now + (uint64_t)sampleLogNormalMs(cfg_.tapMeanMs, cfg_.tapMeanMs / 3) * 1000;
+    return;
+  }
+
+  if(now >= tapAtUs_) {
+    pressAt(tapTargetX_, tapTargetY_, tapMirrored_);
+    tapDown_ = true;
+    tapUntilUs_ = now + (uint64_t)cfg_.tapHoldMs * 1000;
+    tapAtUs_ = 0;
+    st_.taps++;
+    progressUs_ = now;
+  }
+}
+
+void Patient::pressAt(int x, int y, bool mirrored) {
+  if(x < 0) x = 0;
+  if(x > SIM_SCREEN_W - 1) x = SIM_SCREEN_W - 1;
+  if(y < 0) y = 0;
+  if(y > SIM_SCREEN_H - 1) y = SIM_SCREEN_H - 1;
+
+  int sx = mirrored ? (SIM_SCREEN_W - 1 - x) : x;
+
+  // invert rawToScreenInternal() (round up so the forward floor lands on sx)
+  int nx = TOUCH_INVERT_X ? (SIM_SCREEN_W - 1 - sx) : sx;
+  int ny = TOUCH_INVERT_Y ? (SIM_SCREEN_H - 1 - y) : y;
+  int rx = TOUCH_X_MIN + (nx * (TOUCH_X_MAX - TOUCH_X_MIN) + SIM_SCREEN_W - 2) / (SIM_SCREEN_W - 1);
+  int ry = TOUCH_Y_MIN + (ny * (TOUCH_Y_MAX - TOUCH_Y_MIN) + SIM_SCREEN_H - 2) / (SIM_SCREEN_H - 1);
+  if(TOUCH_SWAP_XY) { int t = rx; rx = ry; ry = t; }
+
+  tapRawX_ = rx;
+  tapRawY_ = ry;
+}
+
+bool Patient::touch(int& rawX, int& rawY, int& z) {
+  if(!tapDown_) return false;
+  rawX = tapRawX_;
+  rawY = tapRawY_;
+  z = 900 + (int)uniformMs(0, 600);
+  return true;
+}
+
+void Patient::tickTags(Ctx c, uint64_t now) {
+  if(holding_) {
+    if(now >= liftAtUs_) {
+      holding_ = false;
+      placeAtUs_ = now + (uint64_t)sampleLogNormalMs(cfg_.rtMeanMs, cfg_.rtSdMs) * 1000;
+    }
+    return;
+  }
+
+  if(c == CTX_G1_SCAN && g1Target_ >= 0 && planPos_ >= planLen_) {
+    uint8_t led = (uint8_t)g1Target_;
+    g1Target_ = -1;
+    startPlan(&led, 1, now);
+  }
+
+  if(planPos_ >= planLen_ || now < placeAtUs_) return;
+
+  // Color Match plans come in pairs; both hands can put a pair down at once
+  int n = 1;
+  if(c == CTX_G3_PLAY && (planPos_ & 1) == 0 && planPos_ + 1 < planLen_ && chance(cfg_.pairRate)) n = 2;
+
+  heldN_ = 0;
+  for(int i=0;i<n;i++){
+    const PegUid* p = pegFor(pickPeg(plan_[planPos_++]));
+    if(!p) continue;
+    memcpy(heldUid_[heldN_++], p->uid, 4);
+    st_.responses++;
+  }
+  if(!heldN_) return;
+  holding_ = true;
+  liftAtUs_ = now + (uint64_t)uniformMs(cfg_.liftMinMs, cfg_.liftMaxMs) * 1000;
+  progressUs_ = now;
+}
+
+// the planned peg, or now and then a wrong one
+uint8_t Patient::pickPeg(uint8_t led) {
+  if(!chance(cfg_.errorRate)) return led;
+  uint8_t other;
+  do { other = PEGS[uniformMs(0, NUM_PEGS - 1)].led; } while(other == led);
+  st_.wrongPegs++;
+  return other;
+}
+
+int Patient::tags(uint8_t uid[][7], uint8_t* len, int max) {
+  if(!holding_) return 0;
+  int n = 0;
+  for(int i=0;i<heldN_ && n<max;i++){
+    memcpy(uid[n], heldUid_[i], 4);
+    len[n++] = 4;
+  }
+  return n;
+}
@@ -0,0 +1,102 @@
+// Patient.h – randomized virtual patient for the host simulator
+// Reads the screen (visible labels) and the LED strip the way a person
+// would, then taps buttons and places pegs with configurable timing/errors.
+#pragma once
+#include <stdint.h>
+#include <random>
+#include "HostSim.h"
+
+struct PatientConfig {
+  uint32_t seed        = 1;
+  float    rtMeanMs    = 650;    // peg reaction time (log-normal)
+  float    rtSdMs      = 220;
+  float    tapMeanMs   = 700;    // touch reaction time (log-normal)
+  float    errorRate   = 0.08f;  // wrong peg
+  uint32_t liftMinMs   = 150;    // how long a peg rests on the antenna
+  uint32_t liftMaxMs   = 450;
+  float    mistapRate  = 0.10f;  // taps that land near button edges / gaps
+  float    pairRate    = 0.5f;   // Color Match: both pegs of a pair go down together
+  uint32_t tapHoldMs   = 120;
+};
+
+struct PatientStats {
+  uint64_t responses;    // pegs placed
+  uint64_t wrongPegs;
+  uint64_t taps;
+  uint64_t mistaps;
+  uint64_t sessions[3];  // game sessions started, per game
+};
+
+class Patient : public SimWorld {
+public:
+  explicit Patient(const PatientConfig& cfg);
+
+  void tick(uint64_t nowUs) override;
+  void onLedShow(const uint32_t* px, int n) override;
+  bool touch(int& rawX, int& rawY, int& z) override;
+  int  tags(uint8_t uid[][7], uint8_t* len, int max) override;
+
+  const PatientStats& stats() const { return st_; }
+  uint64_t lastProgressUs() const { return progressUs_; }
+
+private:
+  enum Ctx {
+    CTX_UNKNOWN, CTX_MENU, CTX_LEVEL, CTX_DONE, CTX_RETRY,
+    CTX_G1_WATCH, CTX_G1_SCAN, CTX_G1_OTHER,
+    CTX_G2_WATCH, CTX_G2_REPEAT, CTX_G3_PLAY
+  };
+  static const int PLAN_MAX = 32;
+
+  Ctx classify() const;
+  bool isTouchCtx(Ctx c) const { return c == CTX_MENU || c == CTX_LEVEL || c == CTX_DONE || c == CTX_RETRY; }
+  void enterCtx(Ctx c, uint64_t now);
+  void tickTouch(Ctx c, uint64_t now);
+  void tickTags(Ctx c, uint64_t now);
+  const char* pickButton(Ctx c);
+  void pressAt(int x, int y, bool mirrored);
+  void startPlan(const uint8_t* leds, int n, uint64_t now);
+
+  uint32_t sampleLogNormalMs(float mean, float sd);
+  uint32_t uniformMs(uint32_t lo, uint32_t hi);
+  bool     chance(float p);
+  uint8_t  pickPeg(uint8_t led);
+
+  PatientConfig cfg_;
+  PatientStats  st_;
+  std::mt19937  rng_;
+  uint64_t      nowUs_ = 0;
+  uint64_t      progressUs_ = 0;
+  Ctx           ctx_ = CTX_UNKNOWN;
+  int           nextGame_ = 0;
+
+  // touch
+  uint64_t tapAtUs_ = 0, tapUntilUs_ = 0, tapCooldownUs_ = 0;
+  int      tapRawX_ = 0, tapRawY_ = 0;
+  bool     tapDown_ = false;
+  int      tapTargetX_ = 0, tapTargetY_ = 0;
+  bool     tapMirrored_ = false;
+  uint32_t screenVer_ = 0;
+  uint64_t screenSettledUs_ = 0;
+
+  // pegs
+  uint8_t  plan_[PLAN_MAX];
+  int      planLen_ = 0, planPos_ = 0;
+  uint64_t placeAtUs_ = 0, liftAtUs_ = 0;
+  bool     holding_ = false;
+  uint8_t  heldUid_[2][4];
+  int      heldN_ = 0;
+
+  // what the patient remembers from the LEDs
+  int      g1Target_ = -1;
+  uint8_t  g2Seq_[PLAN_MAX];
+  int      g2Len_ = 0;
+  bool     g3BoardTaken_ = false;
+
+  // the LEDs and the screen are no longer painted in a fixed order: keep the
+  // last frame so a context entered just after it still sees it
+  static const int LED_MAX = 64;
+  uint32_t lastPx_[LED_MAX];
+  int      lastN_ = 0;
+  uint64_t lastShowUs_ = 0;
+  void     takeFrame(const uint32_t* px, int n);
+};
@@ -0,0 +1,244 @@
+// Pn532Emu.cpp – PN532 NFC controller on the emulated I2C bus
+#include <string.h>
+#include "Pn532Emu.h"
+#include "HostSim.h"
+
+// chip-side timings (virtual)
+static const uint32_t FW_US        = 1000;   // GetFirmwareVersion
+static const uint32_t SAM_US       = 1500;   // SAMConfiguration
+static const uint32_t ERR_US       = 500;    // error frame
+static const uint32_t ACTIVATE_US  = 4500;   // REQA .. SELECT for the first target
+static const uint32_t ANTICOLL_US  = 1500;   // each further target
+
+static const uint8_t ACK_FRAME[6] = {0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00};
+static const uint8_t ERR_FRAME[8] = {0x00, 0x00, 0xFF, 0x01, 0xFF, 0x7F, 0x81, 0x00};
+
+Pn532Emu::Pn532Emu(uint8_t addr, bool onBus) : addr_(addr) {
+  resetStats();
+  if(onBus) I2cEmu_attach(addr_, this);
+}
+
+static Pn532Emu g_main;
+Pn532Emu& Pn532Emu_main() { return g_main; }
+
+void Pn532Emu::resetStats() { memset(&stats_, 0, sizeof(stats_)); }
+
+void Pn532Emu::scriptTag(uint64_t atUs, uint32_t holdUs, const uint8_t* uid, uint8_t len) {
+  if(nScript_ >= (int)(sizeof(script_)/sizeof(script_[0]))) {
+    // drop the oldest finished entry
+    memmove(script_, script_+1, sizeof(script_[0]) * (nScript_-1));
+    nScript_--;
+  }
+  Script& s = script_[nScript_++];
+  s.atUs = atUs;
+  s.holdUs = holdUs;
+  s.tag.len = len > 7 ? 7 : len;
+  memcpy(s.tag.uid, uid, s.tag.len);
+}
+
+void Pn532Emu::brownout() {
+  busy_ = IDLE;
+  samOk_ = false;
+  wedged_ = false;
+  stats_.faults++;
+}
+
+void Pn532Emu::reset() {
+  busy_ = IDLE;
+  samOk_ = false;
+  nakLeft_ = 0;
+  sdaLow_ = false;
+  wedged_ = false;
+  stretchUs_ = 0;
+  maxHz_ = 0;
+  errRate_ = 0;
+}
+
+void Pn532Emu::busClear() { sdaLow_ = false; }
+
+bool Pn532Emu::corrupt() {
+  if(!maxHz_ || I2cEmu_clockHz() <= maxHz_) return false;
+  rng_ = rng_ * 1664525u + 1013904223u;
+  if((rng_ >> 8) * (1.0f / 16777216.0f) >= errRate_) return false;
+  stats_.faults++;
+  return true;
+}
+
+// tags on the antenna; *sinceUs = when the newest of them arrived (0 = unknown)
+int Pn532Emu::field(Tag* out, int max, uint64_t* sinceUs) {
+  int n = 0;
+  *sinceUs = 0;
+  uint64_t now = Sim_nowUs();
+  for(int i=0;i<nScript_ && n<max;i++) {
+    const Script& s = script_[i];
+    if(now >= s.atUs && now < s.atUs + s.holdUs) {
+      out[n++] = s.tag;
+      if(s.atUs > *sinceUs) *sinceUs = s.atUs;
+    }
+  }
+  SimWorld* w = Sim_world();
+  if(useWorld_ && w && n < max) {
+    SimUntracked u;
+    uint8_t uid[FIELD_MAX][7], len[FIELD_MAX];
+    int k = w->tags(uid, len, max - n);
+    for(int i=0;i<k;i++) {
+      memcpy(out[n].uid, uid[i], 7);
+      out[n++].len = len[i];
+    }
+    if(k) *sinceUs = now;
+  }
+  return n;
+}
+
+// ---------------- frames ----------------
+void Pn532Emu::respond(uint8_t cmd, const uint8_t* data, uint8_t n, uint64_t readyAtUs) {
+  uint8_t len = n + 2;
+  uint8_t* f = resp_;
+  uint8_t sum = 0xD5 + cmd + 1;
+  f[0] = 0x00; f[1] = 0x00; f[2] = 0xFF;
+  f[3] = len;  f[4] = (uint8_t)(~len + 1);
+  f[5] = 0xD5; f[6] = cmd + 1;
+  for(uint8_t i=0;i<n;i++) { f[7+i] = data[i]; sum += data[i]; }
+  f[7+n] = (uint8_t)(~sum + 1);
+  f[8+n] = 0x00;
+  respLen_ = 9 + n;
+  respAtUs_ = readyAtUs;
+  respListing_ = false;
+}
+
+void Pn532Emu::command(const uint8_t* d, uint8_t n) {
+  uint64_t now = Sim_nowUs();
+  if(busy_ == WORKING || busy_ == LISTING || busy_ == ACK_READY) stats_.aborted++;
+
+  memcpy(out_, ACK_FRAME, sizeof(ACK_FRAME));
+  outLen_ = sizeof(ACK_FRAME);
+  readyAtUs_ = now;
+  busy_ = ACK_READY;
+
+  switch(d[0]) {
+    case 0x02: {  // GetFirmwareVersion: PN532 v1.6
+      static const uint8_t fw[4] = {0x32, 0x01, 0x06, 0x07};
+      respond(d[0], fw, 4, now + FW_US);
+      break;
+    }
+    case 0x14:    // SAMConfiguration
+      samOk_ = true;
+      wedged_ = false;
+      respond(d[0], nullptr, 0, now + SAM_US);
+      break;
+    case 0x4A:    // InListPassiveTarget
+      stats_.lists++;
+      if(!samOk_ || n < 3 || d[2] != 0x00) {
+        memcpy(resp_, ERR_FRAME, sizeof(ERR_FRAME));
+        respLen_ = sizeof(ERR_FRAME);
+        respAtUs_ = now + ERR_US;
+        respListing_ = false;
+        break;
+      }
+      maxTg_ = d[1] < 1 ? 1 : (d[1] > 2 ? 2 : d[1]);
+      seenUs_ = 0;
+      listUs_ = now;
+      respListing_ = true;
+      break;
+    default:
+      memcpy(resp_, ERR_FRAME, sizeof(ERR_FRAME));
+      respLen_ = sizeof(ERR_FRAME);
+      respAtUs_ = now + ERR_US;
+      respListing_ = false;
+      break;
+  }
+}
+
+// advance the listing state machine to "now"
+void Pn532Emu::update() {
+  if(busy_ != LISTING || wedged_) return;
+  uint64_t now = Sim_nowUs();
+  Tag t[FIELD_MAX];
+  uint64_t since;
+  int n = field(t, maxTg_, &since);
+  if(n == 0) { seenUs_ = 0; return; }
+  // the chip polls the RF field on its own; scripted tags know when they landed
+  if(!seenUs_) seenUs_ = since > listUs_ ? since : listUs_;
+  uint64_t readyAt = seenUs_ + ACTIVATE_US + (uint64_t)(n-1) * ANTICOLL_US;
+  if(now < readyAt) return;
+
+  // D5 4B NbTg { Tg SENS_RES(2) SEL_RES NFCIDLength NFCID1 }
+  uint8_t data[2 + 2*12];
+  uint8_t k = 0;
+  data[k++] = (uint8_t)n;
+  for(int i=0;i<n;i++) {
+    data[k++] = (uint8_t)(i+1);
+    data[k++] = 0x00; data[k++] = 0x04;   // MIFARE Classic 1K
+    data[k++] = 0x08;
+    data[k++] = t[i].len;
+    for(uint8_t j=0;j<t[i].len;j++) data[k++] = t[i].uid[j];
+  }
+  respond(0x4A, data, k, readyAt);
+  memcpy(out_, resp_, respLen_);
+  outLen_ = respLen_;
+  readyAtUs_ = readyAt;
+  busy_ = WORKING;
+  stats_.targets += n;
+}
+
+// ---------------- I2cDevice ----------------
+bool Pn532Emu::ackAddress(bool read) {
+  (void)read;
+  if(nakLeft_ > 0) { nakLeft_--; stats_.faults++; return false; }
+  return true;
+}
+
+bool Pn532Emu::write(const uint8_t* p, size_t n) {
+  if(corrupt()) return false;
+
+  // 00 00 FF LEN LCS D4 CMD .. DCS 00 (the leading preamble is optional)
+  size_t i = 0;
+  while(i + 1 < n && !(p[i] == 0x00 && p[i+1] == 0xFF)) i++;
+  i += 2;
+  if(i + 3 > n) { stats_.badFrames++; return true; }
+  uint8_t len = p[i], lcs = p[i+1];
+  if((uint8_t)(len + lcs) != 0 || len < 2 || i + 2 + len + 1 > n || p[i+2] != 0xD4) {
+    stats_.badFrames++;
+    return true;
+  }
+  uint8_t sum = 0;
+  for(uint8_t k=0;k<len;k++) sum += p[i+2+k];
+  if((uint8_t)(sum + p[i+2+len]) != 0) { stats_.badFrames++; return true; }
+
+  stats_.frames++;
+  command(p + i + 3, len - 1);
+  return true;
+}
+
+size_t Pn532Emu::read(uint8_t* p, size_t n) {
+  if(n == 0) return 0;
+  update();
+  if(n == 1) stats_.statusPolls++;
+
+  bool ready = (busy_ == ACK_READY || busy_ == WORKING) && Sim_nowUs() >= readyAtUs_;
+  memset(p, 0, n);
+  p[0] = ready ? 0x01 : 0x00;
+  if(!ready || n == 1) {
+    if(corrupt()) p[0] ^= 0x01;
+    return n;
+  }
+
+  for(size_t i=1;i<n && i-1<outLen_;i++) p[i] = out_[i-1];
+  if(corrupt()) p[1 + rng_ % (n-1)] ^= 0x5A;
+
+  // frame consumed: the response (if any) queues up behind the ACK
+  if(busy_ == ACK_READY) {
+    if(respListing_) {
+      busy_ = LISTING;
+      update();
+    } else {
+      memcpy(out_, resp_, respLen_);
+      outLen_ = respLen_;
+      readyAtUs_ = respAtUs_;
+      busy_ = WORKING;
+    }
+  } else {
+    busy_ = IDLE;
+  }
+  return n;
+}
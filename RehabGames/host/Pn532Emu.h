@@ -0,0 +1,98 @@
+// Pn532Emu.h – PN532 NFC controller on the emulated I2C bus
+// Speaks the real host interface: information frames (preamble, LEN/LCS,
+// TFI, DCS), ACK frames and the leading status byte of every I2C read.
+// Tags come from scripted arrivals and/or the SimWorld (the patient).
+#pragma once
+#include <stdint.h>
+#include "I2cEmu.h"
+
+struct Pn532EmuStats {
+  uint32_t frames;        // well-formed host frames
+  uint32_t badFrames;     // checksum / framing errors (ignored by the chip)
+  uint32_t aborted;       // command dropped because a new one arrived
+  uint32_t lists;         // InListPassiveTarget commands
+  uint32_t targets;       // targets reported
+  uint32_t statusPolls;   // status-byte reads
+  uint32_t faults;        // injected faults that fired
+};
+
+class Pn532Emu : public I2cDevice {
+public:
+  static const uint8_t ADDR = 0x24;
+  static const int     FIELD_MAX = 4;
+
+  // onBus = false: not on the main bus (attach it behind a TcaMuxEmu)
+  explicit Pn532Emu(uint8_t addr = ADDR, bool onBus = true);
+
+  // ---- field ----
+  void useWorld(bool on) { useWorld_ = on; }
+  void scriptTag(uint64_t atUs, uint32_t holdUs, const uint8_t* uid, uint8_t len);
+  void clearScript() { nScript_ = 0; }
+
+  // ---- faults ----
+  void nakNext(int n) { nakLeft_ = n; }   // address NAK for the next n transactions
+  void hangBus() { sdaLow_ = true; }      // SDA stuck low until a bus clear (Wire.begin)
+  void wedge() { wedged_ = true; }        // RF side stalls; cleared by SAMConfiguration
+  void brownout();                        // chip resets, needs SAMConfiguration again
+  void setStretchUs(uint32_t us) { stretchUs_ = us; }
+  // above maxHz, each transaction is corrupted with probability errRate
+  void setMaxClock(uint32_t maxHz, float errRate) { maxHz_ = maxHz; errRate_ = errRate; }
+  void reset();                           // power-on state, faults cleared
+
+  const Pn532EmuStats& stats() const { return stats_; }
+  void resetStats();
+
+  // ---- I2cDevice ----
+  bool     ackAddress(bool read) override;
+  bool     write(const uint8_t* p, size_t n) override;
+  size_t   read(uint8_t* p, size_t n) override;
+  uint32_t stretchUs() override { return stretchUs_; }
+  bool     holdsSda() override { return sdaLow_; }
+  void     busClear() override;
+
+private:
+  struct Tag { uint8_t uid[7]; uint8_t len; };
+  struct Script { uint64_t atUs; uint32_t holdUs; Tag tag; };
+
+  enum Busy { IDLE, ACK_READY, WORKING, LISTING };
+
+  void command(const uint8_t* d, uint8_t n);
+  void respond(uint8_t cmd, const uint8_t* data, uint8_t n, uint64_t readyAtUs);
+  void update();
+  int  field(Tag* out, int max, uint64_t* sinceUs);
+  bool corrupt();
+
+  uint8_t  addr_;
+  bool     useWorld_ = true;
+  Script   script_[16];
+  int      nScript_ = 0;
+
+  // outgoing frame (ACK or response), readable once ready
+  Busy     busy_ = IDLE;
+  uint8_t  out_[64];
+  uint8_t  outLen_ = 0;
+  uint64_t readyAtUs_ = 0;
+  uint8_t  resp_[64];           // response queued behind the ACK
+  uint8_t  respLen_ = 0;
+  uint64_t respAtUs_ = 0;
+  bool     respListing_ = false;
+
+  // InListPassiveTarget in progress
+  uint8_t  maxTg_ = 1;
+  uint64_t listUs_ = 0;
+  uint64_t seenUs_ = 0;
+
+  bool     samOk_ = false;
+  int      nakLeft_ = 0;
+  bool     sdaLow_ = false;
+  bool     wedged_ = false;
+  uint32_t stretchUs_ = 0;
+  uint32_t maxHz_ = 0;
+  float    errRate_ = 0;
+  uint32_t rng_ = 0x2545F491;
+
+  Pn532EmuStats stats_;
+};
+
+// the reader the sketch talks to (0x24 on the default bus)
+Pn532Emu& Pn532Emu_main();
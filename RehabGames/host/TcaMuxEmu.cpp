@@ -0,0 +1,60 @@
+// TcaMuxEmu.cpp – TCA9548A-style I2C mux on the emulated bus
+#include <string.h>
+#include "TcaMuxEmu.h"
+
+TcaMuxEmu::TcaMuxEmu(uint8_t addr) : addr_(addr) {
+  resetStats();
+  I2cEmu_attach(addr_, this);
+  I2cEmu_setRouter(this);
+}
+
+TcaMuxEmu::~TcaMuxEmu() {
+  I2cEmu_detach(addr_);
+  I2cEmu_setRouter(nullptr);
+}
+
+void TcaMuxEmu::resetStats() { memset(&stats_, 0, sizeof(stats_)); }
+
+void TcaMuxEmu::attach(uint8_t channel, uint8_t addr, I2cDevice* dev) {
+  if(channel >= CHANNELS || nSlot_ >= (int)(sizeof(slot_)/sizeof(slot_[0]))) return;
+  slot_[nSlot_].channel = channel;
+  slot_[nSlot_].addr = addr & 0x7F;
+  slot_[nSlot_].dev = dev;
+  nSlot_++;
+}
+
+void TcaMuxEmu::detachAll() { nSlot_ = 0; mask_ = 0; }
+
+bool TcaMuxEmu::write(const uint8_t* p, size_t n) {
+  if(n == 0) return true;
+  stats_.selects++;
+  if(p[n-1] != mask_) stats_.switches++;
+  mask_ = p[n-1];
+  return true;
+}
+
+size_t TcaMuxEmu::read(uint8_t* p, size_t n) {
+  for(size_t i=0;i<n;i++) p[i] = mask_;
+  return n;
+}
+
+// a hung downstream bus hangs the upstream one while its channel is in
+bool TcaMuxEmu::holdsSda() {
+  for(int i=0;i<nSlot_;i++) {
+    if((mask_ & (1u << slot_[i].channel)) && slot_[i].dev->holdsSda()) return true;
+  }
+  return false;
+}
+
+void TcaMuxEmu::busClear() {
+  for(int i=0;i<nSlot_;i++) {
+    if(mask_ & (1u << slot_[i].channel)) slot_[i].dev->busClear();
+  }
+}
+
+I2cDevice* TcaMuxEmu::route(uint8_t addr) {
+  for(int i=0;i<nSlot_;i++) {
+    if((mask_ & (1u << slot_[i].channel)) && slot_[i].addr == addr) return slot_[i].dev;
+  }
+  return nullptr;
+}
@@ -0,0 +1,47 @@
+// TcaMuxEmu.h – TCA9548A-style 1-to-8 I2C mux on the emulated bus
+// Sits at 0x70. Writing one byte sets the channel mask, reading returns it.
+// Devices behind it are attached per channel and only answer while their
+// channel is switched in; two selected channels with the same address
+// answer as one (first wins), like the address collision on real hardware.
+#pragma once
+#include <stdint.h>
+#include "I2cEmu.h"
+
+struct TcaMuxEmuStats {
+  uint32_t selects;       // control register writes
+  uint32_t switches;      // writes that changed the mask
+};
+
+class TcaMuxEmu : public I2cDevice, public I2cRouter {
+public:
+  static const uint8_t ADDR = 0x70;
+  static const int     CHANNELS = 8;
+
+  explicit TcaMuxEmu(uint8_t addr = ADDR);
+  ~TcaMuxEmu();
+
+  void attach(uint8_t channel, uint8_t addr, I2cDevice* dev);
+  void detachAll();
+  uint8_t mask() const { return mask_; }
+
+  const TcaMuxEmuStats& stats() const { return stats_; }
+  void resetStats();
+
+  // ---- I2cDevice (the control register) ----
+  bool     write(const uint8_t* p, size_t n) override;
+  size_t   read(uint8_t* p, size_t n) override;
+  bool     holdsSda() override;
+  void     busClear() override;
+
+  // ---- I2cRouter ----
+  I2cDevice* route(uint8_t addr) override;
+
+private:
+  struct Slot { uint8_t channel; uint8_t addr; I2cDevice* dev; };
+
+  uint8_t addr_;
+  uint8_t mask_ = 0;
+  Slot    slot_[CHANNELS * 4];
+  int     nSlot_ = 0;
+  TcaMuxEmuStats stats_;
+};
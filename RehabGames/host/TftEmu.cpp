@@ -0,0 +1,755 @@
+// TftEmu.cpp – TFT_eSPI stand-in: RGB565 framebuffer + SPI cost accounting
+#include <TFT_eSPI.h>
+#include <stdio.h>
+#include <string.h>
+#include "TftEmu.h"
+#include "HostSim.h"
+
+static const int FB_W = 320;
+static const int FB_H = 240;
+
+static uint16_t g_fb[FB_W * FB_H];
+static int g_w = FB_W, g_h = FB_H;
+
+static TftBusModel g_bus = { 40000000, 1500, 250, 20000000 };
+static TftCost g_cost[PRIM_COUNT];
+
+// ---------------- cost accounting ----------------
+static int      g_depth = 0;
+static TftPrim  g_prim = PRIM_FILL_RECT;
+static uint64_t g_pendingNs = 0;        // bus time not yet charged to the clock
+
+static TftFrame g_frame;
+static bool     g_frameOpen = false;
+static char     g_frameText[TFT_FRAME_LABELS][SIM_LABEL_LEN];
+static TftFrameSink g_sink = nullptr;
+static void*    g_sinkUser = nullptr;
+
+static uint64_t byteNs(uint64_t bytes) {
+  return bytes * 8ull * 1000000000ull / g_bus.spiHz;
+}
+
+static void openFrame() {
+  if(g_frameOpen) return;
+  memset(&g_frame, 0, sizeof(g_frame));
+  g_frame.startUs = Sim_nowUs();
+  g_frameOpen = true;
+}
+
+// One top-level TFT_eSPI call = one SPI transaction.
+struct BusScope {
+  explicit BusScope(TftPrim p) : top(open(p)) {}
+  ~BusScope() { close(top); }
+
+  static bool open(TftPrim p) {
+    bool top = g_depth == 0;
+    if(top) {
+      openFrame();
+      g_prim = p;
+      g_cost[p].calls++;
+      g_frame.cost.calls++;
+      charge(g_bus.txnNs);
+    }
+    g_depth++;
+    return top;
+  }
+  static void close(bool top) {
+    g_depth--;
+    if(top && g_pendingNs >= 1000) {
+      uint64_t us = g_pendingNs / 1000;
+      g_pendingNs -= us * 1000;
+      Sim_advanceUs(us);
+    }
+  }
+  static void charge(uint64_t ns) {
+    g_cost[g_prim].busNs += ns;
+    g_frame.cost.busNs += ns;
+    g_pendingNs += ns;
+  }
+  bool top;
+};
+
+// address window + pixel stream for an already-clipped area
+static void window(int32_t w, int32_t h) {
+  uint64_t px = (uint64_t)w * h;
+  g_cost[g_prim].windows++;
+  g_cost[g_prim].pixels += px;
+  g_frame.cost.windows++;
+  g_frame.cost.pixels += px;
+  BusScope::charge(3ull * g_bus.cmdNs + byteNs(11) + byteNs(2 * px));
+}
+
+static bool clip(int32_t& x, int32_t& y, int32_t& w, int32_t& h) {
+  if(x < 0) { w += x; x = 0; }
+  if(y < 0) { h += y; y = 0; }
+  if(x + w > g_w) w = g_w - x;
+  if(y + h > g_h) h = g_h - y;
+  return w > 0 && h > 0;
+}
+
+static void fillArea(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t c) {
+  if(!clip(x, y, w, h)) return;
+  window(w, h);
+  for(int32_t j=0;j<h;j++){
+    uint16_t* row = &g_fb[(y + j) * FB_W + x];
+    for(int32_t i=0;i<w;i++) row[i] = c;
+  }
+}
+
+// ---------------- text recognition ----------------
+struct Ink {
+  char     text[SIM_LABEL_LEN];
+  int16_t  x, y, w, h;
+  uint32_t hash;
+  uint16_t probe[8];       // along the middle row: a cheap mismatch test before hashing
+  uint32_t used;           // drawn or recognized; the least recent goes first
+};
+static const int INK_MAX = 1024;
+static Ink g_ink[INK_MAX];
+static int g_inkCount = 0;
+static uint32_t g_inkClock = 0;
+
+static uint32_t areaHash(int32_t x, int32_t y, int32_t w, int32_t h) {
+  uint32_t hv = 2166136261u;
+  if(!clip(x, y, w, h)) return hv;
+  for(int32_t j=0;j<h;j++)
+    for(int32_t i=0;i<w;i++) hv = (hv ^ g_fb[(y + j) * FB_W + x + i]) * 16777619u;
+  return hv;
+}
+
+static void frameLabel(const char* s) {
+  if(!g_frameOpen || g_frame.labelCount >= TFT_FRAME_LABELS) return;
+  char* dst = g_frameText[g_frame.labelCount];
+  strncpy(dst, s, SIM_LABEL_LEN - 1);
+  dst[SIM_LABEL_LEN - 1] = 0;
+  g_frame.labels[g_frame.labelCount++] = dst;
+}
+
+static uint16_t probePixel(const Ink& k, int i) {
+  int32_t x = k.x + (2 * i + 1) * k.w / 16, y = k.y + k.h / 2;
+  return (x >= 0 && x < g_w && y >= 0 && y < g_h) ? g_fb[y * FB_W + x] : 0;
+}
+
+// after the glyphs are in the framebuffer; the newest entry per box wins
+static void inkDrawn(const char* s, int32_t x, int32_t y, int32_t w, int32_t h) {
+  int i = 0;
+  while(i < g_inkCount && !(g_ink[i].x == x && g_ink[i].y == y && g_ink[i].w == w &&
+                            g_ink[i].h == h && !strncmp(g_ink[i].text, s, SIM_LABEL_LEN - 1))) i++;
+  if(i == g_inkCount) {
+    if(g_inkCount < INK_MAX) g_inkCount++;
+    else {
+      i = 0;
+      for(int j=1;j<INK_MAX;j++) if(g_ink[j].used < g_ink[i].used) i = j;
+    }
+  }
+  Ink& k = g_ink[i];
+  strncpy(k.text, s, SIM_LABEL_LEN - 1);
+  k.text[SIM_LABEL_LEN - 1] = 0;
+  k.x = (int16_t)x; k.y = (int16_t)y; k.w = (int16_t)w; k.h = (int16_t)h;
+  k.hash = areaHash(x, y, w, h);
+  for(int p=0;p<8;p++) k.probe[p] = probePixel(k, p);
+  k.used = ++g_inkClock;
+}
+
+// pixels pushed into [x,y,w,h]: text whose pixels are back is visible again
+static bool recognize(int32_t x, int32_t y, int32_t w, int32_t h) {
+  bool any = false;
+  for(int i=0;i<g_inkCount;i++){
+    Ink& k = g_ink[i];
+    if(k.x >= x + w || k.x + k.w <= x || k.y >= y + h || k.y + k.h <= y) continue;
+    int p = 0;
+    while(p < 8 && probePixel(k, p) == k.probe[p]) p++;
+    if(p < 8 || areaHash(k.x, k.y, k.w, k.h) != k.hash) continue;
+    Sim_labelDrawn(k.text, k.x, k.y, k.w, k.h);
+    frameLabel(k.text);
+    k.used = ++g_inkClock;
+    any = true;
+  }
+  return any;
+}
+
+// Labels rendered off-screen (TFT_eSprite) and pushed later land wherever
+// the caller puts them, so they are matched by shape instead of position:
+// the ink mask of the sprite text against "differs from the top-left
+// pixel" in a pushed window of the same size (two colours at most).
+struct LabelImage {
+  char     text[SIM_LABEL_LEN];
+  int16_t  w, h;
+  uint32_t hashInk;        // top-left pixel is background
+  uint32_t hashInv;        // top-left pixel is ink
+  uint32_t used;
+};
+static const int IMAGE_MAX = 256;
+static LabelImage g_img[IMAGE_MAX];
+static int g_imgCount = 0;
+
+static void imageDrawn(const char* s, const uint16_t* px, int stride, int w, int h, uint16_t bg) {
+  uint32_t hi = 2166136261u, hv = 2166136261u;
+  for(int j=0;j<h;j++)
+    for(int i=0;i<w;i++) {
+      uint32_t ink = px[j * stride + i] != bg;
+      hi = (hi ^ ink) * 16777619u;
+      hv = (hv ^ (ink ^ 1u)) * 16777619u;
+    }
+  int k = 0;
+  while(k < g_imgCount && !(g_img[k].w == w && g_img[k].h == h && g_img[k].hashInk == hi)) k++;
+  if(k == g_imgCount) {
+    if(g_imgCount < IMAGE_MAX) g_imgCount++;
+    else {
+      k = 0;
+      for(int j=1;j<IMAGE_MAX;j++) if(g_img[j].used < g_img[k].used) k = j;
+    }
+  }
+  LabelImage& m = g_img[k];
+  strncpy(m.text, s, SIM_LABEL_LEN - 1);
+  m.text[SIM_LABEL_LEN - 1] = 0;
+  m.w = (int16_t)w; m.h = (int16_t)h;
+  m.hashInk = hi; m.hashInv = hv;
+  m.used = ++g_inkClock;
+}
+
+static void recognizeImage(int32_t x, int32_t y, int32_t w, int32_t h) {
+  int k = 0;
+  while(k < g_imgCount && !(g_img[k].w == w && g_img[k].h == h)) k++;
+  if(k == g_imgCount) return;
+
+  uint16_t c0 = g_fb[y * FB_W + x], c1 = c0;
+  uint32_t hv = 2166136261u;
+  for(int32_t j=0;j<h;j++)
+    for(int32_t i=0;i<w;i++) {
+      uint16_t c = g_fb[(y + j) * FB_W + x + i];
+      if(c != c0) {
+        if(c1 == c0) c1 = c;
+        else if(c != c1) return;          // a third colour: not a label
+      }
+      hv = (hv ^ (uint32_t)(c != c0)) * 16777619u;
+    }
+  for(;k<g_imgCount;k++){
+    LabelImage& m = g_img[k];
+    if(m.w != w || m.h != h || (m.hashInk != hv && m.hashInv != hv)) continue;
+    Sim_labelDrawn(m.text, x, y, w, h);
+    frameLabel(m.text);
+    inkDrawn(m.text, x, y, w, h);
+    m.used = ++g_inkClock;
+    return;
+  }
+}
+
+// ---------------- 5x7 glyphs, scaled into each font's cell ----------------
+static const uint8_t GLYPHS[95][5] = {
+  {0x00,0x00,0x00,0x00,0x00},{0x00,0x00,0x5F,0x00,0x00},{0x00,0x07,0x00,0x07,0x00},{0x14,0x7F,0x14,0x7F,0x14},
+  {0x24,0x2A,0x7F,0x2A,0x12},{0x23,0x13,0x08,0x64,0x62},{0x36,0x49,0x55,0x22,0x50},{0x00,0x05,0x03,0x00,0x00},
+  {0x00,0x1C,0x22,0x41,0x00},{0x00,0x41,0x22,0x1C,0x00},{0x08,0x2A,0x1C,0x2A,0x08},{0x08,0x08,0x3E,0x08,0x08},
+  {0x00,0x50,0x30,0x00,0x00},{0x08,0x08,0x08,0x08,0x08},{0x00,0x60,0x60,0x00,0x00},{0x20,0x10,0x08,0x04,0x02},
+  {0x3E,0x51,0x49,0x45,0x3E},{0x00,0x42,0x7F,0x40,0x00},{0x42,0x61,0x51,0x49,0x46},{0x21,0x41,0x45,0x4B,0x31},
+  {0x18,0x14,0x12,0x7F,0x10},{0x27,0x45,0x45,0x45,0x39},{0x3C,0x4A,0x49,0x49,0x30},{0x01,0x71,0x09,0x05,0x03},
+  {0x36,0x49,0x49,0x49,0x36},{0x06,0x49,0x49,0x29,0x1E},{0x00,0x36,0x36,0x00,0x00},{0x00,0x56,0x36,0x00,0x00},
+  {0x08,0x14,0x22,0x41,0x00},{0x14,0x14,0x14,0x14,0x14},{0x00,0x41,0x22,0x14,0x08},{0x02,0x01,0x51,0x09,0x06},
+  {0x32,0x49,0x79,0x41,0x3E},{0x7E,0x11,0x11,0x11,0x7E},{0x7F,0x49,0x49,0x49,0x36},{0x3E,0x41,0x41,0x41,0x22},
+  {0x7F,0x41,0x41,0x22,0x1C},{0x7F,0x49,0x49,0x49,0x41},{0x7F,0x09,0x09,0x09,0x01},{0x3E,0x41,0x49,0x49,0x7A},
+  {0x7F,0x08,0x08,0x08,0x7F},{0x00,0x41,0x7F,0x41,0x00},{0x20,0x40,0x41,0x3F,0x01},{0x7F,0x08,0x14,0x22,0x41},
+  {0x7F,0x40,0x40,0x40,0x40},{0x7F,0x02,0x0C,0x02,0x7F},{0x7F,0x04,0x08,0x10,0x7F},{0x3E,0x41,0x41,0x41,0x3E},
+  {0x7F,0x09,0x09,0x09,0x06},{0x3E,0x41,0x51,0x21,0x5E},{0x7F,0x09,0x19,0x29,0x46},{0x46,0x49,0x49,0x49,0x31},
+  {0x01,0x01,0x7F,0x01,0x01},{0x3F,0x40,0x40,0x40,0x3F},{0x1F,0x20,0x40,0x20,0x1F},{0x3F,0x40,0x38,0x40,0x3F},
+  {0x63,0x14,0x08,0x14,0x63},{0x07,0x08,0x70,0x08,0x07},{0x61,0x51,0x49,0x45,0x43},{0x00,0x7F,0x41,0x41,0x00},
+  {0x02,0x04,0x08,0x10,0x20},{0x00,0x41,0x41,0x7F,0x00},{0x04,0x02,0x01,0x02,0x04},{0x40,0x40,0x40,0x40,0x40},
+  {0x00,0x01,0x02,0x04,0x00},{0x20,0x54,0x54,0x54,0x78},{0x7F,0x48,0x44,0x44,0x38},{0x38,0x44,0x44,0x44,0x20},
+  {0x38,0x44,0x44,0x48,0x7F},{0x38,0x54,0x54,0x54,0x18},{0x08,0x7E,0x09,0x01,0x02},{0x0C,0x52,0x52,0x52,0x3E},
+  {0x7F,0x08,0x04,0x04,0x78},{0x00,0x44,0x7D,0x40,0x00},{0x20,0x40,0x44,0x3D,0x00},{0x7F,0x10,0x28,0x44,0x00},
+  {0x00,0x41,0x7F,0x40,0x00},{0x7C,0x04,0x18,0x04,0x78},{0x7C,0x08,0x04,0x04,0x78},{0x38,0x44,0x44,0x44,0x38},
+  {0x7C,0x14,0x14,0x14,0x08},{0x08,0x14,0x14,0x18,0x7C},{0x7C,0x08,0x04,0x04,0x08},{0x48,0x54,0x54,0x54,0x20},
+  {0x04,0x3F,0x44,0x40,0x20},{0x3C,0x40,0x40,0x20,0x7C},{0x1C,0x20,0x40,0x20,0x1C},{0x3C,0x40,0x30,0x40,0x3C},
+  {0x44,0x28,0x10,0x28,0x44},{0x0C,0x50,0x50,0x50,0x3C},{0x44,0x64,0x54,0x4C,0x44},{0x00,0x08,0x36,0x41,0x00},
+  {0x00,0x00,0x7F,0x00,0x00},{0x00,0x41,0x36,0x08,0x00},{0x08,0x04,0x08,0x10,0x08}
+};
+
+struct FontCell { uint8_t w, h; };
+
+// average advance / height of the TFT_eSPI built-in fonts
+static FontCell fontCell(uint8_t font) {
+  switch(font) {
+    case 2: return {8, 16};
+    case 4: return {14, 26};
+    case 6: return {27, 48};
+    case 7: return {32, 48};
+    case 8: return {55, 75};
+    default: return {6, 8};
+  }
+}
+
+// UTF-8 aware: multi-byte sequences count as one (unknown) glyph
+static int glyphCount(const char* s) {
+  int n = 0;
+  for(const unsigned char* p=(const unsigned char*)s; *p; p++) if((*p & 0xC0) != 0x80) n++;
+  return n;
+}
+
+static bool glyphInk(unsigned char ch, int gx, int gy) {
+  if(ch < 0x20 || ch > 0x7E || gx > 4 || gy > 6) return false;
+  return (GLYPHS[ch - 0x20][gx] >> gy) & 1;
+}
+
+// ---------------- TFT_eSPI ----------------
+void TFT_eSPI::init() {
+  BusScope s(PRIM_FILL_RECT);
+  BusScope::charge(120000000ull);       // reset + sleep-out delays in the init sequence
+}
+
+void TFT_eSPI::setRotation(uint8_t r) {
+  if((r & 1) && w_ < h_) { int16_t t = w_; w_ = h_; h_ = t; }
+  if(!(r & 1) && w_ > h_) { int16_t t = w_; w_ = h_; h_ = t; }
+  g_w = w_ < FB_W ? w_ : FB_W;
+  g_h = h_ < FB_H ? h_ : FB_H;
+}
+
+void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+  BusScope s(PRIM_FILL_RECT);
+  Sim_areaPainted(x, y, w, h);
+  fillArea(x, y, w, h, (uint16_t)color);
+}
+
+void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color) {
+  BusScope s(PRIM_PIXEL);
+  fillArea(x, y, 1, 1, (uint16_t)color);
+}
+
+void TFT_eSPI::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) {
+  BusScope s(PRIM_LINE);
+  fillArea(x, y, w, 1, (uint16_t)color);
+}
+
+void TFT_eSPI::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) {
+  BusScope s(PRIM_LINE);
+  fillArea(x, y, 1, h, (uint16_t)color);
+}
+
+// same decomposition as TFT_eSPI, so window counts match the library
+void TFT_eSPI::fillCircleHelper(int32_t x0, int32_t y0, int32_t r, uint8_t corners, int32_t delta, uint32_t color) {
+  if(r <= 0) return;
+  int32_t f = 1 - r, ddF_x = 1, ddF_y = -r - r, y = 0;
+  delta++;
+  while(y < r) {
+    if(f >= 0) {
+      if(corners & 0x1) drawFastHLine(x0 - y, y0 + r, y + y + delta, color);
+      if(corners & 0x2) drawFastHLine(x0 - y, y0 - r, y + y + delta, color);
+      r--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    y++;
+    ddF_x += 2;
+    f += ddF_x;
+    if(corners & 0x1) drawFastHLine(x0 - r, y0 + y, r + r + delta, color);
+    if(corners & 0x2) drawFastHLine(x0 - r, y0 - y, r + r + delta, color);
+  }
+}
+
+void TFT_eSPI::drawCircleHelper(int32_t x0, int32_t y0, int32_t r, uint8_t corners, uint32_t color) {
+  if(r <= 0) return;
+  int32_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0;
+  while(x < r) {
+    if(f >= 0) { r--; ddF_y += 2; f += ddF_y; }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    if(corners & 0x4) { drawPixel(x0 + x, y0 + r, color); drawPixel(x0 + r, y0 + x, color); }
+    if(corners & 0x2) { drawPixel(x0 + x, y0 - r, color); drawPixel(x0 + r, y0 - x, color); }
+    if(corners & 0x8) { drawPixel(x0 - r, y0 + x, color); drawPixel(x0 - x, y0 + r, color); }
+    if(corners & 0x1) { drawPixel(x0 - r, y0 - x, color); drawPixel(x0 - x, y0 - r, color); }
+  }
+}
+
+void TFT_eSPI::fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+  BusScope s(PRIM_FILL_ROUND_RECT);
+  Sim_areaPainted(x, y, w, h);
+  fillRect(x, y + r, w, h - r - r, color);
+  fillCircleHelper(x + r, y + h - r - 1, r, 1, w - r - r - 1, color);
+  fillCircleHelper(x + r, y + r, r, 2, w - r - r - 1, color);
+}
+
+void TFT_eSPI::drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+  BusScope s(PRIM_DRAW_ROUND_RECT);
+  drawFastHLine(x + r, y, w - r - r, color);
+  drawFastHLine(x + r, y + h - 1, w - r - r, color);
+  drawFastVLine(x, y + r, h - r - r, color);
+  drawFastVLine(x + w - 1, y + r, h - r - r, color);
+  drawCircleHelper(x + r, y + r, r, 1, color);
+  drawCircleHelper(x + w - r - 1, y + r, r, 2, color);
+  drawCircleHelper(x + w - r - 1, y + h - r - 1, r, 4, color);
+  drawCircleHelper(x + r, y + h - r - 1, r, 8, color);
+}
+
+void TFT_eSPI::fillCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color) {
+  BusScope s(PRIM_CIRCLE);
+  Sim_areaPainted(x0 - r, y0 - r, 2*r + 1, 2*r + 1);
+  int32_t x = 0, dx = 1, dy = r + r, p = -(r >> 1);
+  drawFastHLine(x0 - r, y0, dy + 1, color);
+  while(x < r) {
+    if(p >= 0) {
+      drawFastHLine(x0 - x, y0 + r, dx, color);
+      drawFastHLine(x0 - x, y0 - r, dx, color);
+      dy -= 2;
+      p -= dy;
+      r--;
+    }
+    dx += 2;
+    p += dx;
+    x++;
+    drawFastHLine(x0 - r, y0 + x, dy + 1, color);
+    drawFastHLine(x0 - r, y0 - x, dy + 1, color);
+  }
+}
+
+void TFT_eSPI::drawCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color) {
+  BusScope s(PRIM_CIRCLE);
+  int32_t f = 1 - r, ddF_y = -2 * r, ddF_x = 1, xs = -1, xe = 0, len;
+  bool first = true;
+  do {
+    while(f < 0) { ++xe; f += (ddF_x += 2); }
+    f += (ddF_y += 2);
+    if(xe - xs > 1) {
+      if(first) {
+        len = 2 * (xe - xs) - 1;
+        drawFastHLine(x0 - xe, y0 + r, len, color);
+        drawFastHLine(x0 - xe, y0 - r, len, color);
+        drawFastVLine(x0 + r, y0 - xe, len, color);
+        drawFastVLine(x0 - r, y0 - xe, len, color);
+        first = false;
+      } else {
+        len = xe - xs++;
+        drawFastHLine(x0 - xe, y0 + r, len, color);
+        drawFastHLine(x0 - xe, y0 - r, len, color);
+        drawFastHLine(x0 + xs, y0 - r, len, color);
+        drawFastHLine(x0 + xs, y0 + r, len, color);
+        drawFastVLine(x0 + r, y0 + xs, len, color);
+        drawFastVLine(x0 + r, y0 - xe, len, color);
+        drawFastVLine(x0 - r, y0 - xe, len, color);
+        drawFastVLine(x0 - r, y0 + xs, len, color);
+      }
+    } else {
+      ++xs;
+      drawPixel(x0 - xe, y0 + r, color);
+      drawPixel(x0 - xe, y0 - r, color);
+      drawPixel(x0 + xs, y0 - r, color);
+      drawPixel(x0 + xs, y0 + r, color);
+      drawPixel(x0 + r, y0 + xs, color);
+      drawPixel(x0 + r, y0 - xe, color);
+      drawPixel(x0 - r, y0 - xe, color);
+      drawPixel(x0 - r, y0 + xs, color);
+    }
+    xe = xs;
+  } while(xe < --r);
+}
+
+int16_t TFT_eSPI::textWidth(const char* s) const { return textWidth(s, font_); }
+int16_t TFT_eSPI::textWidth(const char* s, uint8_t font) const { return (int16_t)(glyphCount(s) * fontCell(font).w); }
+int16_t TFT_eSPI::fontHeight() const { return fontCell(font_).h; }
+int16_t TFT_eSPI::fontHeight(int16_t font) const { return fontCell((uint8_t)font).h; }
+
+// glyph pixels go to the panel or to a sprite's buffer
+struct Surface { uint16_t* px; int stride, w, h; };
+
+// With a background colour TFT_eSPI pushes each glyph as one window; without
+// one (fg == bg) it draws the ink column by column. bus = false: no cost.
+static void rasterText(const Surface& sf, bool bus, const char* s, FontCell cell, uint16_t fg, uint16_t bg,
+                       int32_t x, int32_t y) {
+  bool opaque = (bg != fg);
+  int32_t gx0 = x;
+  for(const unsigned char* p=(const unsigned char*)s; *p; p++){
+    if((*p & 0xC0) == 0x80) continue;
+    unsigned char ch = (*p < 0x80) ? *p : '?';
+    for(int i=0;i<cell.w;i++){
+      int gx = i * 6 / cell.w;
+      int runStart = -1;
+      for(int j=0;j<=cell.h;j++){
+        bool ink = (j < cell.h) && glyphInk(ch, gx, j * 8 / cell.h);
+        int32_t px = gx0 + i, py = y + j;
+        if(j < cell.h && px >= 0 && px < sf.w && py >= 0 && py < sf.h) {
+          if(ink) sf.px[py * sf.stride + px] = fg;
+          else if(opaque) sf.px[py * sf.stride + px] = bg;
+        }
+        if(bus && !opaque) {
+          if(ink && runStart < 0) runStart = j;
+          if(!ink && runStart >= 0) {
+            int32_t rx = gx0 + i, ry = y + runStart, rw = 1, rh = j - runStart;
+            if(clip(rx, ry, rw, rh)) window(rw, rh);
+            runStart = -1;
+          }
+        }
+      }
+    }
+    if(bus && opaque) {
+      int32_t rx = gx0, ry = y, rw = cell.w, rh = cell.h;
+      if(clip(rx, ry, rw, rh)) window(rw, rh);
+    }
+    gx0 += cell.w;
+  }
+}
+
+int16_t TFT_eSPI::renderText(const char* s, int32_t x, int32_t y) {
+  BusScope scope(PRIM_TEXT);
+  FontCell cell = fontCell(font_);
+  int w = textWidth(s);
+  Sim_labelDrawn(s, x, y, w, cell.h);
+  frameLabel(s);
+  Surface panel = { g_fb, FB_W, g_w, g_h };
+  rasterText(panel, true, s, cell, fg_, bg_, x, y);
+  inkDrawn(s, x, y, w, cell.h);
+  return (int16_t)w;
+}
+
+int16_t TFT_eSPI::drawString(const char* s, int32_t x, int32_t y) {
+  int w = textWidth(s), h = fontHeight();
+  int col = datum_ % 3, row = datum_ / 3;
+  x -= (col == 1) ? w/2 : (col == 2) ? w : 0;
+  y -= (row == 1) ? h/2 : (row == 2) ? h : 0;
+  return renderText(s, x, y);
+}
+
+// ---------------- pixel streams ----------------
+static int32_t  g_winX, g_winY, g_winW, g_winH;
+static uint32_t g_winPos, g_winLen;
+static bool     g_writeTop = false;
+static int      g_writeDepth = 0;
+
+static void closeWindow() {
+  if(g_winLen) {
+    if(!recognize(g_winX, g_winY, g_winW, g_winH)) recognizeImage(g_winX, g_winY, g_winW, g_winH);
+  }
+  g_winLen = 0;
+}
+
+void TFT_eSPI::startWrite() {
+  if(g_writeDepth++ == 0) g_writeTop = BusScope::open(PRIM_PUSH);
+}
+
+void TFT_eSPI::endWrite() {
+  if(g_writeDepth == 0 || --g_writeDepth) return;
+  closeWindow();
+  BusScope::close(g_writeTop);
+}
+
+void TFT_eSPI::setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h) {
+  BusScope s(PRIM_PUSH);
+  closeWindow();
+  if(!clip(x, y, w, h)) return;
+  g_winX = x; g_winY = y; g_winW = w; g_winH = h;
+  g_winPos = 0;
+  g_winLen = (uint32_t)(w * h);
+  Sim_areaPainted(x, y, w, h);
+  window(w, h);                     // the stream that follows is charged here
+}
+
+void TFT_eSPI::pushColor(uint16_t color, uint32_t len) {
+  BusScope s(PRIM_PUSH);
+  while(len && g_winPos < g_winLen) {
+    uint32_t col = g_winPos % g_winW;
+    uint32_t n = g_winW - col < len ? g_winW - col : len;
+    uint16_t* p = &g_fb[(g_winY + g_winPos / g_winW) * FB_W + g_winX + col];
+    for(uint32_t i=0;i<n;i++) p[i] = color;
+    g_winPos += n;
+    len -= n;
+  }
+  if(g_writeDepth == 0) closeWindow();
+}
+
+void TFT_eSPI::readRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data) {
+  BusScope s(PRIM_READ);
+  int32_t cx = x, cy = y, cw = w, ch = h;
+  if(!clip(cx, cy, cw, ch)) return;
+  uint64_t px = (uint64_t)cw * ch;
+  g_cost[PRIM_READ].windows++;
+  g_cost[PRIM_READ].pixels += px;
+  g_frame.cost.windows++;
+  g_frame.cost.pixels += px;
+  BusScope::charge(3ull * g_bus.cmdNs + byteNs(9) + (1 + 3 * px) * 8ull * 1000000000ull / g_bus.readHz);
+  for(int32_t j=0;j<h;j++)
+    for(int32_t i=0;i<w;i++) {
+      int32_t px_ = x + i, py = y + j;
+      data[j * w + i] = (px_ >= 0 && px_ < g_w && py >= 0 && py < g_h) ? g_fb[py * FB_W + px_] : 0;
+    }
+}
+
+size_t TFT_eSPI::write(const char* s, size_t n) {
+  char b[SIM_LABEL_LEN];
+  if(n >= sizeof(b)) n = sizeof(b) - 1;
+  memcpy(b, s, n);
+  b[n] = 0;
+  cx_ += renderText(b, cx_, cy_);
+  return n;
+}
+
+// ---------------- sprites ----------------
+void* TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t frames) {
+  (void)frames;
+  deleteSprite();
+  if(w <= 0 || h <= 0) return nullptr;
+  buf_ = new uint16_t[(size_t)w * h];
+  sw_ = w; sh_ = h;
+  w_ = w; h_ = h;
+  fillSprite(TFT_BLACK);
+  return buf_;
+}
+
+void TFT_eSprite::deleteSprite() {
+  delete[] buf_;
+  buf_ = nullptr;
+  sw_ = sh_ = 0;
+}
+
+void TFT_eSprite::fillSprite(uint32_t color) {
+  if(!buf_) return;
+  uint16_t c = bpp_ == 1 ? (color != 0) : (uint16_t)color;
+  for(int32_t i=0;i<(int32_t)sw_ * sh_;i++) buf_[i] = c;
+}
+
+// 1-bit sprites hold 0/1 and read back as black/white, as in TFT_eSPI
+uint16_t TFT_eSprite::readPixel(int32_t x, int32_t y) {
+  if(!buf_ || x < 0 || y < 0 || x >= sw_ || y >= sh_) return 0;
+  uint16_t c = buf_[y * sw_ + x];
+  return bpp_ == 1 ? (c ? TFT_WHITE : TFT_BLACK) : c;
+}
+
+int16_t TFT_eSprite::drawString(const char* s, int32_t x, int32_t y) {
+  if(!buf_) return 0;
+  FontCell cell = fontCell(font_);
+  int w = textWidth(s), h = cell.h;
+  int col = datum_ % 3, row = datum_ / 3;
+  x -= (col == 1) ? w/2 : (col == 2) ? w : 0;
+  y -= (row == 1) ? h/2 : (row == 2) ? h : 0;
+
+  uint16_t fg = bpp_ == 1 ? (fg_ != 0) : fg_;
+  uint16_t bg = bpp_ == 1 ? (bg_ != 0) : bg_;
+  if(fg_ == bg_) bg = fg;                 // transparent stays transparent
+  Surface sf = { buf_, sw_, sw_, sh_ };
+  rasterText(sf, false, s, cell, fg, bg, x, y);
+  if(fg != bg && x >= 0 && y >= 0 && x + w <= sw_ && y + h <= sh_)
+    imageDrawn(s, buf_ + y * sw_ + x, sw_, w, h, bg);
+  return (int16_t)w;
+}
+
+// ---------------- TftEmu API ----------------
+void TftEmu_setBus(const TftBusModel& m) { g_bus = m; }
+const TftBusModel& TftEmu_bus() { return g_bus; }
+
+int             TftEmu_width()  { return g_w; }
+int             TftEmu_height() { return g_h; }
+const uint16_t* TftEmu_pixels() { return g_fb; }
+
+uint32_t TftEmu_hash() {
+  uint32_t h = 2166136261u;
+  for(int y=0;y<g_h;y++){
+    for(int x=0;x<g_w;x++){
+      uint16_t c = g_fb[y * FB_W + x];
+      h = (h ^ (c & 0xFF)) * 16777619u;
+      h = (h ^ (c >> 8)) * 16777619u;
+    }
+  }
+  return h;
+}
+
+const TftCost& TftEmu_cost(TftPrim p) { return g_cost[p]; }
+
+const char* TftEmu_primName(TftPrim p) {
+  static const char* const NAMES[PRIM_COUNT] = {
+    "fillRect", "fillRoundRect", "drawRoundRect", "fastLine", "drawPixel", "circle", "drawString",
+    "pushColor", "readRect"
+  };
+  return NAMES[p];
+}
+
+void TftEmu_resetCosts() { memset(g_cost, 0, sizeof(g_cost)); }
+
+void TftEmu_setFrameSink(TftFrameSink sink, void* user) { g_sink = sink; g_sinkUser = user; }
+
+void TftEmu_endFrame() {
+  if(!g_frameOpen) return;
+  g_frameOpen = false;
+  if(g_pendingNs) { Sim_advanceUs((g_pendingNs + 999) / 1000); g_pendingNs = 0; }
+  if(g_sink) { SimUntracked u; g_sink(g_frame, g_sinkUser); }
+}
+
+// ---------------- PNG (uncompressed deflate, no zlib needed) ----------------
+static uint32_t crc32(uint32_t crc, const uint8_t* p, size_t n) {
+  static uint32_t table[256];
+  static bool init = false;
+  if(!init) {
+    for(uint32_t i=0;i<256;i++){
+      uint32_t c = i;
+      for(int k=0;k<8;k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      table[i] = c;
+    }
+    init = true;
+  }
+  crc = ~crc;
+  for(size_t i=0;i<n;i++) crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+static void put32(uint8_t* p, uint32_t v) { p[0]=v>>24; p[1]=v>>16; p[2]=v>>8; p[3]=v; }
+
+static void chunk(FILE* f, const char* type, const uint8_t* data, uint32_t n) {
+  uint8_t hdr[8];
+  put32(hdr, n);
+  memcpy(hdr + 4, type, 4);
+  fwrite(hdr, 1, 8, f);
+  if(n) fwrite(data, 1, n, f);
+  uint32_t c = crc32(crc32(0, (const uint8_t*)type, 4), data, n);
+  uint8_t t[4];
+  put32(t, c);
+  fwrite(t, 1, 4, f);
+}
+
+bool TftEmu_savePng(const char* path) {
+  FILE* f = fopen(path, "wb");
+  if(!f) return false;
+  SimUntracked u;
+
+  static const uint8_t SIG[8] = {0x89,'P','N','G','\r','\n',0x1A,'\n'};
+  fwrite(SIG, 1, 8, f);
+
+  uint8_t ihdr[13];
+  put32(ihdr, (uint32_t)g_w);
+  put32(ihdr + 4, (uint32_t)g_h);
+  ihdr[8] = 8; ihdr[9] = 2; ihdr[10] = 0; ihdr[11] = 0; ihdr[12] = 0;
+  chunk(f, "IHDR", ihdr, 13);
+
+  // raw scanlines (filter 0 + RGB888), wrapped in stored deflate blocks
+  const uint32_t rowLen = 1 + (uint32_t)g_w * 3;
+  const uint32_t rawLen = rowLen * (uint32_t)g_h;
+  uint8_t* raw = new uint8_t[rawLen];
+  for(int y=0;y<g_h;y++){
+    uint8_t* r = raw + y * rowLen;
+    r[0] = 0;
+    for(int x=0;x<g_w;x++){
+      uint16_t c = g_fb[y * FB_W + x];
+      r[1 + x*3]     = (uint8_t)(((c >> 11) & 0x1F) * 255 / 31);
+      r[1 + x*3 + 1] = (uint8_t)(((c >> 5) & 0x3F) * 255 / 63);
+      r[1 + x*3 + 2] = (uint8_t)((c & 0x1F) * 255 / 31);
+    }
+  }
+
+  const uint32_t BLK = 65535;
+  uint32_t blocks = (rawLen + BLK - 1) / BLK;
+  uint32_t zlen = 2 + rawLen + blocks * 5 + 4;
+  uint8_t* z = new uint8_t[zlen];
+  uint8_t* o = z;
+  *o++ = 0x78; *o++ = 0x01;
+  uint32_t a = 1, b = 0;
+  for(uint32_t i=0;i<rawLen;i+=BLK){
+    uint32_t n = rawLen - i < BLK ? rawLen - i : BLK;
+    *o++ = (i + n == rawLen) ? 1 : 0;
+    *o++ = n & 0xFF; *o++ = n >> 8;
+    *o++ = ~n & 0xFF; *o++ = (~n >> 8) & 0xFF;
+    memcpy(o, raw + i, n);
+    o += n;
+  }
+  for(uint32_t i=0;i<rawLen;i++){ a = (a + raw[i]) % 65521; b = (b + a) % 65521; }
+  put32(o, (b << 16) | a);
+
+  chunk(f, "IDAT", z, zlen);
+  chunk(f, "IEND", nullptr, 0);
+  delete[] z;
+  delete[] raw;
+  return fclose(f) == 0;
+}
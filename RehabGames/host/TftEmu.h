@@ -0,0 +1,71 @@
+// TftEmu.h – framebuffer + SPI cost model behind the TFT_eSPI stand-in
+//
+// Cost model (ILI9341 on TFT_eSPI): every top-level call is one SPI
+// transaction; every internal line/rect/pixel/glyph is one address window
+// (CASET+PASET+RAMWR: 3 command bytes, 8 data bytes) followed by 2 bytes per
+// pixel. Bus time is charged to the virtual clock as the call returns.
+// startWrite()..endWrite() is one transaction; readRect() reads 3 bytes per
+// pixel at the (slower) read clock.
+//
+// Text pushed as pixels (a cached screen image) is recognized again: every
+// drawString remembers its box and the hash of its pixels, and a pushed
+// window that restores exactly those pixels makes the label visible again.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+enum TftPrim {
+  PRIM_FILL_RECT,
+  PRIM_FILL_ROUND_RECT,
+  PRIM_DRAW_ROUND_RECT,
+  PRIM_LINE,
+  PRIM_PIXEL,
+  PRIM_CIRCLE,
+  PRIM_TEXT,
+  PRIM_PUSH,
+  PRIM_READ,
+  PRIM_COUNT
+};
+
+struct TftCost {
+  uint64_t calls;
+  uint64_t pixels;
+  uint64_t windows;
+  uint64_t busNs;
+};
+
+struct TftBusModel {
+  uint32_t spiHz;          // effective SCK (55 MHz in User_Setup.h rounds to 40 MHz on ESP32)
+  uint32_t txnNs;          // CS + beginTransaction/endTransaction
+  uint32_t cmdNs;          // D/C toggle per command byte
+  uint32_t readHz;         // RAMRD clock (SPI_READ_FREQUENCY), 3 bytes per pixel
+};
+
+static const int TFT_FRAME_LABELS = 16;
+
+struct TftFrame {
+  uint64_t    startUs;
+  TftCost     cost;          // calls = top-level primitives in the frame
+  int         labelCount;
+  const char* labels[TFT_FRAME_LABELS];
+};
+
+typedef void (*TftFrameSink)(const TftFrame& f, void* user);
+
+void TftEmu_setBus(const TftBusModel& m);
+const TftBusModel& TftEmu_bus();
+
+int             TftEmu_width();
+int             TftEmu_height();
+const uint16_t* TftEmu_pixels();
+uint32_t        TftEmu_hash();                     // FNV-1a over the framebuffer
+bool            TftEmu_savePng(const char* path);  // RGB888, stored deflate
+
+const TftCost&  TftEmu_cost(TftPrim p);
+const char*     TftEmu_primName(TftPrim p);
+void            TftEmu_resetCosts();
+
+// Frames: everything drawn between two idle points (delay() or the end of a
+// loop() pass). Empty frames are not reported.
+void TftEmu_setFrameSink(TftFrameSink sink, void* user);
+void TftEmu_endFrame();
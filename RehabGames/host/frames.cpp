@@ -0,0 +1,242 @@
+// frames.cpp – per-screen SPI bus budget + golden framebuffer check
+//
+// Plays a fixed-seed patient session, names every frame (everything drawn
+// between two idle points) after the screen it belongs to, and reports the
+// bus time per frame and a hot-spot ranking per primitive. Frame maxima are
+// checked against frames.budget; the framebuffer hash at the first
+// occurrence of each frame is checked against frames.golden.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+#include "Shared.h"
+#include "Render.h"
+#include "ScreenCache.h"
+#include "DrawList.h"
+#include "Progress.h"
+#include "LabelCache.h"
+#include "HostSim.h"
+#include "TftEmu.h"
+#include "Patient.h"
+
+void setup();
+void loop();
+
+struct Rule { const char* name; const char* label; };
+
+// first match wins; a frame with no known label is an "update"
+static const Rule RULES[] = {
+  {"menu",            "RehabGames"},
+  {"level",           "Choose a mode"},
+  {"level",           "Choose Difficulty"},
+  {"retry",           "RFID ERROR"},
+  {"end",             "PLAY AGAIN"},
+  {"end.header",      "Session finished"},
+  {"countdown.go",    "GO!"},
+  {"countdown",       "Starting..."},
+  {"countdown",       "STARTING"},
+  {"countdown",       "3"},
+  {"countdown",       "2"},
+  {"countdown",       "1"},
+  {"play.header",     "SCAN 2 TAGS"},
+  {"sequence.watch",  "Watch the sequence"},
+  {"sequence.repeat", "REPEAT"},
+  {"round.watch",     "WATCH"},
+  {"round.scan",      "SCAN"},
+  {"round.result",    "NICE!"},
+  {"round.result",    "ALMOST!"},
+  {"round.result",    "TIME UP"},
+  {"round.next",      "Remember the peg position"},
+};
+
+struct FrameAgg {
+  uint64_t count = 0, busNs = 0, maxNs = 0, pixels = 0, windows = 0;
+  uint32_t firstHash = 0;
+  bool     seen = false;
+};
+
+struct Run {
+  std::map<std::string, FrameAgg> frames;
+  const char* pngDir = nullptr;
+};
+
+static const char* screenPrefix() {
+  switch(g_screen) {
+    case SCR_GAME1: return "g1.";
+    case SCR_GAME2: return "g2.";
+    case SCR_GAME3: return "g3.";
+    default:        return "";
+  }
+}
+
+static void onFrame(const TftFrame& f, void* user) {
+  Run& run = *(Run*)user;
+  const char* name = "update";
+  for(size_t r=0; r<sizeof(RULES)/sizeof(RULES[0]) && !strcmp(name, "update"); r++){
+    for(int i=0;i<f.labelCount;i++){
+      if(!strcmp(f.labels[i], RULES[r].label)) { name = RULES[r].name; break; }
+    }
+  }
+  // label-less frames that read the panel back are ScreenCache captures
+  static uint64_t reads = 0;
+  uint64_t nowReads = TftEmu_cost(PRIM_READ).calls;
+  if(!strcmp(name, "update") && nowReads != reads) name = "capture";
+  reads = nowReads;
+  std::string key = std::string(strcmp(name, "menu") ? screenPrefix() : "") + name;
+
+  FrameAgg& a = run.frames[key];
+  a.count++;
+  a.busNs += f.cost.busNs;
+  a.pixels += f.cost.pixels;
+  a.windows += f.cost.windows;
+  if(f.cost.busNs > a.maxNs) a.maxNs = f.cost.busNs;
+  if(!a.seen) {
+    a.seen = true;
+    a.firstHash = TftEmu_hash();
+    if(run.pngDir) {
+      std::string path = std::string(run.pngDir) + "/" + key + ".png";
+      TftEmu_savePng(path.c_str());
+    }
+  }
+}
+
+static std::map<std::string, uint64_t> readTable(const char* path, int base) {
+  std::map<std::string, uint64_t> t;
+  FILE* f = fopen(path, "r");
+  if(!f) return t;
+  char line[256], name[128], val[64];
+  while(fgets(line, sizeof(line), f)) {
+    if(line[0] == '#' || sscanf(line, "%127s %63s", name, val) != 2) continue;
+    t[name] = strtoull(val, nullptr, base);
+  }
+  fclose(f);
+  return t;
+}
+
+static void usage() {
+  printf("usage: rehab_frames [--responses N] [--png DIR] [--update-golden]\n"
+         "                    [--budget FILE] [--golden FILE]\n");
+}
+
+int main(int argc, char** argv) {
+  uint64_t responses = 400;
+  bool updateGolden = false;
+  const char* budgetPath = "frames.budget";
+  const char* goldenPath = "frames.golden";
+  Run run;
+
+  for(int i=1;i<argc;i++){
+    if(!strcmp(argv[i], "--update-golden")) updateGolden = true;
+    else if(i + 1 < argc && !strcmp(argv[i], "--responses")) responses = strtoull(argv[++i], nullptr, 10);
+    else if(i + 1 < argc && !strcmp(argv[i], "--png"))       run.pngDir = argv[++i];
+    else if(i + 1 < argc && !strcmp(argv[i], "--budget"))    budgetPath = argv[++i];
+    else if(i + 1 < argc && !strcmp(argv[i], "--golden"))    goldenPath = argv[++i];
+    else { usage(); return 2; }
+  }
+
+  PatientConfig pc;
+  pc.seed = 7;
+  Patient patient(pc);
+  Sim_setWorld(&patient);
+
+  setup();
+  TftEmu_endFrame();
+  TftEmu_resetCosts();
+  TftEmu_setFrameSink(onFrame, &run);
+  while(patient.stats().responses < responses) {
+    loop();
+    TftEmu_endFrame();
+  }
+
+  // ---- per-frame table ----
+  std::map<std::string, uint64_t> budget = readTable(budgetPath, 10);
+  std::map<std::string, uint64_t> golden = readTable(goldenPath, 16);
+  uint64_t totalNs = 0;
+  for(auto& kv : run.frames) totalNs += kv.second.busNs;
+
+  printf("%-22s %7s %10s %10s %10s %8s %7s  %s\n",
+         "frame", "count", "mean_us", "max_us", "budget_us", "windows", "share", "check");
+  int failures = 0;
+  for(auto& kv : run.frames) {
+    const FrameAgg& a = kv.second;
+    auto b = budget.find(kv.first);
+    auto g = golden.find(kv.first);
+    char check[64] = "";
+    if(b != budget.end() && a.maxNs / 1000 > b->second) { strcat(check, "OVER-BUDGET "); failures++; }
+    if(!updateGolden && g != golden.end() && g->second != a.firstHash) { strcat(check, "GOLDEN-DIFF"); failures++; }
+    printf("%-22s %7llu %10.0f %10.0f %10s %8llu %6.1f%%  %s\n",
+           kv.first.c_str(), (unsigned long long)a.count,
+           a.busNs / 1000.0 / a.count, a.maxNs / 1000.0,
+           b != budget.end() ? std::to_string(b->second).c_str() : "-",
+           (unsigned long long)(a.windows / a.count),
+           totalNs ? 100.0 * a.busNs / totalNs : 0.0, check);
+  }
+
+  // ---- hot spots by primitive ----
+  printf("\n%-14s %10s %10s %12s %10s %7s\n", "primitive", "calls", "windows", "pixels", "bus_ms", "share");
+  uint64_t primNs = 0;
+  for(int p=0;p<PRIM_COUNT;p++) primNs += TftEmu_cost((TftPrim)p).busNs;
+  std::vector<int> order;
+  for(int p=0;p<PRIM_COUNT;p++) order.push_back(p);
+  std::sort(order.begin(), order.end(), [](int a, int b){
+    return TftEmu_cost((TftPrim)a).busNs > TftEmu_cost((TftPrim)b).busNs;
+  });
+  for(int p : order) {
+    const TftCost& c = TftEmu_cost((TftPrim)p);
+    printf("%-14s %10llu %10llu %12llu %10.1f %6.1f%%\n", TftEmu_primName((TftPrim)p),
+           (unsigned long long)c.calls, (unsigned long long)c.windows,
+           (unsigned long long)c.pixels, c.busNs / 1e6, primNs ? 100.0 * c.busNs / primNs : 0.0);
+  }
+
+  // ---- render queue ----
+  const RenderStats& rs = Render_stats();
+  printf("\nrender queue: %u posted, %u drawn, %u coalesced, %u inline, max depth %u, %u full waits\n",
+         rs.posted, rs.drawn, rs.coalesced, rs.inlined, rs.maxDepth, rs.fullWaits);
+
+  // ---- screen cache ----
+  const ScreenCacheStats& cs = ScreenCache_stats();
+  printf("\nscreen cache: %u shown from images, %u painted, %u captured, %u rejected, %u B held (",
+         cs.hits, cs.paints, cs.captures, cs.rejected, cs.bytes);
+  for(int i=0;i<SCREEN_COUNT;i++) printf("%s%u", i ? " " : "", ScreenCache_size((ScreenId)i));
+  printf(")\n");
+
+  // ---- draw lists ----
+  const DrawListStats& ds = DrawList_stats();
+  printf("draw lists: %u runs, %u ops, %u shape batches in %u windows (%u px), %u overflows\n",
+         ds.runs, ds.ops, ds.batches, ds.windows, ds.pixels, ds.overflows);
+  const ProgressStats& ps = Progress_stats();
+  uint32_t deltas = ps.frames - ps.fullPaints;
+  printf("progress bars: %u frames, %u full paints, %.1f px per other frame\n", ps.frames, ps.fullPaints,
+         deltas ? (double)ps.pixels / deltas : 0.0);
+  const LabelCacheStats& ls = LabelCache_stats();
+  printf("label cache: %u hits, %u rendered, %u drawn by tft, %u evicted, %u B held\n",
+         ls.hits, ls.misses, ls.fallbacks, ls.evictions, ls.bytes);
+  if(ds.overflows) {
+    printf("DRAWLIST-OVERFLOW: a recording ran out of room\n");
+    failures++;
+  }
+
+  // ---- SPI bus ----
+  // stretch = longest TFT hold without a yield point = worst touch wait on the device
+  printf("\n%-8s %9s %9s %10s %12s\n", "spi dev", "acquires", "handoffs", "hold_max", "stretch_max");
+  for(int d=0; d<SPI_DEV_COUNT; d++) {
+    const SpiDevStats& s = SpiBus_stats((SpiDev)d);
+    printf("%-8s %9u %9u %8uus %10uus\n", SpiBus_device((SpiDev)d).name,
+           s.acquires, s.handoffs, s.holdUsMax, s.stretchUsMax);
+  }
+
+  if(updateGolden) {
+    FILE* f = fopen(goldenPath, "w");
+    if(!f) { perror(goldenPath); return 2; }
+    fprintf(f, "# framebuffer FNV-1a at the first occurrence of each frame (rehab_frames --update-golden)\n");
+    for(auto& kv : run.frames) fprintf(f, "%-22s %08x\n", kv.first.c_str(), kv.second.firstHash);
+    fclose(f);
+    printf("\nwrote %s\n", goldenPath);
+  }
+
+  if(failures) printf("\n%d check(s) failed\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,31 @@
+// Adafruit_NeoPixel.h – host stand-in; show() hands the frame to the simulator
+#pragma once
+#include <Arduino.h>
+
+#define NEO_GRB    ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_KHZ800 0x0000
+
+class Adafruit_NeoPixel {
+public:
+  Adafruit_NeoPixel(uint16_t n, int16_t pin, uint16_t type);
+  ~Adafruit_NeoPixel();
+
+  void begin() {}
+  void show();
+  void clear();
+  void setPixelColor(uint16_t n, uint32_t c);
+  void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b);
+  uint32_t getPixelColor(uint16_t n) const;
+  void setBrightness(uint8_t b) { brightness_ = b; }
+  uint16_t numPixels() const { return n_; }
+
+  static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+    return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+  }
+
+private:
+  uint16_t  n_;
+  int16_t   pin_;
+  uint32_t* px_;
+  uint8_t   brightness_ = 255;
+};
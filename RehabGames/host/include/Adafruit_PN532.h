@@ -0,0 +1,41 @@
+// Adafruit_PN532.h – host stand-in
+// Follows the Adafruit library's I2C path (frames over Wire, status-byte
+// polling every 10 ms) so driver timing matches the board. The chip on the
+// other end is Pn532Emu.
+#pragma once
+#include <Arduino.h>
+#include <Wire.h>
+
+#define PN532_MIFARE_ISO14443A 0x00
+
+#define PN532_I2C_ADDRESS (0x48 >> 1)
+#define PN532_I2C_READY   (0x01)
+
+#define PN532_COMMAND_GETFIRMWAREVERSION   (0x02)
+#define PN532_COMMAND_SAMCONFIGURATION     (0x14)
+#define PN532_COMMAND_INLISTPASSIVETARGET  (0x4A)
+
+#define PN532_PACKBUFFSIZ 64
+
+class Adafruit_PN532 {
+public:
+  Adafruit_PN532(uint8_t irq, uint8_t reset, TwoWire* theWire = &Wire)
+    : wire_(theWire) { (void)irq; (void)reset; }
+
+  bool begin();
+  bool SAMConfig();
+  uint32_t getFirmwareVersion();
+  bool sendCommandCheckAck(uint8_t* cmd, uint8_t cmdlen, uint16_t timeout = 100);
+  bool readPassiveTargetID(uint8_t cardbaudrate, uint8_t* uid, uint8_t* uidLength,
+                           uint16_t timeout = 0);
+
+private:
+  bool isready();
+  bool waitready(uint16_t timeout);
+  bool readack();
+  void readdata(uint8_t* buff, uint8_t n);
+  void writecommand(uint8_t* cmd, uint8_t cmdlen);
+
+  TwoWire* wire_;
+  uint8_t  packetbuffer_[PN532_PACKBUFFSIZ];
+};
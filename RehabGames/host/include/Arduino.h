@@ -0,0 +1,110 @@
+// Arduino.h – host stand-in (RehabGames host build)
+// Only what the sketch actually uses. Time is virtual: delay() advances the
+// simulator clock instead of sleeping.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+#define HIGH   0x1
+#define LOW    0x0
+#define INPUT  0x01
+#define OUTPUT 0x03
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int  digitalRead(uint8_t pin);
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+// ---------------- String (heap-backed, like the real one) ----------------
+class String {
+public:
+  String(const char* s = "");
+  String(const String& o);
+  String(char c);
+  String(int v);
+  String(unsigned int v);
+  String(long v);
+  String(unsigned long v);
+  ~String();
+
+  String& operator=(const String& o);
+  String& operator+=(const String& o);
+  String& operator+=(const char* s);
+  String& operator+=(int v);
+  String& operator+=(long v);
+  String& operator+=(unsigned int v);
+  String& operator+=(unsigned long v);
+
+  const char* c_str() const { return buf_ ? buf_ : ""; }
+  unsigned int length() const { return len_; }
+
+private:
+  void append(const char* s, unsigned int n);
+  char* buf_ = nullptr;
+  unsigned int len_ = 0;
+  unsigned int cap_ = 0;
+};
+
+String operator+(const String& a, const String& b);
+String operator+(const String& a, const char* b);
+String operator+(const String& a, int b);
+String operator+(const String& a, long b);
+String operator+(const String& a, unsigned int b);
+String operator+(const String& a, unsigned long b);
+
+// ---------------- Print / Serial ----------------
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(const char* s, size_t n) = 0;
+
+  size_t print(const char* s)      { return write(s, strlen(s)); }
+  size_t print(const String& s)    { return print(s.c_str()); }
+  size_t print(int v);
+  size_t print(unsigned long v);
+  size_t println()                 { return print("\n"); }
+  size_t println(const char* s)    { return print(s) + println(); }
+  size_t println(const String& s)  { return print(s) + println(); }
+  size_t println(int v)            { return print(v) + println(); }
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  int  available();
+  int  read();
+  size_t write(const char* s, size_t n) override;
+  operator bool() const { return true; }
+};
+extern HardwareSerial Serial;
+
+// ESP32 heap queries, modeled on the sim's heap accounting (HostSim.h)
+class EspClass {
+public:
+  uint32_t getHeapSize();
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap();
+};
+extern EspClass ESP;
@@ -0,0 +1,46 @@
+// Firebase_ESP_Client.h – host stand-in (offline: nothing is ever sent)
+#pragma once
+#include <Arduino.h>
+
+class FirebaseJson {
+public:
+  void set(const char* path, int v)         { (void)path; (void)v; }
+  void set(const char* path, float v)       { (void)path; (void)v; }
+  void set(const char* path, const char* v) { (void)path; (void)v; }
+  void set(const char* path, const String& v) { (void)path; (void)v; }
+};
+
+class FirebaseData {
+public:
+  String errorReason() { return String("offline (host build)"); }
+};
+
+struct FirebaseAuth {};
+
+struct FirebaseSignupError { String message; };
+struct FirebaseSigner { FirebaseSignupError signupError; };
+
+struct FirebaseConfig {
+  String api_key;
+  String database_url;
+  FirebaseSigner signer;
+};
+
+class FirebaseRTDB {
+public:
+  bool pushJSON(FirebaseData* d, const char* path, FirebaseJson* j) {
+    (void)d; (void)path; (void)j; return false;
+  }
+};
+
+class FirebaseESP {
+public:
+  bool signUp(FirebaseConfig* c, FirebaseAuth* a, const char* e, const char* p) {
+    (void)a; (void)e; (void)p; c->signer.signupError.message = "offline (host build)"; return false;
+  }
+  void begin(FirebaseConfig* c, FirebaseAuth* a) { (void)c; (void)a; }
+  void reconnectWiFi(bool on) { (void)on; }
+  bool ready() { return false; }
+  FirebaseRTDB RTDB;
+};
+extern FirebaseESP Firebase;
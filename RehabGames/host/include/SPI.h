@@ -0,0 +1,25 @@
+// SPI.h – host stand-in
+#pragma once
+#include <Arduino.h>
+
+#define SPI_MODE0 0x00
+
+class SPISettings {
+public:
+  SPISettings(uint32_t clock = 1000000, uint8_t bitOrder = 1, uint8_t dataMode = SPI_MODE0)
+    : clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+  uint32_t clock;
+  uint8_t  bitOrder;
+  uint8_t  dataMode;
+};
+
+class SPIClass {
+public:
+  void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {
+    (void)sck; (void)miso; (void)mosi; (void)ss;
+  }
+  void beginTransaction(const SPISettings&) {}
+  void endTransaction() {}
+  void setFrequency(uint32_t) {}
+};
+extern SPIClass SPI;
@@ -0,0 +1,101 @@
+// TFT_eSPI.h – host stand-in
+// Rasterizes into an in-memory RGB565 framebuffer (see TftEmu.h) and keeps
+// the ILI9341 SPI cost of every primitive: pixels, address windows, bus time.
+#pragma once
+#include <Arduino.h>
+
+#define TFT_BLACK 0x0000
+#define TFT_WHITE 0xFFFF
+#define TFT_RED   0xF800
+#define TFT_GREEN 0x07E0
+
+#define TL_DATUM 0
+#define TC_DATUM 1
+#define TR_DATUM 2
+#define ML_DATUM 3
+#define MC_DATUM 4
+#define MR_DATUM 5
+#define BL_DATUM 6
+#define BC_DATUM 7
+#define BR_DATUM 8
+
+class TFT_eSPI : public Print {
+public:
+  TFT_eSPI(int16_t w = 240, int16_t h = 320) : w_(w), h_(h) {}
+
+  void init();
+  void setRotation(uint8_t r);
+  void setTextWrap(bool wrapX, bool wrapY = false) { (void)wrapX; (void)wrapY; }
+  int16_t width() const  { return w_; }
+  int16_t height() const { return h_; }
+
+  void fillScreen(uint32_t color) { fillRect(0, 0, w_, h_, color); }
+  void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+  void drawPixel(int32_t x, int32_t y, uint32_t color);
+  void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color);
+  void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color);
+  void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+  void drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+  void fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color);
+  void drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color);
+
+  // raw pixel streams: one address window, then pushColor() fills it in
+  // row order; startWrite()/endWrite() keep CS low across several calls
+  void startWrite();
+  void endWrite();
+  void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h);
+  void pushColor(uint16_t color, uint32_t len = 1);
+  void readRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data);
+
+  void setTextDatum(uint8_t d) { datum_ = d; }
+  void setTextFont(uint8_t f)  { font_ = f; }
+  void setTextColor(uint16_t fg) { fg_ = fg; bg_ = fg; }
+  void setTextColor(uint16_t fg, uint16_t bg, bool bgfill = false) { fg_ = fg; bg_ = bg; (void)bgfill; }
+  void setCursor(int16_t x, int16_t y) { cx_ = x; cy_ = y; }
+
+  int16_t drawString(const char* s, int32_t x, int32_t y);
+  int16_t drawString(const String& s, int32_t x, int32_t y) { return drawString(s.c_str(), x, y); }
+  int16_t textWidth(const char* s) const;
+  int16_t textWidth(const char* s, uint8_t font) const;
+  int16_t fontHeight() const;
+  int16_t fontHeight(int16_t font) const;
+
+  uint16_t color565(uint8_t r, uint8_t g, uint8_t b) const {
+    return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+  }
+
+  size_t write(const char* s, size_t n) override;
+
+protected:
+  void fillCircleHelper(int32_t x0, int32_t y0, int32_t r, uint8_t corners, int32_t delta, uint32_t color);
+  void drawCircleHelper(int32_t x0, int32_t y0, int32_t r, uint8_t corners, uint32_t color);
+  int16_t renderText(const char* s, int32_t x, int32_t y);
+
+  int16_t  w_, h_;
+  uint8_t  datum_ = TL_DATUM;
+  uint8_t  font_ = 1;
+  uint16_t fg_ = TFT_WHITE, bg_ = TFT_WHITE;
+  int16_t  cx_ = 0, cy_ = 0;
+};
+
+// In-RAM canvas. Only what the label cache needs: text into a 1- or 16-bit
+// buffer, read back pixel by pixel. Nothing here touches the bus.
+class TFT_eSprite : public TFT_eSPI {
+public:
+  explicit TFT_eSprite(TFT_eSPI* tft) { (void)tft; }
+  ~TFT_eSprite() { deleteSprite(); }
+
+  void*    setColorDepth(int8_t bpp) { bpp_ = bpp; return buf_; }
+  void*    createSprite(int16_t w, int16_t h, uint8_t frames = 1);
+  void     deleteSprite();
+  bool     created() const { return buf_ != nullptr; }
+  void     fillSprite(uint32_t color);
+  uint16_t readPixel(int32_t x, int32_t y);
+
+  int16_t  drawString(const char* s, int32_t x, int32_t y);
+
+private:
+  uint16_t* buf_ = nullptr;
+  int16_t   sw_ = 0, sh_ = 0;
+  int8_t    bpp_ = 16;
+};
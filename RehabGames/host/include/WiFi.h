@@ -0,0 +1,14 @@
+// WiFi.h – host stand-in: the simulated kiosk is always offline
+#pragma once
+#include <Arduino.h>
+
+#define WIFI_STA 1
+typedef enum { WL_IDLE_STATUS = 0, WL_CONNECTED = 3, WL_DISCONNECTED = 6 } wl_status_t;
+
+class WiFiClass {
+public:
+  bool mode(int m) { (void)m; return true; }
+  int  begin(const char* ssid, const char* pass) { (void)ssid; (void)pass; return WL_DISCONNECTED; }
+  wl_status_t status() { return WL_DISCONNECTED; }
+};
+extern WiFiClass WiFi;
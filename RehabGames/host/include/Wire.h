@@ -0,0 +1,37 @@
+// Wire.h – host stand-in
+// A real byte-level I2C master on top of I2cEmu: transactions reach the
+// emulated devices (PN532, ...) and cost bus time on the virtual clock.
+#pragma once
+#include <Arduino.h>
+
+#define I2C_BUFFER_LENGTH 128
+
+class TwoWire {
+public:
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+  bool end();
+  bool setClock(uint32_t frequency) { clock_ = frequency; return true; }
+  uint32_t getClock() const { return clock_; }
+  void setTimeOut(uint16_t ms) { timeoutMs_ = ms; }
+  uint16_t getTimeOut() const { return timeoutMs_; }
+
+  void    beginTransmission(uint8_t address);
+  size_t  write(uint8_t b);
+  size_t  write(const uint8_t* data, size_t n);
+  uint8_t endTransmission(bool sendStop = true);
+  uint8_t requestFrom(uint8_t address, uint8_t n, bool sendStop = true);
+  int     available() { return rxLen_ - rxPos_; }
+  int     read() { return rxPos_ < rxLen_ ? rxBuf_[rxPos_++] : -1; }
+  int     peek() { return rxPos_ < rxLen_ ? rxBuf_[rxPos_] : -1; }
+
+private:
+  uint32_t clock_ = 100000;
+  uint16_t timeoutMs_ = 50;
+  bool     running_ = false;
+  uint8_t  txAddr_ = 0;
+  uint8_t  txBuf_[I2C_BUFFER_LENGTH];
+  size_t   txLen_ = 0;
+  uint8_t  rxBuf_[I2C_BUFFER_LENGTH];
+  int      rxLen_ = 0, rxPos_ = 0;
+};
+extern TwoWire Wire;
@@ -0,0 +1,20 @@
+// XPT2046_Touchscreen.h – host stand-in, fed by the simulator world model
+#pragma once
+#include <Arduino.h>
+#include <SPI.h>
+
+class TS_Point {
+public:
+  TS_Point() : x(0), y(0), z(0) {}
+  TS_Point(int16_t x, int16_t y, int16_t z) : x(x), y(y), z(z) {}
+  int16_t x, y, z;
+};
+
+class XPT2046_Touchscreen {
+public:
+  XPT2046_Touchscreen(uint8_t cs, uint8_t irq = 255) { (void)cs; (void)irq; }
+  bool begin(SPIClass& = SPI) { return true; }
+  void setRotation(uint8_t r) { (void)r; }
+  TS_Point getPoint();
+  bool touched();
+};
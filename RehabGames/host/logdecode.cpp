@@ -0,0 +1,118 @@
+// logdecode.cpp – expands the sketch's binary log frames (Log.h) to text
+//
+//   rehab_logdecode [file]          default: stdin, e.g. the serial port
+//
+// Bytes outside frames (MemMon_report, the console) pass through unchanged.
+// Build from the same revision as the firmware: ids index LogFormats.h.
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "LogFormats.h"
+
+struct LogFormat { const char* module; const char* level; const char* fmt; };
+
+static const LogFormat FORMATS[] = {
+#define LOG_X_ROW(id, mod, lvl, fmt) { #mod, #lvl, fmt },
+  LOG_FORMATS(LOG_X_ROW)
+#undef LOG_X_ROW
+};
+static const int FORMAT_COUNT = sizeof(FORMATS) / sizeof(FORMATS[0]);
+
+static const int FRAME_START = 0x1E;
+
+struct Reader {
+  const uint8_t* p;
+  const uint8_t* end;
+  bool ok;
+  uint32_t u32() {
+    if(end - p < 4) { ok = false; return 0; }
+    uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    p += 4;
+    return v;
+  }
+};
+
+static bool isMod(char c) { return strchr("-+ #.0123456789lh", c) != nullptr; }
+
+// printf-expands fmt with the frame's arguments
+static bool expand(const char* fmt, Reader& r, char* out, size_t cap) {
+  size_t n = 0;
+  for(const char* f = fmt; *f && n + 1 < cap; ) {
+    if(*f != '%') { out[n++] = *f++; continue; }
+    if(f[1] == '%') { out[n++] = '%'; f += 2; continue; }
+
+    char spec[16];
+    size_t k = 0;
+    spec[k++] = *f++;
+    while(*f && isMod(*f)) {
+      if(*f != 'l' && *f != 'h' && k < sizeof(spec) - 2) spec[k++] = *f;   // everything is 32-bit
+      f++;
+    }
+    char conv = *f ? *f++ : 'd';
+    spec[k++] = conv;
+    spec[k] = 0;
+
+    int w;
+    if(conv == 's') {
+      if(r.p >= r.end || r.end - r.p < 1 + *r.p) return false;
+      char s[256];
+      uint8_t len = *r.p++;
+      memcpy(s, r.p, len);
+      s[len] = 0;
+      r.p += len;
+      w = snprintf(out + n, cap - n, spec, s);
+    } else if(conv == 'f' || conv == 'e' || conv == 'g') {
+      uint32_t u = r.u32();
+      float v;
+      memcpy(&v, &u, 4);
+      w = snprintf(out + n, cap - n, spec, (double)v);
+    } else if(conv == 'd' || conv == 'i') {
+      w = snprintf(out + n, cap - n, spec, (int)(int32_t)r.u32());
+    } else {
+      w = snprintf(out + n, cap - n, spec, (unsigned)r.u32());
+    }
+    if(!r.ok || w < 0) return false;
+    n += (size_t)w < cap - n ? (size_t)w : cap - n - 1;
+  }
+  out[n] = 0;
+  return r.p == r.end;
+}
+
+int main(int argc, char** argv) {
+  FILE* in = stdin;
+  if(argc > 2 || (argc == 2 && !strcmp(argv[1], "--help"))) {
+    printf("usage: rehab_logdecode [file]\n");
+    return 2;
+  }
+  if(argc == 2 && !(in = fopen(argv[1], "rb"))) { perror(argv[1]); return 1; }
+
+  unsigned frames = 0, bad = 0;
+  int c;
+  while((c = fgetc(in)) != EOF) {
+    if(c != FRAME_START) { putchar(c); continue; }
+
+    int len = fgetc(in);
+    if(len == EOF) break;
+    uint8_t b[256];
+    size_t got = fread(b, 1, (size_t)len + 1, in);
+    if(got != (size_t)len + 1) { bad++; break; }
+    uint8_t sum = 0;
+    for(int i=0;i<len;i++) sum += b[i];
+    if(sum != b[len] || len < 6) { bad++; continue; }
+
+    uint16_t id = (uint16_t)(b[0] | (b[1] << 8));
+    uint32_t ms = b[2] | (b[3] << 8) | (b[4] << 16) | ((uint32_t)b[5] << 24);
+    if(id >= FORMAT_COUNT) { printf("%10.3f ? unknown id %u\n", ms / 1000.0, id); bad++; continue; }
+
+    const LogFormat& f = FORMATS[id];
+    Reader r{b + 6, b + len, true};
+    char text[512];
+    if(!expand(f.fmt, r, text, sizeof(text))) { snprintf(text, sizeof(text), "<bad args> %s", f.fmt); bad++; }
+    printf("%10.3f %c %-4s %s\n", ms / 1000.0, f.level[0], f.module, text);
+    frames++;
+  }
+  fflush(stdout);
+  fprintf(stderr, "logdecode: %u frames, %u bad\n", frames, bad);
+  if(in != stdin) fclose(in);
+  return bad ? 1 : 0;
+}
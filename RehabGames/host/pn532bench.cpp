@@ -0,0 +1,562 @@
+// pn532bench.cpp – PN532 driver throughput and recovery benchmark
+//
+// Runs the host Adafruit_PN532 driver (real frames over the emulated I2C
+// bus) against Pn532Emu with scripted tag arrivals and injected faults.
+// The polling/recovery loops are copies of what the games do today:
+//   none – readPassiveTargetID(50) in a loop, nothing else
+//   g1   – Game1: SAMConfig after each read and every 2.5 s, full
+//          re-init (400 kHz, then 100 kHz) after 6 s without a read
+//   g3   – Game3: 2-hit UID filter, SAMConfig kick after each read,
+//          Wire teardown + re-init after 2.5 s without a read (1.2 s cooldown)
+//   mgr  – the sketch's reader health manager (../Rfid.h), which replaced
+//          both watchdogs
+// The clock-ladder section runs a plain polling loop against wiring with a
+// clock ceiling, at fixed 400/100 kHz and through I2cBus (../I2cBus.h).
+// The pair section compares one- and two-handed Color Match placements at
+// MaxTg 1 (Rfid_read) and MaxTg 2 (Rfid_readPegs). The readers section puts
+// 1/2/4 emulated PN532s behind a TcaMuxEmu, splits the 16 zones between
+// them and scans them round-robin and concurrently.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_PN532.h>
+#include "HostSim.h"
+#include "I2cEmu.h"
+#include "Pn532Emu.h"
+#include "TcaMuxEmu.h"
+#include "I2cBus.h"
+#include "Rfid.h"
+
+Adafruit_PN532 nfc(-1, -1);     // what Rfid.cpp talks to
+static const uint8_t TAG_UID[4] = {0xDE, 0xAD, 0xBE, 0xEF};
+
+static uint32_t g_rng = 1;
+static uint32_t rnd(uint32_t lo, uint32_t hi) {
+  g_rng = g_rng * 1664525u + 1013904223u;
+  return lo + (g_rng >> 8) % (hi - lo + 1);
+}
+
+// ---------------- strategies ----------------
+enum Strategy { S_NONE, S_G1, S_G3, S_MGR, S_COUNT };
+static const char* STRATEGY_NAME[S_COUNT] = {"none", "g1", "g3", "mgr"};
+
+struct Actions {
+  uint32_t rearms;
+  uint32_t reinits;
+  uint32_t teardowns;
+};
+
+struct Driver {
+  Strategy s;
+  uint32_t lastOkMs, lastSamMs, lastRecoverMs;
+  uint8_t  stableUid[4];
+  uint8_t  stableCount;
+  uint32_t lastUidMs;
+  uint64_t acceptUs;     // when the last tag was accepted (before any re-arm)
+  Actions  act;
+  RfidHealth h0;
+
+  void start(Strategy st) {
+    memset(this, 0, sizeof(*this));
+    s = st;
+    lastOkMs = lastSamMs = millis();
+    if(s == S_MGR) { Rfid_begin(); h0 = Rfid_health(); }
+  }
+
+  // the manager keeps its own counters
+  Actions actions() const {
+    if(s != S_MGR) return act;
+    const RfidHealth& h = Rfid_health();
+    Actions a;
+    a.rearms = (h.probes - h0.probes) + (h.rearms - h0.rearms);
+    a.reinits = h.reinits - h0.reinits;
+    a.teardowns = h.busClears - h0.busClears;
+    return a;
+  }
+
+  bool rawRead(uint8_t out[4], uint16_t timeout) {
+    uint8_t uid[7], len;
+    if(!nfc.readPassiveTargetID(PN532_MIFARE_ISO14443A, uid, &len, timeout)) return false;
+    if(len < 4) return false;
+    memcpy(out, uid, 4);
+    return true;
+  }
+
+  void g1Init() {
+    act.reinits++;
+    Wire.setClock(400000);
+    nfc.begin();
+    delay(30);
+    if(nfc.getFirmwareVersion()) { nfc.SAMConfig(); return; }
+    Wire.setClock(100000);
+    delay(30);
+    nfc.begin();
+    delay(30);
+    if(nfc.getFirmwareVersion()) nfc.SAMConfig();
+  }
+
+  void g3Recover() {
+    if(millis() - lastRecoverMs < 1200) return;
+    lastRecoverMs = millis();
+    act.teardowns++;
+    nfc.SAMConfig();
+    delay(10);
+    Wire.end();
+    delay(20);
+    Wire.begin();
+    Wire.setClock(100000);
+    Wire.setTimeOut(50);
+    delay(20);
+    nfc.begin();
+    delay(30);
+    nfc.getFirmwareVersion();
+    nfc.SAMConfig();
+    lastOkMs = millis();
+  }
+
+  bool g3Read(uint8_t out[4]) {
+    uint8_t uid[4];
+    if(!rawRead(uid, 40)) { stableCount = 0; return false; }
+    uint32_t now = millis();
+    if(stableCount == 0 || now - lastUidMs > 120 || memcmp(stableUid, uid, 4) != 0) {
+      memcpy(stableUid, uid, 4);
+      stableCount = 1;
+      lastUidMs = now;
+      return false;
+    }
+    lastUidMs = now;
+    if(++stableCount < 2) return false;
+    memcpy(out, stableUid, 4);
+    stableCount = 0;
+    lastOkMs = now;
+    return true;
+  }
+
+  // one pass of the game loop; true when a tag was accepted
+  bool poll(uint8_t uid[4]) {
+    bool ok = false;
+    switch(s) {
+      case S_NONE:
+        ok = rawRead(uid, 50);
+        if(ok) acceptUs = Sim_nowUs();
+        break;
+      case S_G1:
+        ok = rawRead(uid, 50);
+        if(ok) acceptUs = Sim_nowUs();
+        if(ok) { lastOkMs = millis(); nfc.SAMConfig(); lastSamMs = millis(); act.rearms++; }
+        if(millis() - lastSamMs > 2500) { nfc.SAMConfig(); lastSamMs = millis(); act.rearms++; }
+        if(millis() - lastOkMs > 6000) { g1Init(); lastOkMs = lastSamMs = millis(); }
+        break;
+      case S_G3:
+        if(millis() - lastOkMs > 2500) g3Recover();
+        ok = g3Read(uid);
+        if(ok) acceptUs = Sim_nowUs();
+        if(ok) { nfc.SAMConfig(); act.rearms++; }
+        break;
+      case S_MGR:
+        ok = Rfid_read(uid, 50);
+        if(ok) acceptUs = Sim_nowUs();
+        break;
+      default: break;
+    }
+    delay(2);
+    return ok;
+  }
+};
+
+// ---------------- helpers ----------------
+static void powerOn(uint32_t clockHz) {
+  Pn532Emu& chip = Pn532Emu_main();
+  chip.reset();
+  chip.clearScript();
+  Wire.end();
+  Wire.begin();
+  Wire.setClock(clockHz);
+  Wire.setTimeOut(50);
+  nfc.begin();
+  nfc.getFirmwareVersion();
+  nfc.SAMConfig();
+}
+
+struct Dist {
+  std::vector<double> v;
+  void add(double x) { v.push_back(x); }
+  double mean() const { double s = 0; for(size_t i=0;i<v.size();i++) s += v[i]; return v.empty() ? 0 : s / v.size(); }
+  double pct(double p) {
+    if(v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    size_t i = (size_t)(p * (v.size() - 1) + 0.5);
+    return v[i];
+  }
+};
+
+// ---------------- detect latency ----------------
+static void benchDetect(int trials) {
+  printf("\ntag-detect latency (tag lands at a random time, stays 600 ms)\n");
+  printf("%-6s %8s %8s %8s %8s %8s %6s %9s %8s\n",
+         "loop", "clock", "mean_ms", "p50_ms", "p99_ms", "max_ms", "miss", "txn/s", "bus%");
+
+  const uint32_t clocks[2] = {100000, 400000};
+  for(int s=0;s<S_COUNT;s++) {
+    for(int c=0;c<2;c++) {
+      if(s == S_MGR && c == 0) continue;   // negotiates its own clock (400k here)
+      Pn532Emu& chip = Pn532Emu_main();
+      powerOn(clocks[c]);
+      Driver d; d.start((Strategy)s);
+      Dist lat;
+      int miss = 0;
+      I2cEmu_resetStats();
+      uint64_t t0 = Sim_nowUs();
+
+      for(int t=0;t<trials;t++) {
+        uint64_t arrive = Sim_nowUs() + (uint64_t)rnd(300, 1300) * 1000;
+        const uint32_t holdUs = 600000;
+        chip.scriptTag(arrive, holdUs, TAG_UID, 4);
+        bool hit = false;
+        uint8_t uid[4];
+        while(Sim_nowUs() < arrive + holdUs) {
+          if(d.poll(uid) && d.acceptUs >= arrive) {
+            lat.add((d.acceptUs - arrive) / 1000.0);
+            hit = true;
+            break;
+          }
+        }
+        if(!hit) miss++;
+        // peg lifted; keep the loop running until the field is clear
+        while(Sim_nowUs() < arrive + holdUs + 50000) d.poll(uid);
+        // a g1 re-init leaves the bus at 400 kHz; keep each row at its own clock
+        Wire.setClock(clocks[c]);
+      }
+
+      double secs = (Sim_nowUs() - t0) / 1e6;
+      const I2cBusStats& bs = I2cEmu_stats();
+      printf("%-6s %7uk %8.1f %8.1f %8.1f %8.1f %6d %9.0f %7.1f%%\n",
+             STRATEGY_NAME[s], clocks[c] / 1000, lat.mean(), lat.pct(0.5), lat.pct(0.99), lat.pct(1.0),
+             miss, bs.txns / secs, 100.0 * bs.busNs / 1e9 / secs);
+    }
+  }
+}
+
+// ---------------- recovery ----------------
+enum Fault { F_NAK, F_WEDGE, F_BROWNOUT, F_HANG, F_COUNT };
+static const char* FAULT_NAME[F_COUNT] = {"nak-burst", "wedge", "brownout", "bus-hang"};
+
+static void inject(Fault f) {
+  Pn532Emu& chip = Pn532Emu_main();
+  switch(f) {
+    case F_NAK:      chip.nakNext(20); break;
+    case F_WEDGE:    chip.wedge(); break;
+    case F_BROWNOUT: chip.brownout(); break;
+    case F_HANG:     chip.hangBus(); break;
+    default: break;
+  }
+}
+
+static void benchRecover(int trials) {
+  const uint32_t giveUpMs = 30000;
+  printf("\nrecovery (fault injected, tag then sits on the antenna; time to next accepted read)\n");
+  printf("%-10s", "fault");
+  for(int s=0;s<S_COUNT;s++) printf(" %9s_mean %9s_max", STRATEGY_NAME[s], STRATEGY_NAME[s]);
+  printf("\n");
+
+  for(int f=0;f<F_COUNT;f++) {
+    printf("%-10s", FAULT_NAME[f]);
+    for(int s=0;s<S_COUNT;s++) {
+      Dist rec;
+      int stuck = 0;
+      for(int t=0;t<trials;t++) {
+        Pn532Emu& chip = Pn532Emu_main();
+        powerOn(100000);
+        Driver d; d.start((Strategy)s);
+        // a few idle passes so the fault lands at a random point of the loop
+        uint64_t at = Sim_nowUs() + (uint64_t)rnd(50, 400) * 1000;
+        uint8_t uid[4];
+        while(Sim_nowUs() < at) d.poll(uid);
+        inject((Fault)f);
+        uint64_t tf = Sim_nowUs();
+        chip.scriptTag(tf, giveUpMs * 1000, TAG_UID, 4);
+        bool ok = false;
+        while(Sim_nowUs() - tf < (uint64_t)giveUpMs * 1000) {
+          if(d.poll(uid)) { ok = true; break; }
+        }
+        if(ok) rec.add((d.acceptUs - tf) / 1000.0);
+        else stuck++;
+      }
+      if(stuck == trials) printf(" %14s %13s", "never", "-");
+      else if(stuck) printf(" %14.0f %9.0f(%d!)", rec.mean(), rec.pct(1.0), stuck);
+      else printf(" %14.0f %13.0f", rec.mean(), rec.pct(1.0));
+    }
+    printf("\n");
+  }
+}
+
+// ---------------- idle cost ----------------
+static void benchIdle() {
+  const uint32_t spanMs = 60000;
+  printf("\nidle watchdog cost (no tag for %u s)\n", spanMs / 1000);
+  printf("%-6s %8s %8s %10s %8s\n", "loop", "rearms", "reinits", "teardowns", "bus%");
+  for(int s=0;s<S_COUNT;s++) {
+    powerOn(100000);
+    Driver d; d.start((Strategy)s);
+    I2cEmu_resetStats();
+    uint64_t t0 = Sim_nowUs();
+    uint8_t uid[4];
+    while(Sim_nowUs() - t0 < (uint64_t)spanMs * 1000) d.poll(uid);
+    double secs = (Sim_nowUs() - t0) / 1e6;
+    Actions a = d.actions();
+    printf("%-6s %8u %8u %10u %7.1f%%\n", STRATEGY_NAME[s], a.rearms, a.reinits,
+           a.teardowns, 100.0 * I2cEmu_stats().busNs / 1e9 / secs);
+  }
+}
+
+// ---------------- clock ladder ----------------
+enum Wiring { W_CLEAN, W_200K, W_100K, W_DRIFT, W_COUNT };
+static const char* WIRING_NAME[W_COUNT] = {"clean", "200k", "100k", "drift"};
+
+static void setWiring(Wiring w, int trial, int trials) {
+  Pn532Emu& chip = Pn532Emu_main();
+  switch(w) {
+    case W_200K: chip.setMaxClock(200000, 0.3f); break;
+    case W_100K: chip.setMaxClock(100000, 0.3f); break;
+    case W_DRIFT:
+      // fine, then a bad connector for the middle third, then fine again
+      if(trial >= trials / 3 && trial < 2 * trials / 3) chip.setMaxClock(100000, 0.3f);
+      else chip.setMaxClock(0, 0);
+      break;
+    default: chip.setMaxClock(0, 0); break;
+  }
+}
+
+static bool benchProbe() { return nfc.getFirmwareVersion() != 0 && nfc.SAMConfig(); }
+
+struct LadderCounts { uint32_t busErrs, refused, rearms; };
+
+// one poll through the sketch's Nfc_list(): only bus failures reach the
+// ladder; an error frame means the RF side is not armed, so arm it
+static bool ladderRead(uint8_t out[4], LadderCounts& c) {
+  uint8_t uid[7], len;
+  NfcResult res = Nfc_list(uid, &len, 50);
+  if(res == NFC_ERROR) c.busErrs++;
+  if(res == NFC_REFUSED) {
+    c.refused++;
+    c.rearms++;
+    Nfc_arm();
+  }
+  if(res != NFC_TAG) return false;
+  memcpy(out, uid, 4);
+  return true;
+}
+
+static void benchLadder(int trials) {
+  printf("\nclock ladder (plain polling loop; wiring corrupts 30%% of transactions above its ceiling)\n");
+  printf("%-6s %-7s %9s %8s %6s %5s %8s %8s %7s %8s %8s %6s %8s\n",
+         "wiring", "clock", "start_k", "end_k", "downs", "ups", "up_fail",
+         "bus_err", "rearms", "mean_ms", "p99_ms", "miss", "bad_uid");
+
+  const char* modes[3] = {"400k", "100k", "ladder"};
+  for(int w=0;w<W_COUNT;w++) {
+    for(int m=0;m<3;m++) {
+      Pn532Emu& chip = Pn532Emu_main();
+      chip.reset();
+      chip.clearScript();
+      setWiring((Wiring)w, 0, trials);
+      Wire.end();
+      bool adaptive = (m == 2);
+      I2cBus_begin(-1, -1, benchProbe);
+      I2cBus_resetStats();
+      nfc.begin();
+      if(adaptive) {
+        I2cBus_negotiate();
+      } else {
+        I2cBus_pin(m == 0 ? 0 : I2C_RUNGS - 1);
+        nfc.getFirmwareVersion();
+      }
+      LadderCounts c = {0, 0, 0};
+      // the RF side must be armed before polling means anything
+      for(int k=0;k<20 && !Nfc_arm();k++) c.rearms++;
+      uint32_t startHz = Wire.getClock();
+
+      Dist lat;
+      int miss = 0;
+      uint32_t badUid = 0;
+      for(int t=0;t<trials;t++) {
+        setWiring((Wiring)w, t, trials);
+        uint64_t arrive = Sim_nowUs() + (uint64_t)rnd(300, 1300) * 1000;
+        const uint32_t holdUs = 600000;
+        chip.scriptTag(arrive, holdUs, TAG_UID, 4);
+        bool hit = false;
+        uint8_t uid[4];
+        while(Sim_nowUs() < arrive + holdUs) {
+          bool ok = ladderRead(uid, c);
+          uint64_t at = Sim_nowUs();
+          delay(2);
+          if(!ok) continue;
+          if(memcmp(uid, TAG_UID, 4) != 0) { badUid++; continue; }
+          if(at >= arrive) {
+            lat.add((at - arrive) / 1000.0);
+            hit = true;
+            break;
+          }
+        }
+        if(!hit) miss++;
+        while(Sim_nowUs() < arrive + holdUs + 50000) { uint8_t u[4]; ladderRead(u, c); delay(2); }
+      }
+
+      const I2cStats& bs = I2cBus_stats();
+      if(adaptive) {
+        printf("%-6s %-7s %8uk %7uk %6u %5u %8u", WIRING_NAME[w], modes[m], startHz / 1000,
+               Wire.getClock() / 1000, bs.downgrades, bs.upgrades, bs.failedUpgrades);
+      } else {
+        printf("%-6s %-7s %8uk %7uk %6s %5s %8s", WIRING_NAME[w], modes[m], startHz / 1000,
+               Wire.getClock() / 1000, "-", "-", "-");
+      }
+      printf(" %8u %7u %8.1f %8.1f %6d %8u\n", c.busErrs, c.rearms, lat.mean(), lat.pct(0.99), miss, badUid);
+    }
+  }
+}
+
+// ---------------- pair reads ----------------
+// Color Match: time from the first peg of a pair landing until both UIDs
+// have been read, through the manager. One-handed the second peg follows
+// the first after a lift and a reaction time; two-handed both land at once.
+static const uint8_t MATE_UID[4] = {0x0B, 0xAD, 0xF0, 0x0D};
+
+static void benchPair(int trials) {
+  printf("\npair read (first peg lands .. both UIDs read; one-handed: 300 ms rest, 650 ms to the second)\n");
+  printf("%-10s %6s %8s %8s %8s %6s\n", "placement", "max_tg", "mean_ms", "p50_ms", "p99_ms", "miss");
+
+  struct Row { const char* name; bool together; uint8_t maxTg; };
+  const Row rows[3] = { {"one-hand", false, 1}, {"two-hand", true, 1}, {"two-hand", true, 2} };
+  for(int r=0;r<3;r++) {
+    Pn532Emu& chip = Pn532Emu_main();
+    powerOn(400000);
+    Rfid_begin();
+    Dist lat;
+    int miss = 0;
+    for(int t=0;t<trials;t++) {
+      uint64_t a = Sim_nowUs() + (uint64_t)rnd(300, 1300) * 1000;
+      uint64_t b = rows[r].together ? a : a + 300000 + 650000;
+      const uint32_t holdUs = 600000;
+      chip.scriptTag(a, rows[r].together ? holdUs : 300000, TAG_UID, 4);
+      chip.scriptTag(b, holdUs, MATE_UID, 4);
+      bool gotA = false, gotB = false;
+      while(Sim_nowUs() < b + holdUs && !(gotA && gotB)) {
+        uint8_t uids[NFC_MAX_TARGETS][4];
+        int8_t n;
+        if(rows[r].maxTg == 1) n = Rfid_read(uids[0], 40) ? 1 : 0;
+        else n = Rfid_readPegs(uids, rows[r].maxTg, 40);
+        for(int i=0;i<n;i++) {
+          if(!memcmp(uids[i], TAG_UID, 4)) gotA = true;
+          if(!memcmp(uids[i], MATE_UID, 4)) gotB = true;
+        }
+        delay(2);
+      }
+      if(gotA && gotB) lat.add((Sim_nowUs() - a) / 1000.0);
+      else miss++;
+      while(Sim_nowUs() < b + holdUs + 50000) delay(10);
+    }
+    printf("%-10s %6u %8.1f %8.1f %8.1f %6d\n", rows[r].name, rows[r].maxTg,
+           lat.mean(), lat.pct(0.5), lat.pct(0.99), miss);
+  }
+}
+
+// ---------------- several readers ----------------
+static const uint8_t BOARD_ZONES[16] = {0,2,4,6,9,11,13,15,16,18,20,22,25,27,29,31};
+
+static void benchReaders(int trials) {
+  printf("\nreaders behind a mux (16 zones split evenly; tag lands on a random zone, stays 600 ms)\n");
+  printf("%-8s %-7s %6s %8s %8s %8s %6s %8s %8s\n",
+         "readers", "scan", "zones", "mean_ms", "p50_ms", "p99_ms", "miss", "switch/s", "bus%");
+
+  I2cEmu_detach(Pn532Emu::ADDR);
+  TcaMuxEmu* mux = new TcaMuxEmu();
+  const uint8_t counts[3] = {1, 2, 4};
+  for(int c=0;c<3;c++) {
+    uint8_t n = counts[c];
+    Pn532Emu* chip[RFID_MAX_READERS];
+    RfidReaderCfg cfg[RFID_MAX_READERS];
+    mux->detachAll();
+    for(uint8_t i=0;i<n;i++) {
+      chip[i] = new Pn532Emu(Pn532Emu::ADDR, false);
+      chip[i]->useWorld(false);
+      mux->attach(i, Pn532Emu::ADDR, chip[i]);
+      cfg[i].muxChannel = i;
+      cfg[i].firstLed = BOARD_ZONES[i * 16 / n];
+      cfg[i].lastLed = BOARD_ZONES[(i + 1) * 16 / n - 1];
+    }
+
+    for(int m=0;m<2;m++) {
+      if(m == 1 && n == 1) continue;
+      Rfid_setReaders(cfg, n, m ? RFID_SCAN_CONCURRENT : RFID_SCAN_ROUND_ROBIN);
+      for(uint8_t i=0;i<n;i++) { chip[i]->reset(); chip[i]->clearScript(); }
+      Rfid_begin();
+      Dist lat;
+      int miss = 0;
+      I2cEmu_resetStats();
+      mux->resetStats();
+      uint64_t t0 = Sim_nowUs();
+      for(int t=0;t<trials;t++) {
+        uint8_t led = BOARD_ZONES[rnd(0, 15)];
+        Pn532Emu* on = chip[Rfid_readerForLed(led)];
+        uint64_t arrive = Sim_nowUs() + (uint64_t)rnd(300, 1300) * 1000;
+        const uint32_t holdUs = 600000;
+        on->scriptTag(arrive, holdUs, TAG_UID, 4);
+        bool hit = false;
+        uint8_t uid[4];
+        while(Sim_nowUs() < arrive + holdUs) {
+          bool ok = Rfid_read(uid, 40);
+          uint64_t at = Sim_nowUs();
+          delay(2);
+          if(ok && at >= arrive) {
+            lat.add((at - arrive) / 1000.0);
+            hit = true;
+            break;
+          }
+        }
+        if(!hit) miss++;
+        while(Sim_nowUs() < arrive + holdUs + 50000) { Rfid_read(uid, 40); delay(2); }
+      }
+      double secs = (Sim_nowUs() - t0) / 1e6;
+      printf("%-8u %-7s %6d %8.1f %8.1f %8.1f %6d %8.0f %7.1f%%\n", n, m ? "conc" : "rr", 16 / n,
+             lat.mean(), lat.pct(0.5), lat.pct(0.99), miss, mux->stats().switches / secs,
+             100.0 * I2cEmu_stats().busNs / 1e9 / secs);
+    }
+    mux->detachAll();
+    for(uint8_t i=0;i<n;i++) delete chip[i];
+  }
+  delete mux;
+  I2cEmu_attach(Pn532Emu::ADDR, &Pn532Emu_main());
+  Rfid_setReaders(nullptr, 0, RFID_SCAN_ROUND_ROBIN);
+}
+
+static void usage() {
+  printf("usage: rehab_pn532 [--trials N] [--seed N]\n"
+         "  --trials N   tag arrivals / fault injections per cell (200 / N/10)\n"
+         "  --seed N     arrival jitter seed (1)\n");
+}
+
+int main(int argc, char** argv) {
+  int trials = 200;
+  for(int i=1;i<argc;i++){
+    const char* v = (i + 1 < argc) ? argv[i+1] : nullptr;
+    if(!v) { usage(); return 2; }
+    if(!strcmp(argv[i], "--trials"))    trials = atoi(v);
+    else if(!strcmp(argv[i], "--seed")) g_rng = (uint32_t)strtoul(v, nullptr, 10);
+    else { usage(); return 2; }
+    i++;
+  }
+  if(trials < 10) trials = 10;
+
+  Pn532Emu_main().useWorld(false);
+  benchDetect(trials);
+  benchRecover(trials / 10);
+  benchIdle();
+  benchLadder(trials);
+  benchPair(trials);
+  benchReaders(trials);
+  return 0;
+}
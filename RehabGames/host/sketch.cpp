@@ -0,0 +1,2 @@
+// sketch.cpp – the real RehabGames_All.ino, compiled as a host translation unit
+#include "../RehabGames_All.ino"
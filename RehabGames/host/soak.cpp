@@ -0,0 +1,216 @@
+// soak.cpp – headless multi-hour soak run of RehabGames on the host
+//
+// Drives setup()/loop() with a virtual patient for N peg responses and
+// reports, per window: virtual time, heap live/peak, allocation count and
+// the wall-clock cost of loop(). Exits non-zero on a stuck UI or heap growth.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "HostSim.h"
+#include "Patient.h"
+#include "I2cBus.h"
+#include "Rfid.h"
+#include "MemMon.h"
+#include "Log.h"
+#include "Leds.h"
+#include "Render.h"
+
+void setup();
+void loop();
+
+struct Options {
+  uint64_t rounds      = 20000;
+  uint64_t reportEvery = 2000;
+  uint64_t leakBytes   = 4096;
+  uint32_t stuckMin    = 20;     // virtual minutes without patient progress
+  uint32_t renderLag   = 1;      // loop passes per render queue drain
+  bool     verbose     = false;
+  PatientConfig patient;
+};
+
+static void usage() {
+  printf("usage: rehab_soak [options]\n"
+         "  --rounds N         peg responses to simulate (20000)\n"
+         "  --report-every N   responses per report window (2000)\n"
+         "  --seed N           patient seed (1)\n"
+         "  --rt-mean MS       peg reaction time mean (650)\n"
+         "  --rt-sd MS         peg reaction time std dev (220)\n"
+         "  --error-rate P     wrong peg probability (0.08)\n"
+         "  --lift MIN:MAX     peg rest time on antenna, ms (150:450)\n"
+         "  --mistap-rate P    taps near button edges (0.10)\n"
+         "  --pair-rate P      Color Match pairs placed two-handed (0.5)\n"
+         "  --leak-bytes N     fail if live heap grows more than N (4096)\n"
+         "  --render-lag N     drain the render queue every N loop passes (1)\n"
+         "  --verbose          echo sketch Serial output\n");
+}
+
+static bool parseArgs(int argc, char** argv, Options& o) {
+  for(int i=1;i<argc;i++){
+    const char* a = argv[i];
+    const char* v = (i + 1 < argc) ? argv[i+1] : nullptr;
+    if(!strcmp(a, "--verbose")) { o.verbose = true; continue; }
+    if(!v) { usage(); return false; }
+    if(!strcmp(a, "--rounds"))            o.rounds = strtoull(v, nullptr, 10);
+    else if(!strcmp(a, "--report-every")) o.reportEvery = strtoull(v, nullptr, 10);
+    else if(!strcmp(a, "--seed"))         o.patient.seed = (uint32_t)strtoul(v, nullptr, 10);
+    else if(!strcmp(a, "--rt-mean"))      o.patient.rtMeanMs = strtof(v, nullptr);
+    else if(!strcmp(a, "--rt-sd"))        o.patient.rtSdMs = strtof(v, nullptr);
+    else if(!strcmp(a, "--error-rate"))   o.patient.errorRate = strtof(v, nullptr);
+    else if(!strcmp(a, "--mistap-rate"))  o.patient.mistapRate = strtof(v, nullptr);
+    else if(!strcmp(a, "--pair-rate"))    o.patient.pairRate = strtof(v, nullptr);
+    else if(!strcmp(a, "--leak-bytes"))   o.leakBytes = strtoull(v, nullptr, 10);
+    else if(!strcmp(a, "--render-lag"))   o.renderLag = (uint32_t)strtoul(v, nullptr, 10);
+    else if(!strcmp(a, "--lift")) {
+      if(sscanf(v, "%u:%u", &o.patient.liftMinMs, &o.patient.liftMaxMs) != 2) { usage(); return false; }
+    }
+    else { usage(); return false; }
+    i++;
+  }
+  if(o.reportEvery == 0) o.reportEvery = 1;
+  return true;
+}
+
+// wall-clock cost of loop(), log2 buckets in ns for a cheap p99
+struct LatencyWindow {
+  uint64_t n = 0, sumNs = 0, maxNs = 0;
+  uint64_t buckets[40] = {0};
+
+  void add(uint64_t ns) {
+    n++; sumNs += ns;
+    if(ns > maxNs) maxNs = ns;
+    int b = 0;
+    while(b < 39 && (1ull << (b + 1)) <= ns) b++;
+    buckets[b]++;
+  }
+  double meanUs() const { return n ? (double)sumNs / n / 1000.0 : 0; }
+  double p99Us() const {
+    uint64_t want = n - n / 100, acc = 0;
+    for(int b=0;b<40;b++){ acc += buckets[b]; if(acc >= want) return (double)(1ull << (b + 1)) / 1000.0; }
+    return 0;
+  }
+};
+
+static void dumpScreen() {
+  fprintf(stderr, "visible labels:\n");
+  for(int i=0;i<Sim_labelCount();i++){
+    const SimLabel& l = Sim_label(i);
+    fprintf(stderr, "  '%s' @%d,%d %dx%d\n", l.text, l.x, l.y, l.w, l.h);
+  }
+}
+
+int main(int argc, char** argv) {
+  Options opt;
+  if(!parseArgs(argc, argv, opt)) return 2;
+
+  Patient patient(opt.patient);
+  Sim_setWorld(&patient);
+  Sim_serialEcho(opt.verbose);
+
+  Sim_heapTrack(true);
+  setup();
+  Sim_heapTrack(false);
+  Render_setLag((uint8_t)(opt.renderLag > 255 ? 255 : opt.renderLag));
+
+  printf("%10s %10s %10s %8s %10s %10s %10s %10s %10s\n",
+         "responses", "virt_h", "loops", "allocs", "live_B", "peak_B", "mean_us", "p99_us", "max_us");
+
+  LatencyWindow win, first;
+  bool haveFirst = false;
+  uint64_t loops = 0, nextReport = opt.reportEvery;
+  SimHeapStats prev, cur, base;
+  Sim_heapStats(prev);
+  base = prev;
+  bool haveBase = false;
+
+  while(patient.stats().responses < opt.rounds) {
+    auto t0 = std::chrono::steady_clock::now();
+    Sim_heapTrack(true);
+    loop();
+    Sim_heapTrack(false);
+    auto t1 = std::chrono::steady_clock::now();
+    win.add((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    loops++;
+
+    if(Sim_nowUs() - patient.lastProgressUs() > (uint64_t)opt.stuckMin * 60 * 1000000) {
+      fprintf(stderr, "STUCK: no patient progress for %u virtual minutes\n", opt.stuckMin);
+      dumpScreen();
+      return 3;
+    }
+
+    if(patient.stats().responses >= nextReport) {
+      nextReport += opt.reportEvery;
+      Sim_heapStats(cur);
+      printf("%10llu %10.2f %10llu %8llu %10llu %10llu %10.2f %10.2f %10.2f\n",
+             (unsigned long long)patient.stats().responses,
+             Sim_nowUs() / 3.6e9,
+             (unsigned long long)loops,
+             (unsigned long long)(cur.allocs - prev.allocs),
+             (unsigned long long)cur.bytesLive,
+             (unsigned long long)cur.bytesPeak,
+             win.meanUs(), win.p99Us(), win.maxNs / 1000.0);
+      fflush(stdout);
+      prev = cur;
+      if(!haveBase) { base = cur; haveBase = true; }
+      if(!haveFirst) { first = win; haveFirst = true; }
+      win = LatencyWindow();
+    }
+  }
+
+  Sim_heapStats(cur);
+  const PatientStats& ps = patient.stats();
+  printf("\nsessions: follow=%llu sequence=%llu match=%llu  taps=%llu (mistaps %llu)  wrong pegs=%llu\n",
+         (unsigned long long)ps.sessions[0], (unsigned long long)ps.sessions[1],
+         (unsigned long long)ps.sessions[2], (unsigned long long)ps.taps,
+         (unsigned long long)ps.mistaps, (unsigned long long)ps.wrongPegs);
+  printf("heap: %llu allocs, %llu frees, live %llu B, peak %llu B\n",
+         (unsigned long long)cur.allocs, (unsigned long long)cur.frees,
+         (unsigned long long)cur.bytesLive, (unsigned long long)cur.bytesPeak);
+
+  const I2cStats& is = I2cBus_stats();
+  printf("i2c: %u kHz, %u down / %u up (%u failed), %u bus clears\n", I2cBus_clockHz() / 1000,
+         is.downgrades, is.upgrades, is.failedUpgrades, is.busClears);
+  for(int o=0;o<I2C_OP_COUNT;o++){
+    const I2cOpStats& s = is.op[o];
+    printf("  %-6s %8u txns %6u err  mean %6.0f us  max %6u us\n", I2cBus_opName((I2cOp)o),
+           s.count, s.errors, s.count ? (double)s.usSum / s.count : 0.0, s.usMax);
+  }
+  const RfidHealth& rh = Rfid_health();
+  printf("rfid: %u reads, %u poll errors, %u probes, recovery %u/%u/%u (rearm/clear/init), "
+         "%u outages, worst %u ms\n", rh.reads, rh.pollErrors, rh.probes, rh.rearms, rh.busClears,
+         rh.reinits, rh.outages, rh.worstOutageMs);
+
+  const MemSample& ms = MemMon_last();
+  printf("mem: free %u B (min %u B), %u slots, %u warnings\n", ms.freeHeap, ms.minFreeHeap,
+         MemMon_slotCount(), MemMon_warnCount());
+  const LogStats& ls = Log_stats();
+  printf("log: %u records, %u dropped, %u B drained, ring max %u B\n", ls.records, ls.dropped,
+         ls.bytes, ls.maxFill);
+  // strip time as HostStubs charges it: latch + 30 us per LED
+  const RenderStats& rs = Render_stats();
+  printf("render: %u posted, %u drawn, %u coalesced, %u inline, max depth %u, %u full waits\n",
+         rs.posted, rs.drawn, rs.coalesced, rs.inlined, rs.maxDepth, rs.fullWaits);
+  const LedStats& es = Leds_stats();
+  uint32_t saved = es.unchanged + es.coalesced;
+  printf("leds: %u shows, %u pushed (%.1f px each, %u chain transfers), %u unchanged, %u coalesced, "
+         "%.0f ms of strip time saved\n",
+         es.shows, es.pushes, es.pushes ? (double)es.pixels / es.pushes : 0.0, es.chains, es.unchanged, es.coalesced,
+         saved * (50.0 + 30.0 * LED_COUNT) / 1000.0);
+  printf("led power: %u pushes limited to %u mA, peak asked %u mA\n", es.limited, (unsigned)LED_BUDGET_MA, es.peakMa);
+  if(opt.verbose) {
+    Sim_serialInput("mem\nrt\n");   // the console commands, as typed
+    loop();
+  }
+
+  int rc = 0;
+  if(haveBase && cur.bytesLive > base.bytesLive + opt.leakBytes) {
+    printf("LEAK: live heap grew %llu B since the first window\n",
+           (unsigned long long)(cur.bytesLive - base.bytesLive));
+    rc = 1;
+  }
+  if(haveFirst && win.n && win.meanUs() > first.meanUs() * 2.0) {
+    printf("DRIFT: loop() mean cost %.2f us vs %.2f us in the first window\n",
+           win.meanUs(), first.meanUs());
+  }
+  return rc;
+}
@@ -0,0 +1,371 @@
+// touch_eval.cpp – replays raw XPT2046 traces through touch filter configs
+//
+// A trace is what the touch controller would convert at any instant: a step
+// function of raw (x, y, z) samples, plus the presses that really happened.
+// Each candidate is polled the way the sketch polls (one poll per loop pass,
+// --poll-ms apart; a poll is a burst of conversions, 60 us each) and scored:
+//   latency   finger down -> first poll that reports the press
+//   missed    presses never reported
+//   repeats   a press reported more than once: a long press repeating,
+//             or a poll losing it and finding it again (a double tap)
+//   ghosts    presses reported while nobody touched, per minute untouched
+//   error     reported point vs the real one, in screen pixels
+//   conv      conversions per poll (bus time, loop time)
+// "legacy" is the reader this filter replaced: 6 conversions 2 ms apart,
+// the one with the highest pressure, Z_MIN..Z_MAX, level-triggered; the
+// sketch dropped its reports closer than LEGACY_GAP_US, which is all that
+// kept a held finger from tapping again. Every report counts.
+//
+// Trace file (text, one record per line, '#' comments):
+//   S <t_us> <x> <y> <z>        conversion result from t_us on
+//   P <t0_us> <t1_us> <x> <y>   finger down from t0 to t1 at raw x, y
+// Without --trace a synthetic trace is generated: contact ramps of 1-6 ms
+// with position error growing as pressure falls, 1 % spikes during a
+// press, and EMI ghosts (z in range for 50 us .. 3 ms) between presses.
+// --write FILE saves it in the format above.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include "TouchFilter.h"
+
+// ../Shared.cpp calibration, for errors in pixels
+static const int CAL_X_MIN = 350, CAL_X_MAX = 3800;
+static const int CAL_Y_MIN = 300, CAL_Y_MAX = 3800;
+
+static const uint32_t CONV_US   = 60;      // 3 conversions @ 2 MHz SPI
+static const uint32_t STEP_US   = 50;      // synthetic trace resolution
+static const uint32_t GRACE_US  = 20000;   // a report this late after lift still counts
+static const uint32_t LEGACY_GAP_US = 220000;
+
+struct Sample { uint32_t t; int16_t x, y, z; };
+struct Press  { uint32_t t0, t1; int16_t x, y; };
+
+struct Trace {
+  std::vector<Sample> s;
+  std::vector<Press>  p;
+  uint32_t endUs = 0;
+
+  TouchSample at(uint32_t t) const {
+    size_t lo = 0, hi = s.size();
+    while(hi - lo > 1) {
+      size_t mid = (lo + hi) / 2;
+      if(s[mid].t <= t) lo = mid; else hi = mid;
+    }
+    TouchSample r = { s[lo].x, s[lo].y, s[lo].z };
+    return r;
+  }
+};
+
+static uint32_t g_rng = 1;
+static uint32_t rnd() {
+  g_rng ^= g_rng << 13; g_rng ^= g_rng >> 17; g_rng ^= g_rng << 5;
+  return g_rng;
+}
+static int32_t  uni(int32_t lo, int32_t hi) { return lo + (int32_t)(rnd() % (uint32_t)(hi - lo + 1)); }
+static float    unif() { return (rnd() >> 8) / 16777216.0f; }
+static float    gauss() {
+  float u = unif() + 1e-7f, v = unif();
+  return sqrtf(-2.0f * logf(u)) * cosf(6.2831853f * v);
+}
+static int16_t  clamp12(float v) { return (int16_t)(v < 0 ? 0 : v > 4095 ? 4095 : v); }
+
+// ---------------- synthetic trace ----------------
+struct SynthCfg {
+  uint32_t seconds = 600;
+  float    tapsPerMin = 40;
+  float    ghostsPerMin = 30;
+};
+
+static void idleSample(Trace& tr, uint32_t t) {
+  Sample s = { t, (int16_t)uni(0, 4095), (int16_t)uni(0, 4095), (int16_t)uni(0, 30) };
+  tr.s.push_back(s);
+}
+
+static void synthGhost(Trace& tr, uint32_t& t) {
+  // most EMI blips are one conversion long; one in five lasts milliseconds
+  uint32_t len = unif() < 0.8f ? uni(50, 400) : uni(1000, 3000);
+  int16_t x = (int16_t)uni(0, 4095), y = (int16_t)uni(0, 4095);
+  for(uint32_t e = t + len; t < e; t += STEP_US) {
+    Sample s = { t, (int16_t)(x + uni(-40, 40)), (int16_t)(y + uni(-40, 40)), (int16_t)uni(250, 3000) };
+    tr.s.push_back(s);
+  }
+}
+
+static void synthPress(Trace& tr, uint32_t& t) {
+  Press p;
+  p.t0 = t;
+  p.t1 = t + uni(60, 350) * 1000;
+  p.x = (int16_t)uni(CAL_X_MIN, CAL_X_MAX);
+  p.y = (int16_t)uni(CAL_Y_MIN, CAL_Y_MAX);
+  tr.p.push_back(p);
+
+  float zn = (float)uni(600, 1600);
+  uint32_t rampIn = uni(1000, 6000), rampOut = uni(1000, 3000);
+  for(; t < p.t1; t += STEP_US) {
+    uint32_t in = t - p.t0, out = p.t1 - t;
+    float k = 1.0f;
+    if(in < rampIn)   k = (float)in / rampIn;
+    if(out < rampOut) k = std::min(k, (float)out / rampOut);
+    float z = zn * k + gauss() * 20.0f;
+    // a light contact reads off towards the panel's middle and noisy
+    float sd = 5.0f + 400.0f * (1.0f - k) * (1.0f - k);
+    float x = p.x + (2048 - p.x) * 0.3f * (1.0f - k) + gauss() * sd;
+    float y = p.y + (2048 - p.y) * 0.3f * (1.0f - k) + gauss() * sd;
+    if(unif() < 0.01f) {
+      if(unif() < 0.5f) x += (unif() < 0.5f ? -1 : 1) * uni(300, 900);
+      else              y += (unif() < 0.5f ? -1 : 1) * uni(300, 900);
+    }
+    Sample s = { t, clamp12(x), clamp12(y), clamp12(z) };
+    tr.s.push_back(s);
+  }
+}
+
+static void synthesize(Trace& tr, const SynthCfg& c) {
+  uint64_t end = (uint64_t)c.seconds * 1000000;
+  uint32_t t = 0;
+  float pressP = c.tapsPerMin / 60e6f * STEP_US;
+  float ghostP = c.ghostsPerMin / 60e6f * STEP_US;
+  while(t < end) {
+    float r = unif();
+    if(r < pressP)               synthPress(tr, t);
+    else if(r < pressP + ghostP) synthGhost(tr, t);
+    else { idleSample(tr, t); t += STEP_US; continue; }
+    // a finger that just lifted does not land again at once
+    for(uint32_t e = t + 30000; t < e; t += STEP_US) idleSample(tr, t);
+  }
+  tr.endUs = tr.s.back().t;             // as loadTrace() sees it
+}
+
+// ---------------- trace files ----------------
+static bool loadTrace(Trace& tr, const char* path) {
+  FILE* f = fopen(path, "r");
+  if(!f) return false;
+  char line[128];
+  while(fgets(line, sizeof(line), f)) {
+    unsigned long a, b; int x, y, z;
+    if(line[0] == 'S' && sscanf(line + 1, "%lu %d %d %d", &a, &x, &y, &z) == 4) {
+      Sample s = { (uint32_t)a, (int16_t)x, (int16_t)y, (int16_t)z };
+      tr.s.push_back(s);
+      if(s.t > tr.endUs) tr.endUs = s.t;
+    } else if(line[0] == 'P' && sscanf(line + 1, "%lu %lu %d %d", &a, &b, &x, &y) == 4) {
+      Press p = { (uint32_t)a, (uint32_t)b, (int16_t)x, (int16_t)y };
+      tr.p.push_back(p);
+    }
+  }
+  fclose(f);
+  std::sort(tr.s.begin(), tr.s.end(), [](const Sample& l, const Sample& r) { return l.t < r.t; });
+  std::sort(tr.p.begin(), tr.p.end(), [](const Press& l, const Press& r) { return l.t0 < r.t0; });
+  return !tr.s.empty();
+}
+
+static bool writeTrace(const Trace& tr, const char* path) {
+  FILE* f = fopen(path, "w");
+  if(!f) return false;
+  fprintf(f, "# rehab touch trace: S t_us x y z / P t0_us t1_us x y\n");
+  for(const Press& p : tr.p) fprintf(f, "P %u %u %d %d\n", p.t0, p.t1, p.x, p.y);
+  int16_t lx = -1, ly = -1, lz = -1;
+  for(const Sample& s : tr.s) {
+    // repeats add nothing to a step function, but the last one marks the end
+    if(s.x == lx && s.y == ly && s.z == lz && &s != &tr.s.back()) continue;
+    fprintf(f, "S %u %d %d %d\n", s.t, s.x, s.y, s.z);
+    lx = s.x; ly = s.y; lz = s.z;
+  }
+  fclose(f);
+  return true;
+}
+
+// ---------------- candidates ----------------
+struct Candidate {
+  const char*    name;
+  bool           legacy;
+  TouchFilterCfg cfg;
+};
+
+//                               median        press iir jitter burst gap_us
+static const Candidate CANDIDATES[] = {
+  {"legacy",             true,  {1, Z_MIN, Z_MAX, 1, 0, 0,  6, 2000}},
+  {"gate",               false, {1, Z_MIN, Z_MAX, 1, 0, 0,  1,    0}},
+  {"med3",               false, {3, Z_MIN, Z_MAX, 1, 0, 0,  3,  300}},
+  {"gate+press2",        false, {1, Z_MIN, Z_MAX, 2, 0, 0,  4,  300}},
+  {"med3+press2",        false, {3, Z_MIN, Z_MAX, 2, 0, 0,  6,  300}},
+  {"med3+press2+iir1",   false, {3, Z_MIN, Z_MAX, 2, 1, 0,  6,  300}},
+  {"med5+press2",        false, {5, Z_MIN, Z_MAX, 2, 0, 0,  8,  300}},
+  {"med3+press2/1ms",    false, {3, Z_MIN, Z_MAX, 2, 0, 0,  6, 1000}},
+  {"med3+press3/1ms",    false, {3, Z_MIN, Z_MAX, 3, 0, 0,  6, 1000}},
+  {"med3+press3/1ms+iir1", false, {3, Z_MIN, Z_MAX, 3, 1, 0, 6, 1000}},
+  {"med3+press4/1ms+iir1", false, {3, Z_MIN, Z_MAX, 4, 1, 0, 8, 1000}},
+  {"med3+press3/1ms+iir2+jit8", false, {3, Z_MIN, Z_MAX, 3, 2, 8, 6, 1000}},
+  {"build",              false, TOUCH_FILTER_BUILD},
+};
+
+struct Result {
+  uint32_t detected = 0, missed = 0, repeats = 0, ghosts = 0;
+  std::vector<float> latMs, errPx;
+  uint64_t polls = 0, convs = 0;
+  float idleMin = 0;
+};
+
+struct ReadCtx {
+  const Trace* tr;
+  uint32_t t;           // bus time so far in this poll
+  uint16_t gapUs;
+};
+
+static TouchSample readTrace(void* p, uint8_t i) {
+  ReadCtx& c = *(ReadCtx*)p;
+  if(i) c.t += c.gapUs;
+  TouchSample s = c.tr->at(c.t);
+  c.t += CONV_US;
+  return s;
+}
+
+// the legacy reader: highest pressure of 6, 2 ms apart
+static bool legacyPoll(ReadCtx& c, TouchSample& out) {
+  TouchSample best = {0, 0, 0};
+  for(int i=0;i<6;i++){
+    TouchSample s = c.tr->at(c.t);
+    c.t += CONV_US;
+    if(s.z > best.z) best = s;
+    c.t += 2000;
+  }
+  if(best.z < Z_MIN || best.z > Z_MAX) return false;
+  out = best;
+  return true;
+}
+
+static float pxError(const TouchSample& s, const Press& p) {
+  float dx = (float)(s.x - p.x) * (SCREEN_W - 1) / (CAL_X_MAX - CAL_X_MIN);
+  float dy = (float)(s.y - p.y) * (SCREEN_H - 1) / (CAL_Y_MAX - CAL_Y_MIN);
+  return sqrtf(dx * dx + dy * dy);
+}
+
+static Result evaluate(const Trace& tr, const Candidate& cand, uint32_t pollUs) {
+  Result r;
+  TouchFilter f;
+  TouchFilter_init(f, cand.cfg);
+  std::vector<bool> seen(tr.p.size(), false);
+  size_t pi = 0;
+  bool reported = false;
+  uint32_t lastReport = 0;
+  uint32_t t = uni(0, pollUs);
+
+  while(t < tr.endUs) {
+    ReadCtx c = { &tr, t, f.cfg.gapUs };
+    TouchSample s;
+    bool pressed;
+    uint8_t used = 6;
+    if(cand.legacy) pressed = legacyPoll(c, s);
+    else            pressed = TouchFilter_poll(f, readTrace, &c, s, &used);
+    r.polls++;
+    r.convs += used;
+
+    if(cand.legacy && pressed && reported && c.t - lastReport < LEGACY_GAP_US) pressed = false;
+    if(pressed) {
+      reported = true;
+      lastReport = c.t;
+      while(pi < tr.p.size() && tr.p[pi].t1 + GRACE_US < c.t) pi++;
+      if(pi < tr.p.size() && tr.p[pi].t0 <= c.t) {
+        if(seen[pi]) r.repeats++;
+        else {
+          seen[pi] = true;
+          r.detected++;
+          r.latMs.push_back((c.t - tr.p[pi].t0) / 1000.0f);
+          r.errPx.push_back(pxError(s, tr.p[pi]));
+        }
+      } else {
+        r.ghosts++;
+      }
+    }
+    // the next loop pass; the poll's own time pushes it back
+    t = c.t + pollUs - (uint32_t)uni(0, pollUs / 5);
+  }
+
+  uint64_t touchedUs = 0;
+  for(size_t i=0;i<tr.p.size();i++){
+    if(!seen[i]) r.missed++;
+    touchedUs += tr.p[i].t1 - tr.p[i].t0;
+  }
+  r.idleMin = (tr.endUs - touchedUs) / 60e6f;
+  return r;
+}
+
+static float mean(const std::vector<float>& v) {
+  if(v.empty()) return 0;
+  double s = 0;
+  for(float x : v) s += x;
+  return (float)(s / v.size());
+}
+
+static float pct(std::vector<float> v, float q) {
+  if(v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  return v[(size_t)(q * (v.size() - 1) + 0.5f)];
+}
+
+static void usage() {
+  printf("usage: rehab_touch_eval [--trace FILE] [--write FILE] [--seconds N]\n"
+         "                        [--taps N] [--ghosts N] [--poll-ms N] [--seed N]\n"
+         "  --trace FILE  replay a recorded trace instead of a synthetic one\n"
+         "  --write FILE  save the synthetic trace\n"
+         "  --seconds N   synthetic trace length (600)\n"
+         "  --taps N      presses per minute (40)\n"
+         "  --ghosts N    EMI ghosts per minute (30)\n"
+         "  --poll-ms N   loop pass period (10)\n"
+         "  --seed N      synthetic trace / poll phase seed (1)\n");
+}
+
+int main(int argc, char** argv) {
+  SynthCfg sc;
+  const char* tracePath = nullptr;
+  const char* writePath = nullptr;
+  uint32_t pollMs = 10;
+  for(int i=1;i<argc;i++){
+    const char* v = (i + 1 < argc) ? argv[i+1] : nullptr;
+    if(!v) { usage(); return 2; }
+    if(!strcmp(argv[i], "--trace"))        tracePath = v;
+    else if(!strcmp(argv[i], "--write"))   writePath = v;
+    else if(!strcmp(argv[i], "--seconds")) sc.seconds = (uint32_t)atoi(v);
+    else if(!strcmp(argv[i], "--taps"))    sc.tapsPerMin = (float)atof(v);
+    else if(!strcmp(argv[i], "--ghosts"))  sc.ghostsPerMin = (float)atof(v);
+    else if(!strcmp(argv[i], "--poll-ms")) pollMs = (uint32_t)atoi(v);
+    else if(!strcmp(argv[i], "--seed"))    g_rng = (uint32_t)strtoul(v, nullptr, 10);
+    else { usage(); return 2; }
+    i++;
+  }
+  if(pollMs < 1) pollMs = 1;
+  if(!g_rng) g_rng = 1;                 // xorshift state must not be 0
+  uint32_t phaseSeed = g_rng;           // poll times do not depend on where the trace came from
+
+  Trace tr;
+  if(tracePath) {
+    if(!loadTrace(tr, tracePath)) { printf("cannot read %s\n", tracePath); return 2; }
+  } else {
+    synthesize(tr, sc);
+  }
+  if(writePath && !writeTrace(tr, writePath)) { printf("cannot write %s\n", writePath); return 2; }
+
+  printf("trace: %.1f s, %zu presses, %zu samples, poll every %u ms\n\n",
+         tr.endUs / 1e6, tr.p.size(), tr.s.size(), pollMs);
+  printf("%-26s %6s %6s %7s %9s  %8s %8s  %8s %8s  %5s\n", "filter", "found", "missed", "repeats",
+         "ghost/min", "lat_mean", "lat_p90", "err_mean", "err_p90", "conv");
+
+  const Candidate* pick = nullptr;
+  float pickLat = 0;
+  for(const Candidate& c : CANDIDATES) {
+    g_rng = phaseSeed;                  // every candidate sees the same poll times
+    Result r = evaluate(tr, c, pollMs * 1000);
+    float ghostRate = r.idleMin > 0 ? r.ghosts / r.idleMin : 0;
+    float lat = mean(r.latMs);
+    printf("%-26s %6u %6u %7u %9.2f  %6.1fms %6.1fms  %6.1fpx %6.1fpx  %5.2f\n", c.name, r.detected, r.missed,
+           r.repeats, ghostRate, lat, pct(r.latMs, 0.9f), mean(r.errPx), pct(r.errPx, 0.9f),
+           r.polls ? (float)r.convs / r.polls : 0.0f);
+    bool clean = r.ghosts == 0 && r.missed == 0 && r.repeats == 0;
+    if(clean && !c.legacy && (!pick || lat < pickLat)) { pick = &c; pickLat = lat; }
+  }
+  if(pick) printf("\npick: %s (lowest latency without ghosts, misses or repeats)\n", pick->name);
+  else     printf("\npick: none is clean on this trace\n");
+  return 0;
+}
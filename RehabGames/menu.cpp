@@ -1,5 +1,10 @@
 // Menu.cpp
 #include "Shared.h"
+#include "Render.h"
+#include "ScreenCache.h"
+#include "DrawList.h"
+#include "Leds.h"
+#include "Rng.h"
 
 // ---------- Layout ----------
 static const int BTN_X = 30;
@@ -25,6 +30,7 @@ static void fillGradV(int x, int y, int w, int h, uint16_t top, uint16_t bot, in
     uint8_t t = (uint32_t)i * 255 / (h - 1);
     uint16_t c = blend565(top, bot, t);
     tft.fillRect(x, y+i, w, step, c);
+    SpiBus_yield(SPI_DEV_TFT);
   }
 }
 
@@ -37,36 +43,38 @@ static void drawBackground() {
 
   // tiny stars
   for(int i=0;i<22;i++){
-    tft.drawPixel(random(0, SCREEN_W), random(0, SCREEN_H), TFT_WHITE);
+    tft.drawPixel(Rng_decor(0, SCREEN_W), Rng_decor(0, SCREEN_H), TFT_WHITE);
   }
 }
 
-static void drawButton(int x,int y,int w,int h,uint16_t bg,const char* label){
-  tft.fillRoundRect(x+3,y+3,w,h,14,TFT_BLACK);
-  tft.fillRoundRect(x,y,w,h,14,bg);
-  tft.drawRoundRect(x,y,w,h,14,TFT_WHITE);
+static void drawButton(DrawList& dl,int x,int y,int w,int h,uint16_t bg,const char* label){
+  dl.fillRoundRect(x+3,y+3,w,h,14,TFT_BLACK);
+  dl.fillRoundRect(x,y,w,h,14,bg);
+  dl.drawRoundRect(x,y,w,h,14,TFT_WHITE);
 
-  tft.setTextDatum(MC_DATUM);
-  tft.setTextFont(4);
+  dl.setTextDatum(MC_DATUM);
+  dl.setTextFont(4);
 
   // small shadow
-  tft.setTextColor(TFT_BLACK, bg);
-  tft.drawString(label, x+w/2+1, y+h/2+1);
+  dl.setTextColor(TFT_BLACK, bg);
+  dl.drawString(label, x+w/2+1, y+h/2+1);
 
-  tft.setTextColor(TFT_WHITE, bg);
-  tft.drawString(label, x+w/2, y+h/2);
+  dl.setTextColor(TFT_WHITE, bg);
+  dl.drawString(label, x+w/2, y+h/2);
 
-  tft.setTextDatum(TL_DATUM);
+  dl.setTextDatum(TL_DATUM);
+}
+
+static void drawButton(int x,int y,int w,int h,uint16_t bg,const char* label){
+  DrawList dl;
+  drawButton(dl,x,y,w,h,bg,label);
+  DrawList_run(dl);
 }
 
 // goGame() is implemented in your main .ino
 extern void goGame(AppScreen s);
 
-void Menu_draw() {
-  strip.clear();
-  strip.show();
-
-  randomSeed(micros());
+static void paintMenu() {
   drawBackground();
 
   // Title
@@ -88,6 +96,13 @@ void Menu_draw() {
   drawButton(BTN_X, BTN3_Y, BTN_W, BTN_H, 0xF800, "COLOR MATCH");
 }
 
+void Menu_draw() {
+  Leds_clear();
+  Leds_show();
+
+  ScreenCache_draw(SCREEN_MENU_GAMES, paintMenu);
+}
+
 void Menu_update() {
   int x, y;
   if(!Touch_pressed(x,y)) return;